@@ -0,0 +1,233 @@
+//============================================================================
+// Name        : PerfCounters.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Gemeinsame Hardware-Leistungszaehler (perf_event_open) der
+//				 Beispielprogramme.
+//============================================================================
+
+#ifndef PERFCOUNTERS_H_
+#define PERFCOUNTERS_H_
+
+#include <errno.h>
+#include <iostream>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Hardware-Leistungszaehler fuer einen Messbereich (Linux, perf_event_open,
+ * ohne libpfm/PAPI): start() oeffnet je Ereignis einen Zaehler fuer jeden
+ * bereits laufenden Thread des Prozesses (z. B. tbb-Worker), inherit erfasst
+ * zusaetzlich Threads, die erst im Messbereich entstehen (z. B. OpenMP).
+ * Gezaehlt wird nur im User-Mode, daher genuegt perf_event_paranoid <= 2.
+ * Teilen sich mehr Ereignisse als vorhandene Zaehler die PMU, werden die
+ * Werte ueber time_enabled / time_running hochgerechnet. Die Bandbreite ist
+ * eine Abschaetzung aus den LLC-Fehlzugriffen (je eine Cache-Zeile, ohne
+ * Write-Backs), also eine untere Schranke des DRAM-Verkehrs. Ist ein
+ * Ereignis nicht verfuegbar (virtuelle Maschine, Container, kein Linux),
+ * wird es als n/a ausgegeben, ohne die Messung zu beeinflussen.
+ */
+
+#define PERF_CYCLES 0					// Takte (User-Mode)
+#define PERF_INSTRUCTIONS 1				// Ausgefuehrte Instruktionen
+#define PERF_L1D_MISSES 2				// L1-Daten-Cache: Lese-Fehlzugriffe
+#define PERF_LLC_REFERENCES 3			// Zugriffe auf den Last-Level-Cache
+#define PERF_LLC_MISSES 4				// Fehlzugriffe im Last-Level-Cache
+#define PERF_DTLB_MISSES 5				// Daten-TLB: Lese-Fehlzugriffe
+#define PERF_EVENTS 6
+
+#define PERF_CACHE_LINE 64				// Bytes je LLC-Fehlzugriff (Bandbreitenabschaetzung)
+
+/**
+*  @brief  Misst Hardware-Ereignisse aller Threads zwischen start() und stop().
+*/
+class PerfCounters {
+	std::vector<int> fds[PERF_EVENTS];
+	double values[PERF_EVENTS];
+	bool counted[PERF_EVENTS];
+	int error;							// errno des ersten fehlgeschlagenen perf_event_open
+
+	PerfCounters(const PerfCounters&);
+	PerfCounters& operator=(const PerfCounters&);
+
+#ifdef __linux__
+	/**
+	*  @brief  Oeffnet einen (deaktivierten) Zaehler eines Ereignisses fuer einen Thread.
+	*/
+	static int openEvent(const int event, const pid_t tid) {
+		static const uint32_t types[PERF_EVENTS] = {
+			PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+			PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE
+		};
+		static const uint64_t configs[PERF_EVENTS] = {
+			PERF_COUNT_HW_CPU_CYCLES,
+			PERF_COUNT_HW_INSTRUCTIONS,
+			PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+			PERF_COUNT_HW_CACHE_REFERENCES,
+			PERF_COUNT_HW_CACHE_MISSES,
+			PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+		};
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = types[event];
+		attr.config = configs[event];
+		attr.disabled = 1;
+		attr.inherit = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		return (int) syscall(__NR_perf_event_open, &attr, tid, -1, -1, 0);
+	}
+#endif
+
+	void close() {
+		for (int e = 0; e < PERF_EVENTS; ++e) {
+#ifdef __linux__
+			for (size_t i = 0; i < fds[e].size(); ++i) {
+				::close(fds[e][i]);
+			}
+#endif
+			fds[e].clear();
+		}
+	}
+
+public:
+	PerfCounters() : error(0) {
+		for (int e = 0; e < PERF_EVENTS; ++e) {
+			values[e] = 0;
+			counted[e] = false;
+		}
+	}
+
+	~PerfCounters() {
+		close();
+	}
+
+	/**
+	*  @brief  Beginnt einen Messbereich (Zaehler oeffnen, zuruecksetzen, starten).
+	*/
+	void start() {
+		close();
+		error = 0;
+#ifdef __linux__
+		DIR* dir = opendir("/proc/self/task");
+		if (dir == NULL) {
+			error = errno;
+			return;
+		}
+		for (struct dirent* entry = readdir(dir); entry != NULL; entry = readdir(dir)) {
+			if (entry->d_name[0] == '.') {
+				continue;
+			}
+			const pid_t tid = (pid_t) atoi(entry->d_name);
+			for (int e = 0; e < PERF_EVENTS; ++e) {
+				const int fd = openEvent(e, tid);
+				if (fd >= 0) {
+					fds[e].push_back(fd);
+				} else if (error == 0) {
+					error = errno;
+				}
+			}
+		}
+		closedir(dir);
+		for (int e = 0; e < PERF_EVENTS; ++e) {
+			for (size_t i = 0; i < fds[e].size(); ++i) {
+				ioctl(fds[e][i], PERF_EVENT_IOC_RESET, 0);
+				ioctl(fds[e][i], PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+#else
+		error = ENOSYS;
+#endif
+	}
+
+	/**
+	*  @brief  Beendet den Messbereich, summiert alle Threads und schliesst die Zaehler.
+	*/
+	void stop() {
+		for (int e = 0; e < PERF_EVENTS; ++e) {
+			values[e] = 0;
+			counted[e] = false;
+#ifdef __linux__
+			for (size_t i = 0; i < fds[e].size(); ++i) {
+				ioctl(fds[e][i], PERF_EVENT_IOC_DISABLE, 0);
+			}
+			for (size_t i = 0; i < fds[e].size(); ++i) {
+				uint64_t data[3];		// Wert, time_enabled, time_running
+				if (read(fds[e][i], data, sizeof(data)) != (ssize_t) sizeof(data) || (data[2] == 0 && data[1] != 0)) {
+					continue;
+				}
+				values[e] += data[2] != 0 ? (double) data[0] * data[1] / data[2] : (double) data[0];
+				counted[e] = true;
+			}
+#endif
+		}
+		close();
+	}
+
+	/**
+	*  @brief  Wurde das Ereignis im letzten Messbereich gezaehlt?
+	*/
+	bool available(const int event) const {
+		return counted[event];
+	}
+
+	/**
+	*  @brief  Summe eines Ereignisses ueber alle Threads (ggf. hochgerechnet).
+	*/
+	double value(const int event) const {
+		return values[event];
+	}
+
+	/**
+	*  @brief  Gibt IPC, Cache- und TLB-Fehlzugriffe sowie die abgeschaetzte
+	*  Speicherbandbreite des letzten Messbereichs als eine Zeile aus.
+	*  @param      out  Ausgabestrom.
+	*  @param  seconds  Gemessene Zeit des Bereichs (fuer die Bandbreite).
+	*/
+	void print(std::ostream& out, const double seconds) const {
+		out << "Counters:\t";
+		bool any = false;
+		for (int e = 0; e < PERF_EVENTS; ++e) {
+			any = any || counted[e];
+		}
+		if (!any) {
+			out << "not available (perf_event_open: "
+				<< (error == ENOENT || error == 0 ? "no hardware events on this CPU or hypervisor" : strerror(error)) << ")\n";
+			return;
+		}
+		const std::streamsize precision = out.precision(3);
+		out << "IPC ";
+		counted[PERF_CYCLES] && counted[PERF_INSTRUCTIONS] && values[PERF_CYCLES] > 0
+			? out << values[PERF_INSTRUCTIONS] / values[PERF_CYCLES] : out << "n/a";
+		out << ", L1D miss ";
+		counted[PERF_L1D_MISSES] ? out << values[PERF_L1D_MISSES] : out << "n/a";
+		out << ", LLC miss ";
+		counted[PERF_LLC_MISSES] ? out << values[PERF_LLC_MISSES] : out << "n/a";
+		if (counted[PERF_LLC_MISSES] && counted[PERF_LLC_REFERENCES] && values[PERF_LLC_REFERENCES] > 0) {
+			out << " (" << 100.0 * values[PERF_LLC_MISSES] / values[PERF_LLC_REFERENCES] << "%)";
+		}
+		out << ", dTLB miss ";
+		counted[PERF_DTLB_MISSES] ? out << values[PERF_DTLB_MISSES] : out << "n/a";
+		out << ", DRAM >= ";
+		counted[PERF_LLC_MISSES] && seconds > 0
+			? out << values[PERF_LLC_MISSES] * PERF_CACHE_LINE / seconds * 1e-9 << " GB/s" : out << "n/a";
+		out << "\n";
+		out.precision(precision);
+	}
+};
+
+#endif
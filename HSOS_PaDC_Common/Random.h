@@ -0,0 +1,138 @@
+//============================================================================
+// Name        : Random.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Gemeinsamer Zufallszahlengenerator (Philox4x32-10) der
+//				 Beispielprogramme. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef RANDOM_H_
+#define RANDOM_H_
+
+#include <stdint.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+/*
+ * Zaehlerbasierter Generator nach Salmon et al., "Parallel Random Numbers:
+ * As Easy as 1, 2, 3" (SC11): Der i-te Wert eines Stroms ist eine reine
+ * Funktion von (seed, stream, i), es gibt keinen fortgeschriebenen Zustand.
+ * Jeder Thread kann daher einen beliebigen Teilbereich erzeugen, und das
+ * Ergebnis ist fuer einen Seed unabhaengig von Thread-Anzahl und Aufteilung
+ * bitgleich. Ein Aufruf von philox4x32 liefert vier 32-Bit-Werte.
+ */
+
+#define PHILOX_M0 0xD2511F53U			// Multiplikatoren der Runden
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U			// Schluesselinkremente (Weyl-Folge)
+#define PHILOX_W1 0xBB67AE85U
+#define PHILOX_ROUNDS 10
+
+#define RANDOM_FILL_GRAIN 4096			// Bloecke (je 4 Werte) pro Teilbereich der parallelen Erzeugung
+
+/**
+*  @brief  Berechnet einen Philox4x32-10-Block.
+*  @param  counter  Zaehler (128 Bit).
+*  @param      key  Schluessel (64 Bit).
+*  @param      out  Vier 32-Bit-Zufallswerte.
+*/
+inline void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+	uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+	uint32_t k0 = key[0], k1 = key[1];
+	for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+		const uint64_t p0 = (uint64_t) PHILOX_M0 * c0;
+		const uint64_t p1 = (uint64_t) PHILOX_M1 * c2;
+		const uint32_t n0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+		const uint32_t n2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+		c1 = (uint32_t) p1;
+		c3 = (uint32_t) p0;
+		c0 = n0;
+		c2 = n2;
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+	out[0] = c0;
+	out[1] = c1;
+	out[2] = c2;
+	out[3] = c3;
+}
+
+/**
+*  @brief  Berechnet den block-ten Block (Werte 4 * block .. 4 * block + 3)
+*  eines Stroms.
+*  @param    seed  Startwert (Schluessel).
+*  @param  stream  Nummer des Stroms (z. B. je Matrix), unabhaengige Folgen.
+*  @param   block  Nummer des Blocks.
+*  @param     out  Vier 32-Bit-Zufallswerte.
+*/
+inline void randomBlock(const uint64_t seed, const uint32_t stream, const uint64_t block, uint32_t out[4]) {
+	const uint32_t counter[4] = { (uint32_t) block, (uint32_t) (block >> 32), stream, 0 };
+	const uint32_t key[2] = { (uint32_t) seed, (uint32_t) (seed >> 32) };
+	philox4x32(counter, key, out);
+}
+
+/**
+*  @brief  Liefert den index-ten 32-Bit-Zufallswert eines Stroms.
+*  @param    seed  Startwert (Schluessel).
+*  @param  stream  Nummer des Stroms.
+*  @param   index  Position innerhalb des Stroms.
+*/
+inline uint32_t randomBits(const uint64_t seed, const uint32_t stream, const uint64_t index) {
+	uint32_t out[4];
+	randomBlock(seed, stream, index >> 2, out);
+	return out[index & 3];
+}
+
+/**
+*  @brief  Funktionsobjekt zur parallelen Erzeugung: Jeder Teilbereich
+*  berechnet seine Philox-Bloecke selbst und uebergibt Index und Zufallsbits
+*  an generate, das den Wert umrechnet und ablegt.
+*/
+template <typename Generate>
+struct RandomFillPBody {
+	const Generate& generate;
+	const uint64_t count;
+	const uint64_t seed;
+	const uint32_t stream;
+
+	RandomFillPBody(const Generate& _generate, const uint64_t _count, const uint64_t _seed, const uint32_t _stream)
+		: generate(_generate), count(_count), seed(_seed), stream(_stream) { }
+
+	void operator()(const tbb::blocked_range<uint64_t>& range) const {
+		uint32_t out[4];
+		for (uint64_t block = range.begin(); block != range.end(); ++block) {
+			randomBlock(seed, stream, block, out);
+			const uint64_t first = block << 2;
+			const uint64_t last = first + 4 < count ? first + 4 : count;
+			for (uint64_t index = first; index < last; ++index) {
+				generate(index, out[index - first]);
+			}
+		}
+	}
+};
+
+/**
+*  @brief  Erzeugt die Werte 0 .. count-1 eines Stroms parallel. Das Ergebnis
+*  ist dasselbe wie bei serieller Erzeugung per randomBits.
+*  @param     count  Anzahl der Werte.
+*  @param      seed  Startwert.
+*  @param    stream  Nummer des Stroms.
+*  @param  generate  Funktionsobjekt generate(index, bits).
+*  @param  parallel  false: seriell im aufrufenden Thread (optional).
+*/
+template <typename Generate>
+inline void randomFill(const uint64_t count, const uint64_t seed, const uint32_t stream, const Generate& generate, const bool parallel = true) {
+	const uint64_t blocks = (count + 3) >> 2;
+	const RandomFillPBody<Generate> body(generate, count, seed, stream);
+	if (parallel) {
+		tbb::parallel_for(tbb::blocked_range<uint64_t>(0, blocks, RANDOM_FILL_GRAIN), body);
+	}
+	else {
+		body(tbb::blocked_range<uint64_t>(0, blocks));
+	}
+}
+
+#endif
@@ -10,6 +10,8 @@
 #include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
 #include <tbb/tick_count.h>
+#include "../HSOS_PaDC_Common/PerfCounters.h"
+#include "../HSOS_PaDC_Common/Random.h"
 
 //#pragma warning(disable: 588)
 
@@ -47,17 +49,19 @@ void copy_values(ll* source, ll* destination) {
 }
 
 /**
- * Generiert Zufallszahlen und initialisiert diese in einem Array.
+ * Generiert Zufallszahlen und initialisiert diese in einem Array. Der
+ * zaehlerbasierte Generator (Philox) fuellt das Array parallel, der i-te Wert
+ * haengt nur vom Startwert und von i ab (unabhaengig von der Thread-Anzahl).
  */
 void randomize(ll* values) {
-    srand(time(NULL));
-    for (ull i = 0; i < N; ++i) {
-        values[i] = (rand() % RAND - (RAND >> 1));
+    const uint64_t seed = time(NULL);
+    randomFill(N, seed, 0, [=](const uint64_t i, const uint32_t bits) {
+        values[i] = ((ll) (bits % RAND) - (RAND >> 1));
+    });
 #if DEBUG
+    for (ull i = 0; i < N; ++i) {
         std::cout << values[i] << "\t";
-#endif
     }
-#if DEBUG
     std::cout << std::endl << std::endl;
 #endif
 }
@@ -81,6 +85,7 @@ public:
  */
 int main(int argc, char** argv) {
 	tick_count start, end;
+	PerfCounters counters;
     ll *randoms = new ll[N];
     ll *backup_randoms = new ll[N];
     randomize(backup_randoms);
@@ -88,24 +93,33 @@ int main(int argc, char** argv) {
 
     // Sequential loop
     copy_values(backup_randoms, randoms);
+    counters.start();
     start = tick_count::now();
     for (ull i = 0; i < N; ++i) {
     	make_binary(randoms[i]);
     }
     end = tick_count::now();
-    std::cout << std::endl << "Sequential:\t" << (end - start).seconds() << " s" << std::endl << std::endl;
+    counters.stop();
+    std::cout << std::endl << "Sequential:\t" << (end - start).seconds() << " s" << std::endl;
+    counters.print(std::cout, (end - start).seconds());
+    std::cout << std::endl;
 
 
     // Parallel loop
     copy_values(backup_randoms, randoms);
+    counters.start();
     start = tick_count::now();
     parallel_for(blocked_range<ll>(0, N), ParallelBinaryMaker(randoms));
     end = tick_count::now();
-    std::cout << std::endl << "Parallel:\t" << (end - start).seconds() << " s" << std::endl << std::endl;
+    counters.stop();
+    std::cout << std::endl << "Parallel:\t" << (end - start).seconds() << " s" << std::endl;
+    counters.print(std::cout, (end - start).seconds());
+    std::cout << std::endl;
 
 
     // Parallel loop (with Lambda-Expression)
     copy_values(backup_randoms, randoms);
+    counters.start();
     start = tick_count::now();
     parallel_for(
 		blocked_range<ll>(0, N), [=](const blocked_range<ll> range) {
@@ -115,7 +129,10 @@ int main(int argc, char** argv) {
 		}
     );
     end = tick_count::now();
-    std::cout << std::endl << "Parallel (L):\t" << (end - start).seconds() << " s" << std::endl << std::endl;
+    counters.stop();
+    std::cout << std::endl << "Parallel (L):\t" << (end - start).seconds() << " s" << std::endl;
+    counters.print(std::cout, (end - start).seconds());
+    std::cout << std::endl;
 
 
     return 0;
@@ -12,6 +12,7 @@
 #include <tbb/parallel_for.h>
 #include <tbb/task_scheduler_init.h>
 #include <tbb/tick_count.h>
+#include "../HSOS_PaDC_Common/PerfCounters.h"
 
 #define DEBUG 0
 #define USE_SEQ 0
@@ -78,26 +79,35 @@ int main(int argc, char** argv) {
 	//task_scheduler_init init(2);
 	tick_count start, end;
 	tick_count::interval_t dif1, dif2;
+	PerfCounters counters;
 	concurrent_vector<bool> primes(N, true);
 
 	// Primes (Sequential)
 #if USE_SEQ
+	counters.start();
 	for (ull i = 2; i * i <= N; i++) {
 		eliminate_primes(primes, i);
 	}
 	end= tick_count::now();
+	counters.stop();
 	dif1 = end - start;
 	print_vector(primes, 0);
-	std::cout << std::endl << "Sequential:\t" << dif1.seconds() << " s, primeCount: \t" << primeCount << std::endl << std::endl;
+	std::cout << std::endl << "Sequential:\t" << dif1.seconds() << " s, primeCount: \t" << primeCount << std::endl;
+	counters.print(std::cout, dif1.seconds());
+	std::cout << std::endl;
 #endif
 
 	// Primes (Parallel)
+	counters.start();
 	start = tick_count::now();
 	parallel_for(blocked_range<ull>(2, N), ParallelEratosthenes(primes));
 	end = tick_count::now();
+	counters.stop();
 	dif2 = end - start;
 	print_vector(primes, 0);
-	std::cout << std::endl << "Parallel:\t" << dif2.seconds() << " s" << std::endl << std::endl;
+	std::cout << std::endl << "Parallel:\t" << dif2.seconds() << " s" << std::endl;
+	counters.print(std::cout, dif2.seconds());
+	std::cout << std::endl;
 
     return 0;
 }
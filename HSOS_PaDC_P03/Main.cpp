@@ -9,6 +9,7 @@
 
 #include "Definitions.h"
 #include "Langford.h"
+#include "../HSOS_PaDC_Common/PerfCounters.h"
 #include <iostream>
 #include <tbb/atomic.h>
 #include <tbb/task_scheduler_init.h>
@@ -25,6 +26,7 @@ int main () {
 	size_t ln = 12;
 	size_t size = ln << 1;
 	tick_count t0, t1;
+	PerfCounters counters;
 	size_t count = 0;
 	if ((ln - (ln >> 1)) % 2) {
 		std::cout << "Fuer " << ln << " gibt es keine Loesung!";
@@ -38,16 +40,22 @@ int main () {
 #endif
 
 	count = 0;
+	counters.start();
 	t0 = tick_count::now();
 	LangfordRecursiveBit(0, ln, size, count);
 	t1 = tick_count::now();
+	counters.stop();
 	std::cout << "Seq. Bit: Time was " << (t1 - t0).seconds() << "s" << " - Non-Tasks\n";
+	counters.print(std::cout, (t1 - t0).seconds());
 	std::cout << "Count: " << count << "\n\n";
 
+	counters.start();
 	t0 = tick_count::now();
 	task::spawn_root_and_wait(*new (task::allocate_root()) Langford(0, ln, size, countAtomic));
 	t1 = tick_count::now();
+	counters.stop();
 	std::cout << "Par: Time was " << (t1 - t0).seconds() << "s" << " - Tasks\n";
+	counters.print(std::cout, (t1 - t0).seconds());
 	std::cout << "Count: " << countAtomic << "\n\n";
 
 	std::cout << "\n\nEND\n" ;
@@ -10,6 +10,7 @@
 #include <math.h>
 #include <omp.h>				// OpenMP
 #include <tbb/tick_count.h>
+#include "../HSOS_PaDC_Common/PerfCounters.h"
 
 typedef unsigned long Number;
 
@@ -64,11 +65,16 @@ Number parallel_eratosthenes(Number lastNumber) {
  */
 int main(int argc, char** argv) {
 	tbb::tick_count t0, t1;
+	PerfCounters counters;
 
+	counters.start();
 	t0 = tbb::tick_count::now();
 	Number primes = parallel_eratosthenes(N);
 	t1 = tbb::tick_count::now();
-	std::cout << "\nParallel:\t" << (t1 - t0).seconds() << "s, primeCount: \t" << primes << "\n\n";
+	counters.stop();
+	std::cout << "\nParallel:\t" << (t1 - t0).seconds() << "s, primeCount: \t" << primes << "\n";
+	counters.print(std::cout, (t1 - t0).seconds());
+	std::cout << "\n";
 
 	return 0;
 }
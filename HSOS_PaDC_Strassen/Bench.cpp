@@ -0,0 +1,267 @@
+//============================================================================
+// Name        : Bench.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Bench.h"
+#include "Gemm.h"
+#include "Helper.h"
+#include "Kernel.h"
+#include "Strassen.h"
+#include "Verify.h"
+#include "Workspace.h"
+#include <tbb/task_arena.h>
+#include <tbb/tick_count.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>						// gethostname
+#include <vector>
+
+#ifndef BUILD_ID
+#define BUILD_ID "unknown"				// Revision des Builds (makefile: git describe)
+#endif
+
+namespace M_VAL_NAMESPACE {
+
+static const char* const BENCH_ALGORITHM_NAMES[BENCH_ALGORITHMS] = { "GEMM Seq", "GEMM Par", "Strassen Seq", "Strassen Par" };
+
+/**
+*  @brief  Ergebnis eines Falls (Algorithmus, Dimension, Threads, Cut-Off).
+*/
+struct BenchResult {
+	int algorithm;
+	M_SIZE_TYPE n;
+	M_SIZE_TYPE threads;
+	M_SIZE_TYPE cutOff;					// 0: ohne Bedeutung (GEMM)
+	M_SIZE_TYPE cutOffTask;
+	std::vector<double> seconds;		// Aufsteigend sortierte Laufzeiten
+	int verified;						// -1: nicht geprueft, 0: fehlerhaft, 1: OK
+};
+
+/**
+*  @brief  Perzentil einer aufsteigend sortierten Messreihe (lineare Interpolation).
+*  @param  sorted  Messreihe.
+*  @param       p  Perzentil zwischen 0 und 1.
+*/
+static double benchPercentile(const std::vector<double>& sorted, const double p) {
+	const double position = p * (sorted.size() - 1);
+	const size_t lower = (size_t) position;
+	const size_t upper = lower + 1 < sorted.size() ? lower + 1 : lower;
+	return sorted[lower] + (position - lower) * (sorted[upper] - sorted[lower]);
+}
+
+/**
+*  @brief  Funktionsobjekt fuer task_arena::execute: misst einen Fall nach
+*  BENCH_WARMUPS Aufwaermlaeufen BENCH_REPEATS mal.
+*/
+struct BenchMeasureBody {
+	const int algorithm;
+	const MatrixView C;
+	const ConstMatrixView A;
+	const ConstMatrixView B;
+	const M_SIZE_TYPE n;
+	std::vector<double>& seconds;
+
+	BenchMeasureBody(const int _algorithm, const MatrixView& _C, const ConstMatrixView& _A, const ConstMatrixView& _B, const M_SIZE_TYPE& _n,
+			std::vector<double>& _seconds)
+		: algorithm(_algorithm), C(_C), A(_A), B(_B), n(_n), seconds(_seconds) { }
+
+	void multiply() const {
+		switch (algorithm) {
+		case BENCH_NAIV_SEQ:
+			gemmSeq(C, A, B, n, n, n);
+			break;
+		case BENCH_NAIV_PAR:
+			gemmPar(C, A, B, n, n, n);
+			break;
+		case BENCH_STRASSEN_SEQ:
+			strassenMultiplySeq(C, A, B, n);
+			break;
+		default:
+			strassenMultiplyPar(C, A, B, n);
+			break;
+		}
+	}
+
+	void operator()() const {
+		for (int r = 0; r < BENCH_WARMUPS; ++r) {
+			multiply();
+		}
+		seconds.clear();
+		for (int r = 0; r < BENCH_REPEATS; ++r) {
+			const tbb::tick_count t0 = tbb::tick_count::now();
+			multiply();
+			seconds.push_back((tbb::tick_count::now() - t0).seconds());
+		}
+		std::sort(seconds.begin(), seconds.end());
+	}
+};
+
+/**
+*  @brief  Misst einen Fall (parallele Algorithmen in einer task_arena mit
+*  threads Threads) und gibt eine Fortschrittszeile aus.
+*/
+static BenchResult benchCase(const int algorithm, const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B,
+		const M_SIZE_TYPE& n, const M_SIZE_TYPE& threads) {
+	BenchResult result;
+	result.algorithm = algorithm;
+	result.n = n;
+	result.threads = threads;
+	result.cutOff = algorithm >= BENCH_STRASSEN_SEQ ? CUT_OFF : 0;
+	result.cutOffTask = algorithm == BENCH_STRASSEN_PAR ? CUT_OFF_TASK : 0;
+	result.verified = -1;
+
+	const M_SIZE_TYPE gemmElements = gemmPackElements(n, n, n);
+	const M_SIZE_TYPE strassenElements = strassenWorkspaceElements(n);
+	initWorkspaces(gemmElements > strassenElements ? gemmElements : strassenElements);
+
+	const BenchMeasureBody body(algorithm, C, A, B, n, result.seconds);
+	if (algorithm == BENCH_NAIV_PAR || algorithm == BENCH_STRASSEN_PAR) {
+		const unsigned threadsBefore = NO_THREADS;
+		NO_THREADS = (unsigned) threads;	// Breite der CAPS-Zerlegung
+		tbb::task_arena arena((int) threads);
+		arena.execute(body);
+		NO_THREADS = threadsBefore;
+	}
+	else {
+		body();
+	}
+	if (VERIFY_VECTORS != 0) {
+		result.verified = verifyProduct(C, A, B, n, n, n, VERIFY_VECTORS).ok ? 1 : 0;
+	}
+
+	const double median = benchPercentile(result.seconds, 0.5);
+	std::cout << "Bench:\t\t" << BENCH_ALGORITHM_NAMES[algorithm] << ", n " << n << ", threads " << threads;
+	if (result.cutOff != 0) {
+		std::cout << ", cut-off " << result.cutOff;
+	}
+	std::cout << ": median " << median << "s (p10 " << benchPercentile(result.seconds, 0.1) << "s, p90 "
+			  << benchPercentile(result.seconds, 0.9) << "s), " << 2.0 * n * n * n / median * 1e-9 << " GFLOP/s"
+			  << (result.verified == 0 ? ", Freivalds FAILED" : "") << "\n";
+	return result;
+}
+
+/**
+*  @brief  Schreibt die Ergebnisse als CSV (eine Zeile je Fall).
+*/
+static void benchWriteCsv(std::ostream& out, const std::vector<BenchResult>& results, const std::string& meta) {
+	out << "host,type,kernel,variant,build,algorithm,n,threads,cut_off,cut_off_task,warmups,repeats,"
+		<< "min,p10,median,p90,max,gflops_median,gflops_best,verified\n";
+	for (std::vector<BenchResult>::const_iterator it = results.begin(); it != results.end(); ++it) {
+		const double flops = 2.0 * it->n * it->n * it->n;
+		out << meta << "," << BENCH_ALGORITHM_NAMES[it->algorithm] << "," << it->n << "," << it->threads << ","
+			<< it->cutOff << "," << it->cutOffTask << "," << BENCH_WARMUPS << "," << BENCH_REPEATS << ","
+			<< it->seconds.front() << "," << benchPercentile(it->seconds, 0.1) << "," << benchPercentile(it->seconds, 0.5) << ","
+			<< benchPercentile(it->seconds, 0.9) << "," << it->seconds.back() << ","
+			<< flops / benchPercentile(it->seconds, 0.5) * 1e-9 << "," << flops / it->seconds.front() * 1e-9 << ","
+			<< it->verified << "\n";
+	}
+}
+
+/**
+*  @brief  Schreibt die Ergebnisse als JSON (Metadaten und ein Objekt je Fall
+*  inkl. aller Einzelzeiten).
+*/
+static void benchWriteJson(std::ostream& out, const std::vector<BenchResult>& results, const char* host, const char* build) {
+	out << "{\"host\": \"" << host << "\", \"type\": \"" << M_VAL_TYPE_NAME << "\", \"kernel\": \"" << activeKernel().name
+		<< "\", \"variant\": \"" << strassenVariantName(STRASSEN_VARIANT) << "\", \"build\": \"" << build
+		<< "\", \"seed\": " << RANDOM_SEED << ", \"warmups\": " << BENCH_WARMUPS << ", \"repeats\": " << BENCH_REPEATS
+		<< ", \"results\": [";
+	for (std::vector<BenchResult>::const_iterator it = results.begin(); it != results.end(); ++it) {
+		const double flops = 2.0 * it->n * it->n * it->n;
+		out << (it == results.begin() ? "\n" : ",\n") << "  {\"algorithm\": \"" << BENCH_ALGORITHM_NAMES[it->algorithm]
+			<< "\", \"n\": " << it->n << ", \"threads\": " << it->threads << ", \"cutOff\": " << it->cutOff
+			<< ", \"cutOffTask\": " << it->cutOffTask << ", \"min\": " << it->seconds.front()
+			<< ", \"p10\": " << benchPercentile(it->seconds, 0.1) << ", \"median\": " << benchPercentile(it->seconds, 0.5)
+			<< ", \"p90\": " << benchPercentile(it->seconds, 0.9) << ", \"max\": " << it->seconds.back()
+			<< ", \"gflopsMedian\": " << flops / benchPercentile(it->seconds, 0.5) * 1e-9
+			<< ", \"gflopsBest\": " << flops / it->seconds.front() * 1e-9 << ", \"verified\": " << it->verified
+			<< ", \"seconds\": [";
+		for (size_t r = 0; r < it->seconds.size(); ++r) {
+			out << (r > 0 ? ", " : "") << it->seconds[r];
+		}
+		out << "]}";
+	}
+	out << "\n]}\n";
+}
+
+/**
+*  @brief  Fuehrt den Benchmark-Modus aus (siehe Bench.h).
+*  @return 0 bei Erfolg.
+*/
+int runBenchmark() {
+	std::vector<M_SIZE_TYPE> threadCounts(BENCH_THREADS);
+	if (threadCounts.empty()) {
+		threadCounts.push_back(NO_THREADS);
+	}
+	std::vector<M_SIZE_TYPE> cutOffs(BENCH_CUT_OFFS);
+	if (cutOffs.empty()) {
+		cutOffs.push_back(CUT_OFF);
+	}
+	const M_SIZE_TYPE cutOffBefore = CUT_OFF;
+
+	char host[256] = "unknown";
+	gethostname(host, sizeof(host) - 1);
+	host[sizeof(host) - 1] = '\0';
+	const char* build = BUILD_ID;
+	std::ostringstream meta;
+	meta << host << "," << M_VAL_TYPE_NAME << "," << activeKernel().name << "," << strassenVariantName(STRASSEN_VARIANT) << "," << build;
+
+	std::cout << "Benchmark:\t" << BENCH_SIZES.size() << " size(s), " << threadCounts.size() << " thread count(s), "
+			  << cutOffs.size() << " cut-off(s), " << BENCH_WARMUPS << " warm-up(s), " << BENCH_REPEATS << " repeat(s)\n";
+	std::cout << "Algorithm:\t" << strassenVariantName(STRASSEN_VARIANT) << "\n";
+
+	std::vector<BenchResult> results;
+	for (std::vector<M_SIZE_TYPE>::const_iterator n = BENCH_SIZES.begin(); n != BENCH_SIZES.end(); ++n) {
+		InnerArray a(*n * *n), b(*n * *n), c(*n * *n);
+		const MatrixView A(&a[0], *n, *n);
+		const MatrixView B(&b[0], *n, *n);
+		const MatrixView C(&c[0], *n, *n);
+		initializeRandpriomMatrix(A, *n, *n, RANDOM_STREAM_A);
+		initializeRandpriomMatrix(B, *n, *n, RANDOM_STREAM_B);
+
+		if (RUN_NAIV_SEQ != 0) {
+			results.push_back(benchCase(BENCH_NAIV_SEQ, C, A, B, *n, 1));
+		}
+		for (std::vector<M_SIZE_TYPE>::const_iterator t = threadCounts.begin(); RUN_NAIV_PAR != 0 && t != threadCounts.end(); ++t) {
+			results.push_back(benchCase(BENCH_NAIV_PAR, C, A, B, *n, *t));
+		}
+		for (std::vector<M_SIZE_TYPE>::const_iterator cutOff = cutOffs.begin(); cutOff != cutOffs.end(); ++cutOff) {
+			CUT_OFF = *cutOff;
+			if (RUN_STRASSEN_SEQ != 0) {
+				results.push_back(benchCase(BENCH_STRASSEN_SEQ, C, A, B, *n, 1));
+			}
+			for (std::vector<M_SIZE_TYPE>::const_iterator t = threadCounts.begin(); RUN_STRASSEN_PAR != 0 && t != threadCounts.end(); ++t) {
+				results.push_back(benchCase(BENCH_STRASSEN_PAR, C, A, B, *n, *t));
+			}
+		}
+		CUT_OFF = cutOffBefore;
+	}
+
+	if (BENCH_PATH == NULL) {
+		std::cout << "\n";
+		benchWriteCsv(std::cout, results, meta.str());
+	}
+	else {
+		const std::string path(BENCH_PATH);
+		const bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+		std::ofstream file(BENCH_PATH);
+		json ? benchWriteJson(file, results, host, build) : benchWriteCsv(file, results, meta.str());
+		if (!file) {
+			std::cerr << "Could not write benchmark results to " << BENCH_PATH << "\n";
+			return 1;
+		}
+		std::cout << "Results:\twritten to " << BENCH_PATH << (json ? " (JSON)" : " (CSV)") << "\n";
+	}
+	std::cout << "\n\nEND\n" ;
+	return 0;
+}
+
+} // namespace M_VAL_NAMESPACE
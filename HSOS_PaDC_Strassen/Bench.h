@@ -0,0 +1,42 @@
+//============================================================================
+// Name        : Bench.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "Definitions.h"
+
+namespace M_VAL_NAMESPACE {
+
+#define BENCH_NAIV_SEQ 0				// Gekachelte GEMM, sequentiell
+#define BENCH_NAIV_PAR 1				// Gekachelte GEMM, parallel
+#define BENCH_STRASSEN_SEQ 2			// Strassen (-a), Non-Tasks
+#define BENCH_STRASSEN_PAR 3			// Strassen (-a), Tasks
+#define BENCH_ALGORITHMS 4
+
+/*
+ * Benchmark-Modus (-B <n1,n2,...>): Fuer jede Matrixdimension werden die per
+ * -r gewaehlten Algorithmen ueber alle Thread-Anzahlen (-P) und Cut-Offs (-K)
+ * gemessen, je Fall nach -W Aufwaermlaeufen -R mal. Parallele Faelle laufen in
+ * einer task_arena mit der jeweiligen Thread-Anzahl, GEMM Seq und Strassen Seq
+ * entsprechend nur einmal je Dimension bzw. Cut-Off. Ausgegeben werden
+ * Minimum, Perzentile (p10, Median, p90), Maximum und GFLOP/s (effektiv,
+ * 2 n^3 / Median) sowie mit -v das Ergebnis der Freivalds-Pruefung. Die
+ * Ergebnisse gehen als CSV (eine Zeile je Fall) bzw. JSON (-o *.json) in eine
+ * Datei oder als CSV auf die Konsole. Jede Zeile enthaelt Rechner, Werttyp,
+ * Mikrokernel, Variante und Revision des Builds (git describe), damit Dateien verschiedener
+ * Builds direkt verglichen werden koennen.
+ */
+
+int runBenchmark();
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
@@ -0,0 +1,361 @@
+//============================================================================
+// Name        : Blas.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Blas.h"
+#include "Gemm.h"
+#include "Kernel.h"
+#include "Matrix.h"
+#include "Strassen.h"
+#include "StrassenRect.h"
+#include "Tuner.h"
+#include "Workspace.h"
+#include <tbb/blocked_range.h>
+#include <tbb/blocked_range2d.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_scheduler_init.h>
+
+namespace M_VAL_NAMESPACE {
+
+#define BLAS_STRASSEN_MIN_FACTOR 2		// Strassen ab min(m, n, k) >= Faktor * CUT_OFF (mind. eine Ebene)
+#define BLAS_TRANSPOSE_GRAIN 64			// Kachelgroesse der parallelen Transposition
+#define BLAS_BATCH_GRAIN_FLOPS 1000000	// Mindestaufwand eines Teilbereichs im Stapel (Gleitkommaoperationen)
+
+static M_SIZE_TYPE BLAS_WORKSPACE_ELEMENTS = 0;	// Aktuelle Reservierung je Thread
+
+/**
+*  @brief  Funktionsobjekt zum parallelisierten Transponieren (T = S^T).
+*/
+struct BlasTransposePBody {
+	MatrixView T;
+	ConstMatrixView S;
+
+	BlasTransposePBody(const MatrixView& __T, const ConstMatrixView& __S) : T(__T), S(__S) { }
+
+	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
+		for (M_SIZE_TYPE i = range.rows().begin(); i != range.rows().end(); ++i) {
+			for (M_SIZE_TYPE j = range.cols().begin(); j != range.cols().end(); ++j) {
+				T[i][j] = S[j][i];
+			}
+		}
+	}
+};
+
+/**
+*  @brief  Funktionsobjekt zum parallelisierten Skalieren: C = alpha * P + beta * C.
+*  Bei alpha == 0 wird P, bei beta == 0 wird C nicht gelesen (wie in BLAS,
+*  z. B. bei NaN in C).
+*/
+struct BlasScalePBody {
+	MatrixView C;
+	ConstMatrixView P;
+	const M_VAL_TYPE alpha;
+	const M_VAL_TYPE beta;
+
+	BlasScalePBody(const MatrixView& __C, const ConstMatrixView& __P, const M_VAL_TYPE __alpha, const M_VAL_TYPE __beta) : C(__C), P(__P), alpha(__alpha), beta(__beta) { }
+
+	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
+		for (M_SIZE_TYPE i = range.rows().begin(); i != range.rows().end(); ++i) {
+			for (M_SIZE_TYPE j = range.cols().begin(); j != range.cols().end(); ++j) {
+				const M_VAL_TYPE product = alpha == 0 ? 0 : alpha * P[i][j];
+				C[i][j] = beta == 0 ? product : product + beta * C[i][j];
+			}
+		}
+	}
+};
+
+/**
+*  @brief  Legt beim ersten Aufruf Threads und Cut-Offs fest: Sofern nicht vom
+*  Aufrufer gesetzt, alle Kerne und das Tuning-Profil der Maschine. Die
+*  Globals teilen sich alle Werttypen: Aufruf nur unter BLAS_MUTEX
+*  (Definitions.h), das die Aufrufe aller Typen serialisiert.
+*/
+static void blasInit() {
+	if (BLAS_INITIALIZED) {
+		return;
+	}
+	if (NO_THREADS == 0) {
+		NO_THREADS = tbb::task_scheduler_init::default_num_threads();
+	}
+	TuneProfile profile;
+	if (!CUT_OFF_FIXED && loadTuneProfile(tuneProfilePath(), profile)) {
+		CUT_OFF = profile.cutOff;
+		CUT_OFF_TASK = profile.cutOffTask;
+	}
+	BLAS_INITIALIZED = true;
+}
+
+/**
+*  @brief  Vergroessert bei Bedarf die Workspaces aller Threads.
+*  @param  elements  Benoetigte Elemente je Thread.
+*/
+static void blasReserve(const M_SIZE_TYPE& elements) {
+	if (elements > BLAS_WORKSPACE_ELEMENTS) {
+		initWorkspaces(elements);
+		BLAS_WORKSPACE_ELEMENTS = elements;
+	}
+}
+
+/**
+*  @brief  Prueft die gemeinsamen Argumente von gemm und den Stapelvarianten.
+*  @param  ldaPos, ldbPos, ldcPos  Parameterpositionen fuer den Fehlercode.
+*  @param  tA, tB  Ergebnis: op(A) = A^T bzw. op(B) = B^T.
+*  @return 0 oder -i fuer einen ungueltigen i-ten Parameter.
+*/
+static int blasCheck(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const M_SIZE_TYPE lda, const M_SIZE_TYPE ldb, const M_SIZE_TYPE ldc, const int ldaPos, const int ldbPos, const int ldcPos, bool& tA, bool& tB) {
+	tA = transA == 'T' || transA == 't' || transA == 'C' || transA == 'c';
+	tB = transB == 'T' || transB == 't' || transB == 'C' || transB == 'c';
+	if (!tA && transA != 'N' && transA != 'n') {
+		return -1;
+	}
+	if (!tB && transB != 'N' && transB != 'n') {
+		return -2;
+	}
+	if (lda < (tA ? m : k) || lda == 0) {
+		return -ldaPos;
+	}
+	if (ldb < (tB ? k : n) || ldb == 0) {
+		return -ldbPos;
+	}
+	if (ldc < n || ldc == 0) {
+		return -ldcPos;
+	}
+	return 0;
+}
+
+/**
+*  @brief  Liefert op(X) als zeilenweise Sicht: Ohne Transposition direkt auf
+*  den Speicher des Aufrufers, sonst als transponierte Kopie in buffer.
+*  @param       X  Gespeicherte Matrix (rows x cols von op(X) bzw. transponiert).
+*  @param      ld  Zeilenabstand von X.
+*  @param   trans  op(X) = X^T.
+*  @param    rows  Zeilen von op(X).
+*  @param    cols  Spalten von op(X).
+*  @param  buffer  Puffer fuer die Kopie.
+*/
+static ConstMatrixView blasOperand(const M_VAL_TYPE* X, const M_SIZE_TYPE& ld, const bool trans, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols, InnerArray& buffer) {
+	if (!trans) {
+		return ConstMatrixView(X, ld, 0);
+	}
+	buffer.resize(rows * cols);
+	const MatrixView T(&buffer[0], cols, 0);
+	tbb::parallel_for(tbb::blocked_range2d<M_SIZE_TYPE>(0, rows, BLAS_TRANSPOSE_GRAIN, 0, cols, BLAS_TRANSPOSE_GRAIN), BlasTransposePBody(T, ConstMatrixView(X, ld, 0)));
+	return T;
+}
+
+/**
+*  @brief  Prueft, ob sich der Strassen-Algorithmus lohnt (mindestens eine
+*  Rekursionsebene oberhalb des Cut-Offs in allen Dimensionen).
+*/
+static bool blasUseStrassen(const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	const M_SIZE_TYPE smallest = m < n ? (m < k ? m : k) : (n < k ? n : k);
+	return smallest >= BLAS_STRASSEN_MIN_FACTOR * CUT_OFF;
+}
+
+/**
+*  @brief  Berechnet P = A * B (m x k mal k x n) ueber die gekachelte GEMM
+*  bzw. den Strassen-Algorithmus und reserviert zuvor den Workspace.
+*  @param  accumulate  P += A * B (nur GEMM, sonst false).
+*/
+static void blasMultiply(const MatrixView& P, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const bool accumulate) {
+	const bool strassen = !accumulate && blasUseStrassen(m, n, k);
+	const bool square = m == n && n == k;
+	M_SIZE_TYPE elements = gemmPackElements(m, n, k);
+	if (strassen) {
+		const M_SIZE_TYPE strassenElements = square ? strassenWorkspaceElements(n) : strassenRectWorkspaceElements(m, n, k);
+		elements = strassenElements > elements ? strassenElements : elements;
+	}
+	blasReserve(elements);
+
+	if (!strassen) {
+		gemmPar(P, A, B, m, n, k, accumulate);
+	}
+	else if (square) {
+		strassenMultiplyPar(MatrixView(P.data, P.ld, n), ConstMatrixView(A.data, A.ld, n), ConstMatrixView(B.data, B.ld, n), n);
+	}
+	else {
+		strassenRectPar(P, A, B, m, n, k);
+	}
+}
+
+/**
+*  @brief  Implementierung von gemm (siehe Blas.h) fuer den Werttyp dieses
+*  Namensraums.
+*/
+static int blasGemm(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const M_VAL_TYPE alpha, const M_VAL_TYPE* A, const M_SIZE_TYPE lda, const M_VAL_TYPE* B, const M_SIZE_TYPE ldb,
+		const M_VAL_TYPE beta, M_VAL_TYPE* C, const M_SIZE_TYPE ldc) {
+	bool tA, tB;
+	const int check = blasCheck(transA, transB, m, n, k, lda, ldb, ldc, 8, 10, 13, tA, tB);
+	if (check != 0 || m == 0 || n == 0) {
+		return check;
+	}
+
+	tbb::queuing_mutex::scoped_lock lock(BLAS_MUTEX);
+	blasInit();
+	const MatrixView Cv(C, ldc, 0);
+
+	// C = beta * C (ohne Produkt)
+	if (k == 0 || alpha == 0) {
+		if (beta != 1) {
+			matrixApplyPar(BlasScalePBody(Cv, Cv, 0, beta), m, n);	// P wird bei alpha == 0 nicht gelesen
+		}
+		return 0;
+	}
+
+	InnerArray bufferA, bufferB;
+	const ConstMatrixView Av = blasOperand(A, lda, tA, m, k, bufferA);
+	const ConstMatrixView Bv = blasOperand(B, ldb, tB, k, n, bufferB);
+
+	// alpha == 1, beta == 0 bzw. 1: direkt in C (bei beta == 1 nur ueber die GEMM)
+	if (alpha == 1 && beta == 0) {
+		blasMultiply(Cv, Av, Bv, m, n, k, false);
+		return 0;
+	}
+	if (alpha == 1 && beta == 1 && !blasUseStrassen(m, n, k)) {
+		blasMultiply(Cv, Av, Bv, m, n, k, true);
+		return 0;
+	}
+
+	// Allgemein: P = op(A) * op(B), danach C = alpha * P + beta * C
+	InnerArray p(m * n);
+	const MatrixView P(&p[0], n, 0);
+	blasMultiply(P, Av, Bv, m, n, k, false);
+	matrixApplyPar(BlasScalePBody(Cv, P, alpha, beta), m, n);
+	return 0;
+}
+
+/**
+*  @brief  Funktionsobjekt zur parallelisierten Stapelverarbeitung: Jeder
+*  Teilbereich belegt einmalig die Packpuffer im Workspace seines Threads und
+*  berechnet seine Eintraege nacheinander ueber den Mikrokernel. alpha wird
+*  beim Packen von A eingerechnet, beta vorab auf C angewendet.
+*  Die Matrizen eines Eintrags stammen aus den Zeigerfeldern (As, Bs, Cs) bzw.,
+*  falls diese NULL sind, aus Basiszeiger und Abstand.
+*/
+struct BlasBatchPBody {
+	const M_VAL_TYPE* const* As;
+	const M_VAL_TYPE* const* Bs;
+	M_VAL_TYPE* const* Cs;
+	const M_VAL_TYPE* A;
+	const M_VAL_TYPE* B;
+	M_VAL_TYPE* C;
+	M_SIZE_TYPE strideA, strideB, strideC;
+	M_SIZE_TYPE lda, ldb, ldc;
+	M_SIZE_TYPE m, n, k;
+	bool tA, tB;
+	M_VAL_TYPE alpha, beta;
+
+	void operator()(const tbb::blocked_range<M_SIZE_TYPE>& range) const {
+		const KernelInfo& K = activeKernel();
+		WorkspaceFrame frame;
+		M_VAL_TYPE* ap = frame.buffer(kernelPackElements(m, n, k));
+		M_VAL_TYPE* bp = ap + (m + K.mr - 1) / K.mr * K.mr * k;
+		for (M_SIZE_TYPE b = range.begin(); b != range.end(); ++b) {
+			const MatrixView Cb(Cs != NULL ? Cs[b] : C + b * strideC, ldc, 0);
+			if (beta != 0 && beta != 1) {
+				for (M_SIZE_TYPE i = 0; i < m; ++i) {
+					for (M_SIZE_TYPE j = 0; j < n; ++j) {
+						Cb[i][j] *= beta;
+					}
+				}
+			}
+			if (k == 0 || alpha == 0) {
+				if (beta == 0) {
+					for (M_SIZE_TYPE i = 0; i < m; ++i) {
+						for (M_SIZE_TYPE j = 0; j < n; ++j) {
+							Cb[i][j] = 0;
+						}
+					}
+				}
+				continue;
+			}
+			kernelPackA(ap, ConstMatrixView(As != NULL ? As[b] : A + b * strideA, lda, 0), m, k, tA, alpha);
+			kernelPackB(bp, ConstMatrixView(Bs != NULL ? Bs[b] : B + b * strideB, ldb, 0), k, n, tB);
+			kernelMacro(Cb, ap, bp, m, n, k, beta != 0);
+		}
+	}
+};
+
+/**
+*  @brief  Verteilt einen Stapel auf die Threads (siehe BlasBatchPBody).
+*  Ein Teilbereich umfasst mindestens BLAS_BATCH_GRAIN_FLOPS.
+*/
+static void blasBatch(const BlasBatchPBody& body, const M_SIZE_TYPE& batchCount) {
+	tbb::queuing_mutex::scoped_lock lock(BLAS_MUTEX);
+	blasInit();
+	blasReserve(kernelPackElements(body.m, body.n, body.k));
+	const double flops = 2.0 * body.m * body.n * (body.k != 0 ? body.k : 1);
+	const M_SIZE_TYPE grain = flops >= BLAS_BATCH_GRAIN_FLOPS ? 1 : (M_SIZE_TYPE) (BLAS_BATCH_GRAIN_FLOPS / flops);
+	tbb::parallel_for(tbb::blocked_range<M_SIZE_TYPE>(0, batchCount, grain), body);
+}
+
+/**
+*  @brief  Implementierung von gemmBatched (siehe Blas.h).
+*/
+static int blasGemmBatched(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const M_VAL_TYPE alpha, const M_VAL_TYPE* const* A, const M_SIZE_TYPE lda, const M_VAL_TYPE* const* B, const M_SIZE_TYPE ldb,
+		const M_VAL_TYPE beta, M_VAL_TYPE* const* C, const M_SIZE_TYPE ldc, const M_SIZE_TYPE batchCount) {
+	BlasBatchPBody body = { A, B, C, NULL, NULL, NULL, 0, 0, 0, lda, ldb, ldc, m, n, k, false, false, alpha, beta };
+	const int check = blasCheck(transA, transB, m, n, k, lda, ldb, ldc, 8, 10, 13, body.tA, body.tB);
+	if (check != 0 || m == 0 || n == 0 || batchCount == 0) {
+		return check;
+	}
+	if ((A == NULL || B == NULL) && k != 0 && alpha != 0) {
+		return A == NULL ? -7 : -9;
+	}
+	if (C == NULL) {
+		return -12;
+	}
+	blasBatch(body, batchCount);
+	return 0;
+}
+
+/**
+*  @brief  Implementierung von gemmStridedBatched (siehe Blas.h).
+*/
+static int blasGemmStridedBatched(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const M_VAL_TYPE alpha, const M_VAL_TYPE* A, const M_SIZE_TYPE lda, const M_SIZE_TYPE strideA,
+		const M_VAL_TYPE* B, const M_SIZE_TYPE ldb, const M_SIZE_TYPE strideB,
+		const M_VAL_TYPE beta, M_VAL_TYPE* C, const M_SIZE_TYPE ldc, const M_SIZE_TYPE strideC, const M_SIZE_TYPE batchCount) {
+	BlasBatchPBody body = { NULL, NULL, NULL, A, B, C, strideA, strideB, strideC, lda, ldb, ldc, m, n, k, false, false, alpha, beta };
+	const int check = blasCheck(transA, transB, m, n, k, lda, ldb, ldc, 8, 11, 15, body.tA, body.tB);
+	if (check != 0 || m == 0 || n == 0 || batchCount == 0) {
+		return check;
+	}
+	if (batchCount > 1 && strideC < m * ldc) {
+		return -16;			// Ueberlappende C-Matrizen
+	}
+	blasBatch(body, batchCount);
+	return 0;
+}
+
+} // namespace M_VAL_NAMESPACE
+
+int gemm(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const M_VAL_NAMESPACE::M_VAL_TYPE alpha, const M_VAL_NAMESPACE::M_VAL_TYPE* A, const M_SIZE_TYPE lda,
+		const M_VAL_NAMESPACE::M_VAL_TYPE* B, const M_SIZE_TYPE ldb,
+		const M_VAL_NAMESPACE::M_VAL_TYPE beta, M_VAL_NAMESPACE::M_VAL_TYPE* C, const M_SIZE_TYPE ldc) {
+	return M_VAL_NAMESPACE::blasGemm(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+int gemmBatched(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const M_VAL_NAMESPACE::M_VAL_TYPE alpha, const M_VAL_NAMESPACE::M_VAL_TYPE* const* A, const M_SIZE_TYPE lda,
+		const M_VAL_NAMESPACE::M_VAL_TYPE* const* B, const M_SIZE_TYPE ldb,
+		const M_VAL_NAMESPACE::M_VAL_TYPE beta, M_VAL_NAMESPACE::M_VAL_TYPE* const* C, const M_SIZE_TYPE ldc, const M_SIZE_TYPE batchCount) {
+	return M_VAL_NAMESPACE::blasGemmBatched(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, batchCount);
+}
+
+int gemmStridedBatched(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const M_VAL_NAMESPACE::M_VAL_TYPE alpha, const M_VAL_NAMESPACE::M_VAL_TYPE* A, const M_SIZE_TYPE lda, const M_SIZE_TYPE strideA,
+		const M_VAL_NAMESPACE::M_VAL_TYPE* B, const M_SIZE_TYPE ldb, const M_SIZE_TYPE strideB,
+		const M_VAL_NAMESPACE::M_VAL_TYPE beta, M_VAL_NAMESPACE::M_VAL_TYPE* C, const M_SIZE_TYPE ldc, const M_SIZE_TYPE strideC, const M_SIZE_TYPE batchCount) {
+	return M_VAL_NAMESPACE::blasGemmStridedBatched(transA, transB, m, n, k, alpha, A, lda, strideA, B, ldb, strideB, beta, C, ldc, strideC, batchCount);
+}
@@ -0,0 +1,98 @@
+//============================================================================
+// Name        : Blas.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef BLAS_H_
+#define BLAS_H_
+
+#include "Definitions.h"
+
+/*
+ * Bibliotheksschnittstelle (libHSOS_PaDC_Strassen.a) im Stil von BLAS xGEMM:
+ *
+ *     C = alpha * op(A) * op(B) + beta * C
+ *
+ * mit op(A) (m x k), op(B) (k x n) und C (m x n). Alle Matrizen liegen
+ * zeilenweise im Speicher des Aufrufers (kein Kopieren in Matrix/InnerArray),
+ * lda, ldb und ldc sind die Zeilenabstaende in Elementen. trans: 'N' (op(X) = X)
+ * oder 'T' bzw. 'C' (op(X) = X^T). Je nach Groesse rechnet die gekachelte
+ * GEMM (Naiv-Parallel) oder der Strassen-Algorithmus (Variante, Cut-Offs und
+ * Threads siehe Globals bzw. Tuning-Profil). Aufrufe aus mehreren Threads
+ * werden serialisiert, auch ueber die Werttypen hinweg.
+ *
+ * Rueckgabe: 0 bei Erfolg, sonst -i fuer einen ungueltigen i-ten Parameter
+ * (1: transA, 2: transB, 8: lda, 10: ldb, 13: ldc).
+ */
+int gemm(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const float alpha, const float* A, const M_SIZE_TYPE lda, const float* B, const M_SIZE_TYPE ldb,
+		const float beta, float* C, const M_SIZE_TYPE ldc);
+
+int gemm(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const double alpha, const double* A, const M_SIZE_TYPE lda, const double* B, const M_SIZE_TYPE ldb,
+		const double beta, double* C, const M_SIZE_TYPE ldc);
+
+int gemm(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const int32_t alpha, const int32_t* A, const M_SIZE_TYPE lda, const int32_t* B, const M_SIZE_TYPE ldb,
+		const int32_t beta, int32_t* C, const M_SIZE_TYPE ldc);
+
+int gemm(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const int64_t alpha, const int64_t* A, const M_SIZE_TYPE lda, const int64_t* B, const M_SIZE_TYPE ldb,
+		const int64_t beta, int64_t* C, const M_SIZE_TYPE ldc);
+
+/*
+ * Stapelverarbeitung vieler unabhaengiger, kleiner Produkte gleicher Groesse
+ * (z. B. 32 x 32 bis 256 x 256): C[i] = alpha * op(A[i]) * op(B[i]) + beta * C[i]
+ * fuer i < batchCount. Parallelisiert wird ueber den Stapel, nicht innerhalb
+ * eines Produkts; jedes Produkt laeuft direkt ueber den gepackten Mikrokernel,
+ * die Packpuffer eines Threads werden fuer alle seine Eintraege wiederverwendet.
+ * gemmBatched erhaelt Zeigerfelder, gemmStridedBatched Basiszeiger mit festem
+ * Abstand (stride, in Elementen) zwischen den Matrizen. Die C-Matrizen duerfen
+ * sich nicht ueberlappen.
+ *
+ * Rueckgabe wie gemm (bei gemmStridedBatched mit den Positionen lda 8,
+ * ldb 11 und ldc 15), zusaetzlich -7, -9 bzw. -12 fuer fehlende Zeigerfelder
+ * und -16, falls strideC < m * ldc (ueberlappende C-Matrizen).
+ */
+int gemmBatched(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const float alpha, const float* const* A, const M_SIZE_TYPE lda, const float* const* B, const M_SIZE_TYPE ldb,
+		const float beta, float* const* C, const M_SIZE_TYPE ldc, const M_SIZE_TYPE batchCount);
+
+int gemmStridedBatched(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const float alpha, const float* A, const M_SIZE_TYPE lda, const M_SIZE_TYPE strideA,
+		const float* B, const M_SIZE_TYPE ldb, const M_SIZE_TYPE strideB,
+		const float beta, float* C, const M_SIZE_TYPE ldc, const M_SIZE_TYPE strideC, const M_SIZE_TYPE batchCount);
+
+int gemmBatched(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const double alpha, const double* const* A, const M_SIZE_TYPE lda, const double* const* B, const M_SIZE_TYPE ldb,
+		const double beta, double* const* C, const M_SIZE_TYPE ldc, const M_SIZE_TYPE batchCount);
+
+int gemmStridedBatched(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const double alpha, const double* A, const M_SIZE_TYPE lda, const M_SIZE_TYPE strideA,
+		const double* B, const M_SIZE_TYPE ldb, const M_SIZE_TYPE strideB,
+		const double beta, double* C, const M_SIZE_TYPE ldc, const M_SIZE_TYPE strideC, const M_SIZE_TYPE batchCount);
+
+int gemmBatched(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const int32_t alpha, const int32_t* const* A, const M_SIZE_TYPE lda, const int32_t* const* B, const M_SIZE_TYPE ldb,
+		const int32_t beta, int32_t* const* C, const M_SIZE_TYPE ldc, const M_SIZE_TYPE batchCount);
+
+int gemmStridedBatched(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const int32_t alpha, const int32_t* A, const M_SIZE_TYPE lda, const M_SIZE_TYPE strideA,
+		const int32_t* B, const M_SIZE_TYPE ldb, const M_SIZE_TYPE strideB,
+		const int32_t beta, int32_t* C, const M_SIZE_TYPE ldc, const M_SIZE_TYPE strideC, const M_SIZE_TYPE batchCount);
+
+int gemmBatched(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const int64_t alpha, const int64_t* const* A, const M_SIZE_TYPE lda, const int64_t* const* B, const M_SIZE_TYPE ldb,
+		const int64_t beta, int64_t* const* C, const M_SIZE_TYPE ldc, const M_SIZE_TYPE batchCount);
+
+int gemmStridedBatched(const char transA, const char transB, const M_SIZE_TYPE m, const M_SIZE_TYPE n, const M_SIZE_TYPE k,
+		const int64_t alpha, const int64_t* A, const M_SIZE_TYPE lda, const M_SIZE_TYPE strideA,
+		const int64_t* B, const M_SIZE_TYPE ldb, const M_SIZE_TYPE strideB,
+		const int64_t beta, int64_t* C, const M_SIZE_TYPE ldc, const M_SIZE_TYPE strideC, const M_SIZE_TYPE batchCount);
+
+#endif
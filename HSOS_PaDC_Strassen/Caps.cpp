@@ -0,0 +1,423 @@
+//============================================================================
+// Name        : Caps.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Caps.h"
+#include "Gemm.h"
+#include "Strassen.h"
+#include "Workspace.h"
+#include <tbb/parallel_invoke.h>
+#include <sstream>
+
+namespace M_VAL_NAMESPACE {
+
+#define CAPS_BFS_TEMPORARIES 17			// M1..M7 und zehn Operanden
+#define CAPS_DFS_TEMPORARIES 3			// Operand aus A, Operand aus B, Produkt
+#define CAPS_PRODUCTS 7
+
+#define CAPS_LEAF 0						// Blatt (GEMM)
+#define CAPS_SEQ 1						// Ein Thread: sequentielle DFS-Rekursion im Workspace
+#define CAPS_DFS 2						// Produkte nacheinander, jedes mit allen Threads
+#define CAPS_BFS 3						// Sieben Produkte parallel, Threads aufgeteilt
+
+/**
+*  @brief  Liefert das Speicherbudget fuer Zwischenmatrizen in Elementen
+*  (MEMORY_BUDGET_MIB, 0: unbegrenzt).
+*/
+static M_SIZE_TYPE capsBudgetElements() {
+	if (MEMORY_BUDGET_MIB == 0) {
+		return ~(M_SIZE_TYPE) 0;
+	}
+	return (M_SIZE_TYPE) (((size_t) MEMORY_BUDGET_MIB << 20) / sizeof(M_VAL_TYPE));
+}
+
+/**
+*  @brief  Waehlt den Schritt einer Ebene. BFS lohnt nur, solange mehr als
+*  ein Thread verfuegbar ist, und nur, wenn die 17 Zwischenmatrizen der Ebene
+*  plus der Mindestbedarf der sieben gleichzeitig laufenden Produkte (eine
+*  reine DFS-Rekursion belegt weniger als (n/2)^2 Elemente) ins Budget passen.
+*  @param       n  Matrixdimension (NxN).
+*  @param   width  Verfuegbare Threads.
+*  @param  budget  Verfuegbares Budget in Elementen.
+*  @return CAPS_LEAF, CAPS_SEQ, CAPS_DFS oder CAPS_BFS.
+*/
+static int capsStep(const M_SIZE_TYPE& n, const M_SIZE_TYPE& width, const M_SIZE_TYPE& budget) {
+	if (n <= CUT_OFF) {
+		return CAPS_LEAF;
+	}
+	if (width <= 1) {
+		return CAPS_SEQ;
+	}
+	const M_SIZE_TYPE half = n >> 1;
+	const M_SIZE_TYPE q = half * half;
+	if (budget / (CAPS_BFS_TEMPORARIES + CAPS_PRODUCTS) >= q) {
+		return CAPS_BFS;
+	}
+	return CAPS_DFS;
+}
+
+/**
+*  @brief  Bedarf einer reinen DFS-Rekursion: drei Zwischenmatrizen der halben
+*  Dimension je Ebene oberhalb des Cut-Offs (auch die auf dem Heap). Jeder
+*  Schritt gibt seinen Kindern mindestens deren Bedarf weiter, reicht das
+*  Budget also hierfuer, halten alle Ebenen es ein.
+*  @param  n  Matrixdimension (NxN).
+*  @return Mindestbudget in Elementen.
+*/
+M_SIZE_TYPE capsMinimumElements(const M_SIZE_TYPE& n) {
+	M_SIZE_TYPE elements = 0;
+	for (M_SIZE_TYPE size = n; size > CUT_OFF; size >>= 1) {
+		const M_SIZE_TYPE half = size >> 1;
+		elements += CAPS_DFS_TEMPORARIES * half * half;
+	}
+	return elements;
+}
+
+/**
+*  @brief  Budget eines Kindes nach einem Schritt: Die Zwischenmatrizen des
+*  Schritts (BFS 17, DFS 3) werden abgezogen (saettigend bei 0, nur falls das
+*  Budget unter capsMinimumElements liegt).
+*/
+static M_SIZE_TYPE capsChildBudget(const int step, const M_SIZE_TYPE& n, const M_SIZE_TYPE& budget) {
+	const M_SIZE_TYPE half = n >> 1;
+	const M_SIZE_TYPE used = (step == CAPS_BFS ? CAPS_BFS_TEMPORARIES : CAPS_DFS_TEMPORARIES) * half * half;
+	if (budget == ~(M_SIZE_TYPE) 0) {
+		return budget;
+	}
+	if (budget <= used) {
+		return 0;
+	}
+	return step == CAPS_BFS ? (budget - used) / CAPS_PRODUCTS : budget - used;
+}
+
+/**
+*  @brief  Threads je Kind nach einem BFS-Schritt.
+*/
+static M_SIZE_TYPE capsChildWidth(const M_SIZE_TYPE& width) {
+	return (width + CAPS_PRODUCTS - 1) / CAPS_PRODUCTS;
+}
+
+/**
+*  @brief  Funktionsobjekt zum (parallelisierten) Kopieren.
+*/
+struct CapsCopyPBody {
+	MatrixView C;
+	ConstMatrixView A;
+
+	CapsCopyPBody(const MatrixView& __C, const ConstMatrixView& __A) : C(__C), A(__A) { }
+
+	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
+		for (M_SIZE_TYPE i = range.rows().begin(); i != range.rows().end(); ++i) {
+			for (M_SIZE_TYPE j = range.cols().begin(); j != range.cols().end(); ++j) {
+				C[i][j] = A[i][j];
+			}
+		}
+	}
+};
+
+static inline void capsAdd(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n, const bool parallel) {
+	parallel ? matrixAddPar(C, A, B, n) : matrixAddSeq(C, A, B, n);
+}
+
+static inline void capsSub(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n, const bool parallel) {
+	parallel ? matrixSubPar(C, A, B, n) : matrixSubSeq(C, A, B, n);
+}
+
+static inline void capsCopy(const MatrixView& C, const ConstMatrixView& A, const M_SIZE_TYPE& n, const bool parallel) {
+	TRACE_SCOPE(TRACE_COMBINE, n, 2.0 * n * n * sizeof(M_VAL_TYPE), 0);
+	const CapsCopyPBody body(C, A);
+	parallel ? matrixApplyPar(body, n, n) : body(tbb::blocked_range2d<M_SIZE_TYPE>(0, n, 0, n));
+}
+
+static void capsMultiply(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n, const M_SIZE_TYPE& width, const M_SIZE_TYPE& budget);
+
+/**
+*  @brief  Funktionsobjekt: ein Produkt eines BFS-Schritts.
+*/
+struct CapsProductBody {
+	MatrixView C;
+	ConstMatrixView A;
+	ConstMatrixView B;
+	const M_SIZE_TYPE n;
+	const M_SIZE_TYPE width;
+	const M_SIZE_TYPE budget;
+
+	CapsProductBody(const MatrixView& __C, const ConstMatrixView& __A, const ConstMatrixView& __B, const M_SIZE_TYPE& __n, const M_SIZE_TYPE& __width, const M_SIZE_TYPE& __budget) :
+			C(__C), A(__A), B(__B), n(__n), width(__width), budget(__budget) {
+	}
+
+	void operator()() const {
+		TRACE_TASK_START(n, false);
+		TRACE_SCOPE(TRACE_TASK, n, 0, 0);
+		capsMultiply(C, A, B, n, width, budget);
+	}
+};
+
+/**
+*  @brief  DFS-Schritt: Die sieben Produkte werden nacheinander berechnet und
+*  direkt in die Quadranten von C geschrieben, sodass je Ebene nur drei
+*  Zwischenmatrizen noetig sind. Mit mehreren Threads (HeapFrame) laufen die
+*  Additionen parallel und jedes Produkt nutzt alle Threads; mit einem Thread
+*  (WorkspaceFrame) ist der Schritt rein sequentiell.
+*/
+template <typename Frame>
+static void capsDfs(Frame& frame, const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n, const M_SIZE_TYPE& width, const M_SIZE_TYPE& budget) {
+	const bool parallel = width > 1;
+	const M_SIZE_TYPE newN = n >> 1;
+	const M_SIZE_TYPE childBudget = capsChildBudget(CAPS_DFS, n, budget);
+	// Devide & Conquer (Quadranten als Sichten, ohne Kopie)
+	const ConstMatrixView A11 = A.quadrant(0, 0);
+	const ConstMatrixView A12 = A.quadrant(0, 1);
+	const ConstMatrixView A21 = A.quadrant(1, 0);
+	const ConstMatrixView A22 = A.quadrant(1, 1);
+
+	const ConstMatrixView B11 = B.quadrant(0, 0);
+	const ConstMatrixView B12 = B.quadrant(0, 1);
+	const ConstMatrixView B21 = B.quadrant(1, 0);
+	const ConstMatrixView B22 = B.quadrant(1, 1);
+
+	const MatrixView C11 = C.quadrant(0, 0);
+	const MatrixView C12 = C.quadrant(0, 1);
+	const MatrixView C21 = C.quadrant(1, 0);
+	const MatrixView C22 = C.quadrant(1, 1);
+
+	const MatrixView tmp1 = frame.matrix(newN, C.tile);
+	const MatrixView tmp2 = frame.matrix(newN, C.tile);
+	const MatrixView M = frame.matrix(newN, C.tile);
+
+	// M1 = (A11 + A22) * (B11 + B22) -> C11, C22
+	capsAdd(tmp1, A11, A22, newN, parallel);
+	capsAdd(tmp2, B11, B22, newN, parallel);
+	capsMultiply(C11, tmp1, tmp2, newN, width, childBudget);
+	capsCopy(C22, C11, newN, parallel);
+
+	// M2 = (A21 + A22) * B11 -> C21, C22
+	capsAdd(tmp1, A21, A22, newN, parallel);
+	capsMultiply(C21, tmp1, B11, newN, width, childBudget);
+	capsSub(C22, C22, C21, newN, parallel);
+
+	// M3 = A11 * (B12 - B22) -> C12, C22
+	capsSub(tmp2, B12, B22, newN, parallel);
+	capsMultiply(C12, A11, tmp2, newN, width, childBudget);
+	capsAdd(C22, C22, C12, newN, parallel);
+
+	// M4 = A22 * (B21 - B11) -> C11, C21
+	capsSub(tmp2, B21, B11, newN, parallel);
+	capsMultiply(M, A22, tmp2, newN, width, childBudget);
+	capsAdd(C11, C11, M, newN, parallel);
+	capsAdd(C21, C21, M, newN, parallel);
+
+	// M5 = (A11 + A12) * B22 -> C11, C12
+	capsAdd(tmp1, A11, A12, newN, parallel);
+	capsMultiply(M, tmp1, B22, newN, width, childBudget);
+	capsSub(C11, C11, M, newN, parallel);
+	capsAdd(C12, C12, M, newN, parallel);
+
+	// M6 = (A21 - A11) * (B11 + B12) -> C22
+	capsSub(tmp1, A21, A11, newN, parallel);
+	capsAdd(tmp2, B11, B12, newN, parallel);
+	capsMultiply(M, tmp1, tmp2, newN, width, childBudget);
+	capsAdd(C22, C22, M, newN, parallel);
+
+	// M7 = (A12 - A22) * (B21 + B22) -> C11
+	capsSub(tmp1, A12, A22, newN, parallel);
+	capsAdd(tmp2, B21, B22, newN, parallel);
+	capsMultiply(M, tmp1, tmp2, newN, width, childBudget);
+	capsAdd(C11, C11, M, newN, parallel);
+}
+
+/**
+*  @brief  BFS-Schritt: Alle Operanden werden (parallel) gebildet, die
+*  sieben Produkte laufen gleichzeitig mit je einem Siebtel der Threads und
+*  des Restbudgets.
+*/
+static void capsBfs(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n, const M_SIZE_TYPE& width, const M_SIZE_TYPE& budget) {
+	const M_SIZE_TYPE newN = n >> 1;
+	const M_SIZE_TYPE childWidth = capsChildWidth(width);
+	const M_SIZE_TYPE childBudget = capsChildBudget(CAPS_BFS, n, budget);
+	HeapFrame frame;
+	// Devide & Conquer (Quadranten als Sichten, ohne Kopie)
+	const ConstMatrixView A11 = A.quadrant(0, 0);
+	const ConstMatrixView A12 = A.quadrant(0, 1);
+	const ConstMatrixView A21 = A.quadrant(1, 0);
+	const ConstMatrixView A22 = A.quadrant(1, 1);
+
+	const ConstMatrixView B11 = B.quadrant(0, 0);
+	const ConstMatrixView B12 = B.quadrant(0, 1);
+	const ConstMatrixView B21 = B.quadrant(1, 0);
+	const ConstMatrixView B22 = B.quadrant(1, 1);
+
+	const MatrixView M1 = frame.matrix(newN, C.tile);
+	const MatrixView M2 = frame.matrix(newN, C.tile);
+	const MatrixView M3 = frame.matrix(newN, C.tile);
+	const MatrixView M4 = frame.matrix(newN, C.tile);
+	const MatrixView M5 = frame.matrix(newN, C.tile);
+	const MatrixView M6 = frame.matrix(newN, C.tile);
+	const MatrixView M7 = frame.matrix(newN, C.tile);
+	const MatrixView SA1 = frame.matrix(newN, C.tile);
+	const MatrixView SB1 = frame.matrix(newN, C.tile);
+	const MatrixView SA2 = frame.matrix(newN, C.tile);
+	const MatrixView SB3 = frame.matrix(newN, C.tile);
+	const MatrixView SB4 = frame.matrix(newN, C.tile);
+	const MatrixView SA5 = frame.matrix(newN, C.tile);
+	const MatrixView SA6 = frame.matrix(newN, C.tile);
+	const MatrixView SB6 = frame.matrix(newN, C.tile);
+	const MatrixView SA7 = frame.matrix(newN, C.tile);
+	const MatrixView SB7 = frame.matrix(newN, C.tile);
+
+	matrixAddPar(SA1, A11, A22, newN);
+	matrixAddPar(SB1, B11, B22, newN);
+	matrixAddPar(SA2, A21, A22, newN);
+	matrixSubPar(SB3, B12, B22, newN);
+	matrixSubPar(SB4, B21, B11, newN);
+	matrixAddPar(SA5, A11, A12, newN);
+	matrixSubPar(SA6, A21, A11, newN);
+	matrixAddPar(SB6, B11, B12, newN);
+	matrixSubPar(SA7, A12, A22, newN);
+	matrixAddPar(SB7, B21, B22, newN);
+
+	tbb::parallel_invoke(
+			CapsProductBody(M1, SA1, SB1, newN, childWidth, childBudget),
+			CapsProductBody(M2, SA2, B11, newN, childWidth, childBudget),
+			CapsProductBody(M3, A11, SB3, newN, childWidth, childBudget),
+			CapsProductBody(M4, A22, SB4, newN, childWidth, childBudget),
+			CapsProductBody(M5, SA5, B22, newN, childWidth, childBudget),
+			CapsProductBody(M6, SA6, SB6, newN, childWidth, childBudget),
+			CapsProductBody(M7, SA7, SB7, newN, childWidth, childBudget));
+
+	matrixCombinePar(StrassenCombinePBody(C.quadrant(0, 0), C.quadrant(0, 1), C.quadrant(1, 0), C.quadrant(1, 1), M1, M2, M3, M4, M5, M6, M7), newN, newN, 11, 8);
+}
+
+/**
+*  @brief  Prueft, ob ein sequentieller Teilbaum in den Rest des Workspaces
+*  des ausfuehrenden Threads passt. Groessere Teilbaeume (z. B. die oberen
+*  Ebenen von strassenCapsSeq) belegen ihre Ebene auf dem Heap, sodass kein
+*  Thread mehr als den geplanten Teilbaum reservieren muss.
+*/
+static bool capsWorkspaceFits(const M_SIZE_TYPE& n) {
+	const Workspace& ws = localWorkspace();
+	return ws.mark() + workspaceSeriesElements(n, CUT_OFF, CAPS_DFS_TEMPORARIES) + gemmPackElements(CUT_OFF, CUT_OFF, CUT_OFF) <= ws.reservedElements();
+}
+
+/**
+*  @brief  Rekursion des BFS/DFS-Hybrids (CAPS): waehlt je Ebene den Schritt
+*  anhand der verfuegbaren Threads und des Restbudgets.
+*  @param       C  Matrix C (Ergebnismatrix, wird ueberschrieben).
+*  @param       A  Matrix A.
+*  @param       B  Matrix B.
+*  @param       n  Matrixdimension (NxN).
+*  @param   width  Verfuegbare Threads.
+*  @param  budget  Budget fuer Zwischenmatrizen in Elementen.
+*/
+static void capsMultiply(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n, const M_SIZE_TYPE& width, const M_SIZE_TYPE& budget) {
+	switch (capsStep(n, width, budget)) {
+	case CAPS_LEAF:
+		if (width > 1) {
+			TRACE_SCOPE(TRACE_LEAF, n, 3.0 * n * n * sizeof(M_VAL_TYPE), 2.0 * n * n * n);
+			gemmPar(C, A, B, n, n, n);
+		}
+		else {
+			strassenLeaf(C, A, B, n);
+		}
+		break;
+	case CAPS_SEQ:
+		if (capsWorkspaceFits(n)) {
+			WorkspaceFrame frame;
+			capsDfs(frame, C, A, B, n, width, budget);
+		}
+		else {
+			HeapFrame frame;
+			capsDfs(frame, C, A, B, n, width, budget);
+		}
+		break;
+	case CAPS_DFS: {
+		HeapFrame frame;
+		capsDfs(frame, C, A, B, n, width, budget);
+		break;
+	}
+	default:
+		capsBfs(C, A, B, n, width, budget);
+		break;
+	}
+}
+
+/**
+*  @brief  Beschreibt die Schritte entlang eines Rekursionspfads, z. B.
+*  "BFS BFS DFS SEQ(256)".
+*  @param  n  Matrixdimension (NxN).
+*/
+std::string capsPlan(const M_SIZE_TYPE& n) {
+	std::ostringstream plan;
+	M_SIZE_TYPE size = n;
+	M_SIZE_TYPE width = NO_THREADS;
+	M_SIZE_TYPE budget = capsBudgetElements();
+	for (;;) {
+		const int step = capsStep(size, width, budget);
+		if (step == CAPS_LEAF) {
+			plan << "GEMM(" << size << (width > 1 ? ", parallel)" : ")");
+			break;
+		}
+		if (step == CAPS_SEQ) {
+			plan << "SEQ(" << size << ")";
+			break;
+		}
+		plan << (step == CAPS_BFS ? "BFS " : "DFS ");
+		budget = capsChildBudget(step, size, budget);
+		width = step == CAPS_BFS ? capsChildWidth(width) : width;
+		size >>= 1;
+	}
+	return plan.str();
+}
+
+/**
+*  @brief  Berechnet die Groesse des Workspaces je Thread: Nur die
+*  sequentiellen Teilbaeume (ein Thread) nutzen den Workspace, die oberen
+*  Ebenen belegen ihre Zwischenmatrizen auf dem Heap (HeapFrame).
+*  @param  n  Matrixdimension (NxN).
+*  @return Benoetigte Elemente je Thread.
+*/
+M_SIZE_TYPE capsWorkspaceElements(const M_SIZE_TYPE& n) {
+	M_SIZE_TYPE size = n;
+	M_SIZE_TYPE width = NO_THREADS;
+	M_SIZE_TYPE budget = capsBudgetElements();
+	int step;
+	while ((step = capsStep(size, width, budget)) == CAPS_BFS || step == CAPS_DFS) {
+		budget = capsChildBudget(step, size, budget);
+		width = step == CAPS_BFS ? capsChildWidth(width) : width;
+		size >>= 1;
+	}
+	const M_SIZE_TYPE seq = step == CAPS_SEQ ? workspaceSeriesElements(size, CUT_OFF, CAPS_DFS_TEMPORARIES) : 0;
+	return TASK_WORKSPACE_SLACK * (seq + gemmPackElements(CUT_OFF, CUT_OFF, CUT_OFF));
+}
+
+/**
+*  @brief  Multipliziert zwei Matrizen mit dem BFS/DFS-Hybrid (CAPS) unter
+*  Beachtung von MEMORY_BUDGET_MIB.
+*  @param  C  Matrix C (Ergebnismatrix, wird ueberschrieben).
+*  @param  A  Matrix A.
+*  @param  B  Matrix B.
+*  @param  n  Matrixdimension (NxN).
+*/
+void strassenCaps(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
+	capsMultiply(C, A, B, n, NO_THREADS, capsBudgetElements());
+}
+
+/**
+*  @brief  Sequentielle Variante (ein Thread, reine DFS-Rekursion mit drei
+*  Zwischenmatrizen je Ebene).
+*  @param  C  Matrix C (Ergebnismatrix, wird ueberschrieben).
+*  @param  A  Matrix A.
+*  @param  B  Matrix B.
+*  @param  n  Matrixdimension (NxN).
+*/
+void strassenCapsSeq(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
+	capsMultiply(C, A, B, n, 1, capsBudgetElements());
+}
+
+} // namespace M_VAL_NAMESPACE
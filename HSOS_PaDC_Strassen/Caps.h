@@ -0,0 +1,32 @@
+//============================================================================
+// Name        : Caps.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef CAPS_H_
+#define CAPS_H_
+
+#include "Definitions.h"
+#include "Matrix.h"
+#include <string>
+
+namespace M_VAL_NAMESPACE {
+
+M_SIZE_TYPE capsWorkspaceElements(const M_SIZE_TYPE& n);
+
+std::string capsPlan(const M_SIZE_TYPE& n);
+
+M_SIZE_TYPE capsMinimumElements(const M_SIZE_TYPE& n);
+
+void strassenCapsSeq(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n);
+
+void strassenCaps(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n);
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
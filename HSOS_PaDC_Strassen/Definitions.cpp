@@ -14,7 +14,41 @@ int RUN_NAIV_SEQ 			= 0;
 int RUN_NAIV_PAR 			= 0;
 int RUN_STRASSEN_SEQ 		= 1;
 int RUN_STRASSEN_PAR 		= 1;
+int STRASSEN_VARIANT		= VARIANT_STRASSEN;
+int FLOW_PRODUCTS_IN_FLIGHT	= 0;
+unsigned MEMORY_BUDGET_MIB	= 0;
+int M_VAL_TYPE_SELECT		= M_TYPE_DOUBLE;
+const char* const M_VAL_TYPE_NAMES[M_TYPE_COUNT] = { "float", "double", "int32", "int64" };
+int MATRIX_LAYOUT			= 0;
+int NUMA_POLICY				= NUMA_FIRST_TOUCH;
 
 M_SIZE_TYPE M_SIZE			= 4;
+M_SIZE_TYPE M_ROWS			= 0;
+M_SIZE_TYPE M_INNER			= 0;
+M_SIZE_TYPE BATCH_COUNT		= 0;
+int RUN_INVERSE				= 0;
 M_SIZE_TYPE CUT_OFF 		= 64;
+M_SIZE_TYPE CUT_OFF_TASK	= 0;
+int CUT_OFF_FIXED			= 0;
+int TUNE_MODE				= 0;
+const char* PROFILE_PATH	= NULL;
+int VERIFY_VECTORS			= 0;
+uint64_t RANDOM_SEED		= 0;
+const char* TRACE_PATH		= NULL;
+std::vector<M_SIZE_TYPE> BENCH_SIZES;
+std::vector<M_SIZE_TYPE> BENCH_THREADS;
+std::vector<M_SIZE_TYPE> BENCH_CUT_OFFS;
+int BENCH_REPEATS			= 5;
+int BENCH_WARMUPS			= 1;
+const char* MATRIX_FILE_A	= NULL;
+const char* MATRIX_FILE_B	= NULL;
+const char* MATRIX_FILE_C	= NULL;
+int MATRIX_FILE_TILE		= -1;
+unsigned OOC_BUDGET_MIB		= 0;
+const char* OOC_SCRATCH_DIR	= NULL;
+int DIST_LAYERS				= 1;
+int DIST_STRASSEN_LEVELS	= 0;
+const char* BENCH_PATH		= NULL;
 unsigned NO_THREADS			= 0;
+tbb::queuing_mutex BLAS_MUTEX;
+bool BLAS_INITIALIZED		= false;
@@ -11,29 +11,109 @@
 #ifndef DEFINITIONS_H_
 #define DEFINITIONS_H_
 
+#include "Numa.h"
+#include <tbb/queuing_mutex.h>
 #include <tbb/scalable_allocator.h>
 #include <stdint.h>
 #include <vector>
 
 typedef uint_fast32_t M_SIZE_TYPE;		// Groessentyp der Matrizen, Schleifenzaehler usw.
-typedef double M_VAL_TYPE;				// Typ der Werte in den Matrizen (Gut: int_least32_t)
+
+#define M_TYPE_FLOAT 0					// Werttyp float (32 Bit, doppelte SIMD-Breite)
+#define M_TYPE_DOUBLE 1					// Werttyp double
+#define M_TYPE_INT32 2					// Werttyp int32_t (exakte Arithmetik)
+#define M_TYPE_INT64 3					// Werttyp int64_t (exakte Arithmetik)
+#define M_TYPE_COUNT 4					// Anzahl der uebersetzten Werttypen
+
+/*
+ * Die typabhaengigen Module werden je Werttyp einmal uebersetzt (M_VAL_TYPE_ID
+ * per -D, siehe makefile) und liegen jeweils in einem eigenen Namensraum,
+ * sodass alle Werttypen in einem Programm enthalten sind. Die Auswahl erfolgt
+ * zur Laufzeit (-d). Typunabhaengige Globals liegen im globalen Namensraum.
+ */
+#ifndef M_VAL_TYPE_ID
+#define M_VAL_TYPE_ID M_TYPE_DOUBLE
+#endif
+
+#if M_VAL_TYPE_ID == M_TYPE_FLOAT
+#define M_VAL_NAMESPACE strassen_float
+#define M_VAL_TYPE_NAME "float"			// Name des Werttyps (z. B. fuer das Tuning-Profil)
+#define M_VAL_IS_INTEGER 0
+#elif M_VAL_TYPE_ID == M_TYPE_DOUBLE
+#define M_VAL_NAMESPACE strassen_double
+#define M_VAL_TYPE_NAME "double"
+#define M_VAL_IS_INTEGER 0
+#elif M_VAL_TYPE_ID == M_TYPE_INT32
+#define M_VAL_NAMESPACE strassen_int32
+#define M_VAL_TYPE_NAME "int32"
+#define M_VAL_IS_INTEGER 1
+#elif M_VAL_TYPE_ID == M_TYPE_INT64
+#define M_VAL_NAMESPACE strassen_int64
+#define M_VAL_TYPE_NAME "int64"
+#define M_VAL_IS_INTEGER 1
+#else
+#error "Unbekannter Werttyp (M_VAL_TYPE_ID)"
+#endif
+
+namespace M_VAL_NAMESPACE {
+
+#if M_VAL_TYPE_ID == M_TYPE_FLOAT
+typedef float M_VAL_TYPE;				// Typ der Werte in den Matrizen
+#elif M_VAL_TYPE_ID == M_TYPE_DOUBLE
+typedef double M_VAL_TYPE;
+#elif M_VAL_TYPE_ID == M_TYPE_INT32
+typedef int32_t M_VAL_TYPE;
+#else
+typedef int64_t M_VAL_TYPE;
+#endif
 
 #define ARRAY_TYPE 1					// Gibt an, ob 1- oder 2-Dimensionales Array (Vector) verwendet werden soll
 typedef std::vector<M_VAL_TYPE, tbb::scalable_allocator<M_VAL_TYPE> > InnerArray;
+
+/**
+*  @brief  Speicher grosser Matrizen: NUMA-gerecht platziert und parallel mit
+*  0 initialisiert (siehe numaAllocate bzw. NUMA_POLICY), statt seriell beim
+*  Anlegen eines InnerArray. Nicht kopierbar.
+*/
+class MatrixStorage {
+	M_VAL_TYPE* data;
+	const size_t elements;
+
+	MatrixStorage(const MatrixStorage&);
+	MatrixStorage& operator=(const MatrixStorage&);
+
+public:
+	explicit MatrixStorage(const size_t _elements) : data(static_cast<M_VAL_TYPE*>(numaAllocate(_elements * sizeof(M_VAL_TYPE)))), elements(_elements) { }
+
+	~MatrixStorage() {
+		numaFree(data, elements * sizeof(M_VAL_TYPE));
+	}
+
+	size_t size() const {
+		return elements;
+	}
+
+	M_VAL_TYPE& operator[](const size_t i) {
+		return data[i];
+	}
+
+	const M_VAL_TYPE& operator[](const size_t i) const {
+		return data[i];
+	}
+};
+
 #if ARRAY_TYPE == 2
 typedef std::vector<InnerArray, tbb::scalable_allocator<InnerArray> > Matrix;
 #else
 struct Matrix {
 	const M_SIZE_TYPE& n;
-    InnerArray mdArray;
+    MatrixStorage mdArray;
 
 	M_SIZE_TYPE size() const /*_GLIBCXX_NOEXCEPT*/ {
 		return n;
 	}
 
-	Matrix(const M_SIZE_TYPE& _n, const InnerArray) : n(_n) {
-		mdArray.resize(n * n);
-	}
+	Matrix(const M_SIZE_TYPE& _n, const InnerArray) : n(_n), mdArray((size_t) _n * _n) { }
 
 	M_VAL_TYPE* operator[](const M_SIZE_TYPE& row) {
     	return &mdArray[row * n];
@@ -45,22 +125,166 @@ struct Matrix {
 };
 #endif
 
+#if ARRAY_TYPE == 2
+#error "MatrixView setzt ein zusammenhaengendes Array voraus (ARRAY_TYPE 1)"
+#endif
+
+/**
+*  @brief  Sicht auf eine (Teil-)Matrix ohne eigenen Speicher. Die Elemente
+*  werden ueber Basiszeiger und Zeilenabstand (Leading Dimension) adressiert,
+*  sodass Quadranten ohne Kopie direkt in der Ursprungsmatrix liegen.
+*  Ist tile != 0 und n > tile, liegt die Matrix im Morton-Layout (Z-Ordnung
+*  aus Kacheln der Groesse tile x tile) vor: Jeder Quadrant ist dann ein
+*  zusammenhaengender Block und ld == n. Elementweise Operationen ueber [][]
+*  sind korrekt, solange alle beteiligten Sichten dasselbe Layout besitzen.
+*/
+struct MatrixView {
+	M_VAL_TYPE* data;					// Basiszeiger (Element [0][0])
+	M_SIZE_TYPE ld;						// Zeilenabstand in Elementen
+	M_SIZE_TYPE n;						// Dimension der Sicht (n x n)
+	M_SIZE_TYPE tile;					// Kachelgroesse im Morton-Layout (0: zeilenweise)
+
+	MatrixView(M_VAL_TYPE* _data, const M_SIZE_TYPE& _ld, const M_SIZE_TYPE& _n, const M_SIZE_TYPE& _tile = 0) : data(_data), ld(_ld), n(_n), tile(_tile) { }
+
+	MatrixView(Matrix& M) : data(&M.mdArray[0]), ld(M.size()), n(M.size()), tile(0) { }
+
+	M_SIZE_TYPE size() const {
+		return n;
+	}
+
+	bool isMorton() const {
+		return tile != 0 && n > tile;
+	}
+
+	M_VAL_TYPE* operator[](const M_SIZE_TYPE& row) const {
+		return data + row * ld;
+	}
+
+	/**
+	*  @brief  Liefert einen Quadranten der Sicht (ohne Kopie).
+	*  @param  row  Zeile des Quadranten (0 oder 1).
+	*  @param  col  Spalte des Quadranten (0 oder 1).
+	*  @return Sicht auf den Quadranten der Dimension n/2.
+	*/
+	MatrixView quadrant(const M_SIZE_TYPE& row, const M_SIZE_TYPE& col) const {
+		const M_SIZE_TYPE half = n >> 1;
+		if (isMorton()) {
+			return MatrixView(data + ((row << 1) + col) * half * half, half, half, tile);
+		}
+		return MatrixView(data + row * half * ld + col * half, ld, half);
+	}
+
+	/**
+	*  @brief  Liefert eine Sicht ab Element [row][col] (nur zeilenweises
+	*  Layout), z. B. fuer rechteckige Bloecke. Die Groesse des Blocks wird
+	*  vom Aufrufer verwaltet (n = 0).
+	*/
+	MatrixView block(const M_SIZE_TYPE& row, const M_SIZE_TYPE& col) const {
+		return MatrixView(data + row * ld + col, ld, 0);
+	}
+};
+
+/**
+*  @brief  Nur-Lese-Variante von MatrixView (fuer die Operanden A und B).
+*/
+struct ConstMatrixView {
+	const M_VAL_TYPE* data;				// Basiszeiger (Element [0][0])
+	M_SIZE_TYPE ld;						// Zeilenabstand in Elementen
+	M_SIZE_TYPE n;						// Dimension der Sicht (n x n)
+	M_SIZE_TYPE tile;					// Kachelgroesse im Morton-Layout (0: zeilenweise)
+
+	ConstMatrixView(const M_VAL_TYPE* _data, const M_SIZE_TYPE& _ld, const M_SIZE_TYPE& _n, const M_SIZE_TYPE& _tile = 0) : data(_data), ld(_ld), n(_n), tile(_tile) { }
+
+	ConstMatrixView(const MatrixView& V) : data(V.data), ld(V.ld), n(V.n), tile(V.tile) { }
+
+	ConstMatrixView(const Matrix& M) : data(&M.mdArray[0]), ld(M.size()), n(M.size()), tile(0) { }
+
+	M_SIZE_TYPE size() const {
+		return n;
+	}
+
+	bool isMorton() const {
+		return tile != 0 && n > tile;
+	}
+
+	const M_VAL_TYPE* operator[](const M_SIZE_TYPE& row) const {
+		return data + row * ld;
+	}
+
+	ConstMatrixView quadrant(const M_SIZE_TYPE& row, const M_SIZE_TYPE& col) const {
+		const M_SIZE_TYPE half = n >> 1;
+		if (isMorton()) {
+			return ConstMatrixView(data + ((row << 1) + col) * half * half, half, half, tile);
+		}
+		return ConstMatrixView(data + row * half * ld + col * half, ld, half);
+	}
+
+	ConstMatrixView block(const M_SIZE_TYPE& row, const M_SIZE_TYPE& col) const {
+		return ConstMatrixView(data + row * ld + col, ld, 0);
+	}
+};
+
+} // namespace M_VAL_NAMESPACE
+
 #define USE_PARTITIONS 1				// Aktiviert partitionierte Strassen-Algorithmen (bspw. Half-And-Half)
 #define DEBUG 1							// Debuggen? (Z. B. Verwendung von Consolen-Ausgaben, Konstanten Werten usw.)
 #define MAX_RAND_VAL RAND_MAX / 50		// Zufallszahlen bis (21474836472147483647 / X) z.B. 50 oder 750
+#define MAX_RAND_INT 10					// Ganzzahlige Werttypen: Zufallszahlen 0 bis X - 1 (kein Ueberlauf der Zwischenwerte)
 #define STD_WIDTH 9						// Matrixausgabe: Indexbreite
 #define STD_PRECISION 5					// Matrixausgabe: Genauigkeit bei Gleitkommawerten
-#define THRESHOLD 0.001					// Max. Abweichung als Ungenauigkeit der Gleitkommawerte
+#define THRESHOLD 0.001					// Max. Abweichung als Ungenauigkeit der Gleitkommawerte (float: relativ)
 #define USE_IKJ 1		 				// Schnellere Matrizenmultiplikation (statt ijk)
+#define VARIANT_STRASSEN 0				// Klassischer Strassen-Algorithmus (18 Additionen)
+#define VARIANT_WINOGRAD 1				// Strassen-Winograd (15 Additionen)
+#define VARIANT_FLOW_GRAPH 2			// Strassen als Abhaengigkeitsgraph (tbb::flow, nur parallel)
+#define VARIANT_CAPS 3					// BFS/DFS-Hybrid mit Speicherbudget (CAPS, nur parallel)
+#define USE_SIMD_KERNEL 1				// Gepackter SIMD-Mikrokernel in den Blaettern (statt matrixMultSeq)
+#define USE_NUMA 1						// NUMA-Platzierung grosser Matrizen (Linux: mbind, ohne libnuma)
+#define VERIFY_MAX_VECTORS 16			// Freivalds-Pruefung: max. Anzahl der Zufallsvektoren
+#define USE_TRACE 1						// Instrumentierung je Rekursionsebene (siehe Trace.h, aktiv mit -j)
 
 // extern - globals
 extern int RUN_NAIV_SEQ;				// Naiven Algorithmus sequentiell ausfuehren
 extern int RUN_NAIV_PAR;				// Naiven Algorithmus parallel ausfuehren
 extern int RUN_STRASSEN_SEQ;			// Strassen-Algorithmus sequentiell ausfuehren
 extern int RUN_STRASSEN_PAR;			// Strassen-Algorithmus parallel ausfuehren
+extern int STRASSEN_VARIANT;			// Auswahl der Variante (VARIANT_*)
+extern int FLOW_PRODUCTS_IN_FLIGHT;		// Max. gleichzeitige Produkte je Graph (0: unbegrenzt)
+extern unsigned MEMORY_BUDGET_MIB;		// Budget fuer Zwischenmatrizen der CAPS-Variante in MiB (0: unbegrenzt)
+extern int M_VAL_TYPE_SELECT;			// Auswahl des Werttyps (M_TYPE_*)
+extern const char* const M_VAL_TYPE_NAMES[M_TYPE_COUNT];	// Namen der Werttypen (Index: M_TYPE_*)
+extern int MATRIX_LAYOUT;				// Speicherlayout fuer Strassen: 0 zeilenweise, 1 Morton, 2 beide (Vergleich)
+extern int NUMA_POLICY;					// Platzierung grosser Matrizen (NUMA_*)
 
-extern M_SIZE_TYPE M_SIZE;				// Dimension der Matrix (SIZE x SIZE)
+extern M_SIZE_TYPE M_SIZE;				// Dimension der Matrix (SIZE x SIZE), bei Rechtecken Spalten von B und C
+extern M_SIZE_TYPE M_ROWS;				// Zeilen von A und C (0: wie M_SIZE)
+extern M_SIZE_TYPE M_INNER;				// Spalten von A bzw. Zeilen von B (0: wie M_SIZE)
+extern M_SIZE_TYPE BATCH_COUNT;			// Stapelbetrieb: Anzahl unabhaengiger n x n Produkte (0: aus)
+extern int RUN_INVERSE;					// Inversion von A und Loesen von A X = B nach Strassen (siehe Inverse.h)
 extern M_SIZE_TYPE CUT_OFF;				// Ab welcher Dimension soll naiver Algorithmus eingesetzt werden? Min. CUT_OFF x CUT_OFF = 4! //(2 << (POW >> 1));
+extern M_SIZE_TYPE CUT_OFF_TASK;		// Ab welcher Dimension rechnen Tasks sequentiell weiter (0: Tasks bis CUT_OFF)
+extern int CUT_OFF_FIXED;				// Cut-Offs per Kommandozeile gesetzt (kein Laden aus dem Profil)
+extern int TUNE_MODE;					// Autotuning: 0 aus, 1 CUT_OFF, 2 CUT_OFF und CUT_OFF_TASK
+extern const char* PROFILE_PATH;		// Pfad des Tuning-Profils (NULL: Standardpfad)
+extern int VERIFY_VECTORS;				// Freivalds-Pruefung jedes Strassen-Ergebnisses: Anzahl der Zufallsvektoren (0: aus)
+extern uint64_t RANDOM_SEED;			// Startwert der Zufallsmatrizen (0: aus der Uhrzeit)
+extern const char* TRACE_PATH;			// JSON-Datei der Instrumentierung (NULL: aus)
+extern std::vector<M_SIZE_TYPE> BENCH_SIZES;	// Benchmark-Modus: Matrixdimensionen (leer: aus)
+extern std::vector<M_SIZE_TYPE> BENCH_THREADS;	// Benchmark-Modus: Thread-Anzahlen (leer: NO_THREADS)
+extern std::vector<M_SIZE_TYPE> BENCH_CUT_OFFS;	// Benchmark-Modus: Cut-Offs (leer: CUT_OFF)
+extern int BENCH_REPEATS;				// Benchmark-Modus: Messungen je Fall
+extern int BENCH_WARMUPS;				// Benchmark-Modus: Aufwaermlaeufe je Fall
+extern const char* MATRIX_FILE_A;		// Matrixdatei A (siehe MatrixFile.h; NULL: Zufallsmatrizen)
+extern const char* MATRIX_FILE_B;		// Matrixdatei B
+extern const char* MATRIX_FILE_C;		// Ergebnisdatei C (NULL: nicht speichern)
+extern int MATRIX_FILE_TILE;			// A und B vor -i als Zufallsmatrizen n x n anlegen: Kachelgroesse (0: zeilenweise, -1: nicht anlegen)
+extern unsigned OOC_BUDGET_MIB;			// Out-of-Core-Modus fuer -i/-w: RAM-Budget in MiB (0: aus, siehe OutOfCore.h)
+extern const char* OOC_SCRATCH_DIR;		// Verzeichnis der Zwischendateien (NULL: Verzeichnis von -w)
+extern int DIST_LAYERS;					// MPI-Programm: Ebenen der 2.5D-Verteilung (1: 2D-SUMMA)
+extern int DIST_STRASSEN_LEVELS;			// MPI-Programm: verteilte Strassen-Ebenen (0: SUMMA, 1: 7, 2: 49 Prozesse)
+extern const char* BENCH_PATH;			// Ergebnisdatei des Benchmarks (*.json: JSON, sonst CSV; NULL: CSV auf der Konsole)
 extern unsigned NO_THREADS;				// Anzahl zu nutzender Threads
+extern tbb::queuing_mutex BLAS_MUTEX;	// Serialisiert BLAS-Aufrufe aller Werttypen (gemeinsame Globals wie NO_THREADS, CUT_OFF)
+extern bool BLAS_INITIALIZED;			// BLAS: Threads und Cut-Offs bereits festgelegt (fuer alle Werttypen)
 
 #endif
@@ -0,0 +1,294 @@
+//============================================================================
+// Name        : DistStrassen.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Distributed.h"
+#include "Blas.h"
+#include "Strassen.h"
+#include <algorithm>
+#include <limits.h>
+#include <sstream>
+#include <vector>
+#include <tbb/tick_count.h>
+
+namespace M_VAL_NAMESPACE {
+
+using tbb::tick_count;
+
+/**
+*  @brief  Linearkombination C = sum_t sign_t X_t mit Vorzeichen +1 bzw. -1
+*  (Operanden S_p, T_p und Zeilen von C). Ohne Summanden wird C genullt.
+*/
+struct DistCombinePBody {
+	MatrixView C;
+	const M_VAL_TYPE* term[DIST_STRASSEN_TERMS];
+	M_SIZE_TYPE ld[DIST_STRASSEN_TERMS];
+	int sign[DIST_STRASSEN_TERMS];
+	int terms;
+
+	DistCombinePBody(const MatrixView& __C) : C(__C), terms(0) { }
+
+	void add(const ConstMatrixView& X, const int __sign) {
+		term[terms] = X.data;
+		ld[terms] = X.ld;
+		sign[terms] = __sign;
+		++terms;
+	}
+
+	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
+		for (M_SIZE_TYPE i = range.rows().begin(); i != range.rows().end(); ++i) {
+			M_VAL_TYPE* c = C[i];
+			for (M_SIZE_TYPE j = range.cols().begin(); j != range.cols().end(); ++j) {
+				c[j] = 0;
+			}
+			for (int t = 0; t < terms; ++t) {
+				const M_VAL_TYPE* x = term[t] + i * ld[t];
+				if (sign[t] > 0) {
+					for (M_SIZE_TYPE j = range.cols().begin(); j != range.cols().end(); ++j) {
+						c[j] += x[j];
+					}
+				}
+				else {
+					for (M_SIZE_TYPE j = range.cols().begin(); j != range.cols().end(); ++j) {
+						c[j] -= x[j];
+					}
+				}
+			}
+		}
+	}
+};
+
+/**
+*  @brief  Koeffizient von Block (row, col) in Teilprodukt path ueber alle
+*  verteilten Ebenen: Produkt der Tabelleneintraege je Ebene. Die letzte
+*  Ziffer von path (Basis 7) und die niedrigsten Bits von row und col
+*  gehoeren zur untersten Ebene.
+*  @param           table  STRASSEN_LEFT, STRASSEN_RIGHT oder STRASSEN_SIGNS.
+*  @param   productStride  Abstand der Produkte in der Tabelle.
+*  @param  quadrantStride  Abstand der Quadranten in der Tabelle.
+*  @return 1, -1 oder 0.
+*/
+static int distCoefficient(const int* table, const int productStride, const int quadrantStride, int path, const int levels, M_SIZE_TYPE row, M_SIZE_TYPE col) {
+	int coefficient = 1;
+	for (int l = 0; l < levels && coefficient != 0; ++l) {
+		const int quadrant = (int) (((row & 1) << 1) | (col & 1));
+		coefficient *= table[(path % STRASSEN_PRODUCTS) * productStride + quadrant * quadrantStride];
+		path /= STRASSEN_PRODUCTS;
+		row >>= 1;
+		col >>= 1;
+	}
+	return coefficient;
+}
+
+static int distLeft(const int path, const int levels, const M_SIZE_TYPE& row, const M_SIZE_TYPE& col) {
+	return distCoefficient(&STRASSEN_LEFT[0][0], 4, 1, path, levels, row, col);
+}
+
+static int distRight(const int path, const int levels, const M_SIZE_TYPE& row, const M_SIZE_TYPE& col) {
+	return distCoefficient(&STRASSEN_RIGHT[0][0], 4, 1, path, levels, row, col);
+}
+
+static int distSign(const int path, const int levels, const M_SIZE_TYPE& row, const M_SIZE_TYPE& col) {
+	return distCoefficient(&STRASSEN_SIGNS[0][0], 1, STRASSEN_PRODUCTS, path, levels, row, col);
+}
+
+/**
+*  @brief  Erste Zeile je Blockzeile, die Prozess rank haelt.
+*/
+static M_SIZE_TYPE distFirstRow(const DistStrassenLayout& layout, const int rank) {
+	return layout.h * rank / layout.size;
+}
+
+/**
+*  @brief  Prueft Prozessanzahl und Dimension und berechnet die Verteilung.
+*  @param  layout  Ergebnis.
+*  @param  levels  Verteilte Ebenen L (1 oder 2).
+*  @param       n  Dimension von A, B und C.
+*  @param   error  Grund, falls Prozessanzahl oder Dimension nicht passen.
+*  @return true bei Erfolg.
+*/
+bool distStrassenLayout(DistStrassenLayout& layout, const int levels, const M_SIZE_TYPE& n, std::string& error) {
+	MPI_Comm_rank(MPI_COMM_WORLD, &layout.rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &layout.size);
+	layout.levels = levels;
+	layout.blocks = (M_SIZE_TYPE) 1 << levels;
+	layout.h = n / layout.blocks;
+	int products = 1;
+	for (int l = 0; l < levels; ++l) {
+		products *= STRASSEN_PRODUCTS;
+	}
+	std::ostringstream message;
+	if (layout.size != products) {
+		message << levels << " distributed Strassen level(s) need " << products << " processes, not " << layout.size;
+	}
+	else if (n % layout.blocks != 0 || layout.h < (M_SIZE_TYPE) layout.size || (double) layout.h * layout.h > INT_MAX) {
+		message << "Dimension " << n << " must be a multiple of " << layout.blocks << " with blocks of at least " << layout.size
+				<< " rows and at most " << INT_MAX << " elements";
+	}
+	if (!message.str().empty()) {
+		error = message.str();
+		return false;
+	}
+	layout.first = distFirstRow(layout, layout.rank);
+	layout.rows = distFirstRow(layout, layout.rank + 1) - layout.first;
+	return true;
+}
+
+/**
+*  @brief  Verteilter Strassen (siehe Distributed.h). Aufruf durch alle
+*  Prozesse. A, B und C sind die Streifen des Prozesses (blocks * rows
+*  Zeilen, n Spalten); Blockzeile R beginnt bei Zeile R * rows.
+*  @param  layout  Verteilung (distStrassenLayout).
+*  @param       C  Streifen von C (Ergebnis).
+*  @param       A  Streifen von A.
+*  @param       B  Streifen von B.
+*  @param   times  Ergebnis: Zeiten der Phasen dieses Prozesses.
+*/
+void distStrassenMultiply(const DistStrassenLayout& layout, const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, DistStrassenTimes& times) {
+	const int P = layout.size;
+	const M_SIZE_TYPE h = layout.h;
+	const M_SIZE_TYPE chunk = layout.rows * h;
+
+	// Eigene Zeilen aller Teilprodukte: Prozess q erhaelt Abschnitt q (Laenge chunk)
+	// und legt ihn ab Zeile distFirstRow(q) seines Operanden ab
+	std::vector<int> ownCounts(P), ownDispls(P), fullCounts(P), fullDispls(P);
+	for (int q = 0; q < P; ++q) {
+		ownCounts[q] = (int) chunk;
+		ownDispls[q] = (int) (q * chunk);
+		fullCounts[q] = (int) ((distFirstRow(layout, q + 1) - distFirstRow(layout, q)) * h);
+		fullDispls[q] = (int) (distFirstRow(layout, q) * h);
+	}
+	MatrixStorage left(P * chunk), right(P * chunk), S(h * h), T(h * h), M(h * h);
+
+	// Operanden: eigene Zeilen von S_p und T_p fuer alle p
+	tick_count t0 = tick_count::now();
+	for (int p = 0; p < P; ++p) {
+		DistCombinePBody sumA(MatrixView(&left[p * chunk], h, 0));
+		DistCombinePBody sumB(MatrixView(&right[p * chunk], h, 0));
+		for (M_SIZE_TYPE R = 0; R < layout.blocks; ++R) {
+			for (M_SIZE_TYPE c = 0; c < layout.blocks; ++c) {
+				const int a = distLeft(p, layout.levels, R, c);
+				const int b = distRight(p, layout.levels, R, c);
+				if (a != 0) {
+					sumA.add(A.block(R * layout.rows, c * h), a);
+				}
+				if (b != 0) {
+					sumB.add(B.block(R * layout.rows, c * h), b);
+				}
+			}
+		}
+		matrixCombinePar(sumA, layout.rows, h, sumA.terms + 1, sumA.terms - 1);
+		matrixCombinePar(sumB, layout.rows, h, sumB.terms + 1, sumB.terms - 1);
+	}
+	tick_count t1 = tick_count::now();
+	times.form = (t1 - t0).seconds();
+
+	MPI_Alltoallv(&left[0], &ownCounts[0], &ownDispls[0], M_VAL_MPI_TYPE, &S[0], &fullCounts[0], &fullDispls[0], M_VAL_MPI_TYPE, MPI_COMM_WORLD);
+	MPI_Alltoallv(&right[0], &ownCounts[0], &ownDispls[0], M_VAL_MPI_TYPE, &T[0], &fullCounts[0], &fullDispls[0], M_VAL_MPI_TYPE, MPI_COMM_WORLD);
+	t0 = tick_count::now();
+	times.exchange = (t0 - t1).seconds();
+
+	// M_p = S_p * T_p mit allen Threads dieses Prozesses
+	gemm('N', 'N', h, h, h, (M_VAL_TYPE) 1, &S[0], h, &T[0], h, (M_VAL_TYPE) 0, &M[0], h);
+	t1 = tick_count::now();
+	times.multiply = (t1 - t0).seconds();
+
+	// Zeilen von M_p an ihre Besitzer (umgekehrte Richtung, Puffer left)
+	MPI_Alltoallv(&M[0], &fullCounts[0], &fullDispls[0], M_VAL_MPI_TYPE, &left[0], &ownCounts[0], &ownDispls[0], M_VAL_MPI_TYPE, MPI_COMM_WORLD);
+	t0 = tick_count::now();
+	times.exchange += (t0 - t1).seconds();
+
+	// Eigene Zeilen von C_Rc = sum_p sign * M_p
+	for (M_SIZE_TYPE R = 0; R < layout.blocks; ++R) {
+		for (M_SIZE_TYPE c = 0; c < layout.blocks; ++c) {
+			DistCombinePBody sum(C.block(R * layout.rows, c * h));
+			for (int p = 0; p < P; ++p) {
+				const int sign = distSign(p, layout.levels, R, c);
+				if (sign != 0) {
+					sum.add(ConstMatrixView(&left[p * chunk], h, 0), sign);
+				}
+			}
+			matrixCombinePar(sum, layout.rows, h, sum.terms + 1, sum.terms - 1);
+		}
+	}
+	t1 = tick_count::now();
+	times.combine = (t1 - t0).seconds();
+}
+
+/**
+*  @brief  Sammelt zeilenweise Werte der Streifen aller Prozesse und ordnet
+*  sie nach der globalen Zeile (Blockzeile R, Zeile first + i).
+*  @param   local  Werte der eigenen Streifenzeilen (width je Zeile).
+*  @param     all  Ergebnis: Werte aller n Zeilen.
+*  @param   width  Werte je Zeile.
+*/
+template <typename Value>
+static void distGatherRows(const DistStrassenLayout& layout, const Value* local, Value* all, const int width, MPI_Datatype type) {
+	const int P = layout.size;
+	std::vector<int> counts(P), displs(P);
+	int offset = 0;
+	for (int q = 0; q < P; ++q) {
+		counts[q] = (int) (layout.blocks * (distFirstRow(layout, q + 1) - distFirstRow(layout, q))) * width;
+		displs[q] = offset;
+		offset += counts[q];
+	}
+	std::vector<Value> gathered(offset);
+	MPI_Allgatherv(local, counts[layout.rank], type, &gathered[0], &counts[0], &displs[0], type, MPI_COMM_WORLD);
+	for (int q = 0; q < P; ++q) {
+		const M_SIZE_TYPE first = distFirstRow(layout, q);
+		const M_SIZE_TYPE rows = distFirstRow(layout, q + 1) - first;
+		const Value* source = &gathered[displs[q]];
+		for (M_SIZE_TYPE R = 0; R < layout.blocks; ++R) {
+			for (M_SIZE_TYPE i = 0; i < rows; ++i, source += width) {
+				std::copy(source, source + width, all + (R * layout.h + first + i) * width);
+			}
+		}
+	}
+}
+
+/**
+*  @brief  Freivalds-Pruefung (siehe Verify.h) auf den Streifen: Die Streifen
+*  enthalten vollstaendige Zeilen, B x wird lokal gebildet und per
+*  MPI_Allgatherv auf alle Prozesse verteilt. Aufruf durch alle Prozesse.
+*  @param  vectors  Anzahl der Zufallsvektoren.
+*  @return Ergebnis mit der ungenauesten Zeile (vollstaendig nur auf Rang 0).
+*/
+VerifyResult distStrassenVerify(const DistStrassenLayout& layout, const ConstMatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const int vectors) {
+	const int v = vectors < 1 ? 1 : vectors > VERIFY_MAX_VECTORS ? VERIFY_MAX_VECTORS : vectors;
+	const M_SIZE_TYPE n = layout.h * layout.blocks;
+	const M_SIZE_TYPE local = layout.blocks * layout.rows;
+	std::vector<VerifyValue> x(n * v), y(local * v), yAll(n * v), z(local * v), w(local * v);
+	verifySigns(&x[0], n, v);
+
+#if M_VAL_IS_INTEGER
+	verifyMatVec(B, local, n, v, &x[0], &y[0]);
+	distGatherRows(layout, &y[0], &yAll[0], v, VERIFY_MPI_TYPE);
+	verifyMatVec(A, local, n, v, &yAll[0], &z[0]);
+	const double* absZ = NULL;
+	const double normwise = 0;
+#else
+	// Schranke: |A| (|B| 1) und normweise ueber die verteilten Ebenen (lokal klassische GEMM)
+	std::vector<double> ones(n, 1.0), absY(local), absYAll(n), absZValues(local), maxB(local), maxA(local);
+	verifyMatVec(B, local, n, v, &x[0], &y[0], &ones[0], &absY[0], &maxB[0]);
+	distGatherRows(layout, &y[0], &yAll[0], v, VERIFY_MPI_TYPE);
+	distGatherRows(layout, &absY[0], &absYAll[0], 1, MPI_DOUBLE);
+	verifyMatVec(A, local, n, v, &yAll[0], &z[0], &absYAll[0], &absZValues[0], &maxA[0]);
+	const double* absZ = &absZValues[0];
+	double norms[2] = { *std::max_element(maxA.begin(), maxA.end()), *std::max_element(maxB.begin(), maxB.end()) };
+	MPI_Allreduce(MPI_IN_PLACE, norms, 2, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+	const double normwise = verifyNormwise(norms[0], norms[1], n, n, VARIANT_STRASSEN, layout.levels);
+#endif
+	verifyMatVec(C, local, n, v, &x[0], &w[0]);
+
+	VerifyResult result = verifyResiduals(&w[0], &z[0], absZ, normwise, local, n, v);
+	result.row = result.row / layout.rows * layout.h + layout.first + result.row % layout.rows;
+	return distVerifyWorst(result, MPI_COMM_WORLD);
+}
+
+} // namespace M_VAL_NAMESPACE
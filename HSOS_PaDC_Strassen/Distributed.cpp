@@ -0,0 +1,136 @@
+//============================================================================
+// Name        : Distributed.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Distributed.h"
+#include <limits>
+#include <math.h>
+#include <sstream>
+#include <vector>
+
+namespace M_VAL_NAMESPACE {
+
+/**
+*  @brief  Bildet das Prozessgitter q x q x c aus MPI_COMM_WORLD.
+*  @param    grid  Ergebnis.
+*  @param  layers  Anzahl der Ebenen c (q muss durch c teilbar sein).
+*  @param   error  Grund, falls die Prozessanzahl nicht passt.
+*  @return true bei Erfolg.
+*/
+bool distGridCreate(DistGrid& grid, const int layers, std::string& error) {
+	MPI_Comm_rank(MPI_COMM_WORLD, &grid.rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &grid.size);
+	grid.layers = layers;
+	grid.q = (int) (sqrt((double) grid.size / layers) + 0.5);
+	if (grid.q == 0 || grid.q * grid.q * layers != grid.size || grid.q % layers != 0) {
+		std::ostringstream message;
+		message << grid.size << " processes do not form a q x q x " << layers << " grid with q divisible by " << layers;
+		error = message.str();
+		return false;
+	}
+	grid.layer = grid.rank / (grid.q * grid.q);
+	grid.row = grid.rank / grid.q % grid.q;
+	grid.col = grid.rank % grid.q;
+	MPI_Comm_split(MPI_COMM_WORLD, grid.layer * grid.q + grid.row, grid.col, &grid.rowComm);
+	MPI_Comm_split(MPI_COMM_WORLD, grid.layer * grid.q + grid.col, grid.row, &grid.colComm);
+	MPI_Comm_split(MPI_COMM_WORLD, grid.row * grid.q + grid.col, grid.layer, &grid.depthComm);
+	return true;
+}
+
+void distGridFree(DistGrid& grid) {
+	MPI_Comm_free(&grid.rowComm);
+	MPI_Comm_free(&grid.colComm);
+	MPI_Comm_free(&grid.depthComm);
+}
+
+/**
+*  @brief  Verhaeltnis Residuum / Schranke (zum Vergleich der Ergebnisse).
+*/
+static double verifyRatio(const VerifyResult& result) {
+	return result.bound > 0 ? result.residual / result.bound : result.residual > 0 ? std::numeric_limits<double>::infinity() : 0;
+}
+
+/**
+*  @brief  Freivalds-Pruefung (siehe Verify.h) auf der 2D-Verteilung einer
+*  Ebene: Die Matrix-Vektor-Produkte werden je Block berechnet und in den
+*  Prozesszeilen summiert, (B x)_j gelangt per Broadcast vom Diagonalprozess
+*  (j, j) in Spalte j. Aufruf durch alle Prozesse einer Ebene.
+*  @param        C  Block C_ij.
+*  @param        A  Block A_ij.
+*  @param        B  Block B_ij.
+*  @param        b  Dimension der Bloecke.
+*  @param  vectors  Anzahl der Zufallsvektoren.
+*  @return Ergebnis mit der ungenauesten Zeile (vollstaendig nur auf Rang 0).
+*/
+VerifyResult distVerify(const DistGrid& grid, const ConstMatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& b, const int vectors) {
+	const int v = vectors < 1 ? 1 : vectors > VERIFY_MAX_VECTORS ? VERIFY_MAX_VECTORS : vectors;
+	const M_SIZE_TYPE n = b * grid.q;
+	const int count = (int) b * v;
+	std::vector<VerifyValue> x(n * v), y(b * v), z(b * v), w(b * v), part(b * v);
+	verifySigns(&x[0], n, v);
+	const VerifyValue* xj = &x[grid.col * b * v];
+
+#if M_VAL_IS_INTEGER
+	verifyMatVec(B, b, b, v, xj, &part[0]);
+	MPI_Allreduce(&part[0], &y[0], count, VERIFY_MPI_TYPE, MPI_SUM, grid.rowComm);
+	MPI_Bcast(&y[0], count, VERIFY_MPI_TYPE, grid.col, grid.colComm);
+	verifyMatVec(A, b, b, v, &y[0], &part[0]);
+	MPI_Allreduce(&part[0], &z[0], count, VERIFY_MPI_TYPE, MPI_SUM, grid.rowComm);
+	const double* absZ = NULL;
+#else
+	// Schranke: |A| (|B| 1), summiert wie die Produkte
+	std::vector<double> ones(b, 1.0), absPart(b), absY(b), absZValues(b);
+	verifyMatVec(B, b, b, v, xj, &part[0], &ones[0], &absPart[0]);
+	MPI_Allreduce(&part[0], &y[0], count, VERIFY_MPI_TYPE, MPI_SUM, grid.rowComm);
+	MPI_Allreduce(&absPart[0], &absY[0], (int) b, MPI_DOUBLE, MPI_SUM, grid.rowComm);
+	MPI_Bcast(&y[0], count, VERIFY_MPI_TYPE, grid.col, grid.colComm);
+	MPI_Bcast(&absY[0], (int) b, MPI_DOUBLE, grid.col, grid.colComm);
+	verifyMatVec(A, b, b, v, &y[0], &part[0], &absY[0], &absPart[0]);
+	MPI_Allreduce(&part[0], &z[0], count, VERIFY_MPI_TYPE, MPI_SUM, grid.rowComm);
+	MPI_Allreduce(&absPart[0], &absZValues[0], (int) b, MPI_DOUBLE, MPI_SUM, grid.rowComm);
+	const double* absZ = &absZValues[0];
+#endif
+	verifyMatVec(C, b, b, v, xj, &part[0]);
+	MPI_Allreduce(&part[0], &w[0], count, VERIFY_MPI_TYPE, MPI_SUM, grid.rowComm);
+
+	// SUMMA rechnet klassisch: komponentenweise Schranke genuegt
+	VerifyResult result = verifyResiduals(&w[0], &z[0], absZ, 0, b, n, v);
+	result.row += grid.row * b;
+
+	// Je Prozesszeile ein Ergebnis: in Spalte 0 bei Rang 0 sammeln
+	return distVerifyWorst(result, grid.colComm);
+}
+
+/**
+*  @brief  Sammelt die Ergebnisse der Prozesse eines Kommunikators und
+*  waehlt die ungenaueste Zeile. Aufruf durch alle Prozesse von comm.
+*  @param  result  Ergebnis dieses Prozesses (Zeile global).
+*  @param    comm  Kommunikator.
+*  @return Ungenauestes Ergebnis auf Rang 0 von comm, sonst result.
+*/
+VerifyResult distVerifyWorst(const VerifyResult& result, MPI_Comm comm) {
+	int rank, size;
+	MPI_Comm_rank(comm, &rank);
+	MPI_Comm_size(comm, &size);
+	double mine[4] = { result.ok ? 1.0 : 0.0, (double) result.row, result.residual, result.bound };
+	std::vector<double> all(4 * size);
+	MPI_Gather(mine, 4, MPI_DOUBLE, &all[0], 4, MPI_DOUBLE, 0, comm);
+	VerifyResult worst = result;
+	if (rank == 0) {
+		for (int i = 0; i < size; ++i) {
+			const VerifyResult other = { all[4 * i] != 0, (M_SIZE_TYPE) all[4 * i + 1], all[4 * i + 2], all[4 * i + 3] };
+			if ((!other.ok && worst.ok) || (other.ok == worst.ok && verifyRatio(other) > verifyRatio(worst))) {
+				worst = other;
+			}
+		}
+	}
+	return worst;
+}
+
+} // namespace M_VAL_NAMESPACE
@@ -0,0 +1,141 @@
+//============================================================================
+// Name        : Distributed.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef DISTRIBUTED_H_
+#define DISTRIBUTED_H_
+
+#include "Definitions.h"
+#include "Matrix.h"
+#include "Verify.h"
+#include <mpi.h>
+#include <string>
+
+/*
+ * Verteilte Multiplikation (eigenes Programm HSOS_PaDC_Strassen_MPI, make
+ * mpi): P = q * q * c Prozesse bilden ein Gitter aus c Ebenen mit je q x q
+ * Prozessen. Prozess (i, j) einer Ebene haelt die Bloecke A_ij, B_ij und
+ * C_ij (n/q x n/q, zeilenweise); die Eingaben liegen zunaechst nur auf
+ * Ebene 0. 2.5D-SUMMA (Solomonik, Demmel 2011): A_ij und B_ij werden auf alle
+ * Ebenen repliziert, Ebene l rechnet die Schritte s = l q/c .. (l+1) q/c - 1
+ *
+ *     C_ij += A_is * B_sj   (A_is per Broadcast in Zeile i, B_sj in Spalte j)
+ *
+ * und die Teilsummen werden entlang der Ebenen nach Ebene 0 reduziert. Mit
+ * c = 1 ist das die 2D-SUMMA. Die Broadcasts des naechsten Schritts laufen
+ * nicht-blockierend (MPI_Ibcast, doppelte Puffer) waehrend des lokalen
+ * Produkts, das ueber gemm (Blas.h) die gekachelte GEMM bzw. den Strassen-
+ * Algorithmus mit allen tbb-Threads des Prozesses nutzt. Das Produkt wird
+ * dazu in Zeilenstreifen gerechnet, zwischen denen MPI_Testall den
+ * Fortschritt der Kommunikation anstoesst. Die MPI-Aufrufe erfolgen nur aus
+ * dem Hauptthread (MPI_THREAD_FUNNELED).
+ *
+ * Verteilter Strassen (-D L, P = 7^L Prozesse): Die obersten L Ebenen werden
+ * ueber die Prozesse aufgefaltet, Prozess p rechnet das Produkt p der 7^L
+ * Teilprodukte (Dimension h = n / 2^L) mit gemm, also der vorhandenen
+ * Rekursion mit allen tbb-Threads des Prozesses. Jeder Prozess haelt von
+ * jeder der 2^L Blockzeilen die Zeilen h r/P .. h (r+1)/P - 1 ueber die ganze
+ * Breite ("Streifen"). Die Operanden S_p und T_p sind Linearkombinationen
+ * der Bloecke mit den Koeffizienten aus STRASSEN_LEFT/RIGHT (Produkt ueber
+ * die Ebenen); jeder Prozess bildet seine Zeilen davon fuer alle p lokal, ein
+ * MPI_Alltoallv setzt S_p und T_p auf Prozess p zusammen. Ein zweites
+ * MPI_Alltoallv verteilt die Zeilen von M_p an ihre Besitzer zurueck, die
+ * ihre Zeilen von C mit STRASSEN_SIGNS lokal kombinieren. Gegenueber SUMMA
+ * sinken die Multiplikationen auf (7/8)^L, dafuer werden je Richtung etwa
+ * (7/4)^L n^2 Elemente ausgetauscht.
+ */
+
+#define SUMMA_PANELS 4					// Zeilenstreifen je lokalem Produkt (Fortschritt der Broadcasts)
+#define DIST_STRASSEN_TERMS 16			// Max. Summanden einer Kombination (4^L fuer C bei L = 2)
+
+namespace M_VAL_NAMESPACE {
+
+#if M_VAL_TYPE_ID == M_TYPE_FLOAT
+#define M_VAL_MPI_TYPE MPI_FLOAT
+#elif M_VAL_TYPE_ID == M_TYPE_DOUBLE
+#define M_VAL_MPI_TYPE MPI_DOUBLE
+#elif M_VAL_TYPE_ID == M_TYPE_INT32
+#define M_VAL_MPI_TYPE MPI_INT32_T
+#else
+#define M_VAL_MPI_TYPE MPI_INT64_T
+#endif
+
+#if M_VAL_IS_INTEGER
+#define VERIFY_MPI_TYPE M_VAL_MPI_TYPE	// Datentyp von VerifyValue
+#else
+#define VERIFY_MPI_TYPE MPI_DOUBLE
+#endif
+
+/**
+*  @brief  Prozessgitter q x q x c mit den Kommunikatoren je Zeile, Spalte
+*  und Ebene. Rang = (layer * q + row) * q + col, Rang 0 ist (0, 0, 0).
+*/
+struct DistGrid {
+	int rank;							// Rang in MPI_COMM_WORLD
+	int size;							// Anzahl der Prozesse
+	int q;								// Prozesse je Zeile bzw. Spalte einer Ebene
+	int layers;							// Ebenen c
+	int row;							// Zeile i im Gitter
+	int col;							// Spalte j im Gitter
+	int layer;							// Ebene l
+	MPI_Comm rowComm;					// Prozesse (row, *, layer), Rang = Spalte
+	MPI_Comm colComm;					// Prozesse (*, col, layer), Rang = Zeile
+	MPI_Comm depthComm;					// Prozesse (row, col, *), Rang = Ebene
+};
+
+/**
+*  @brief  Zeiten eines verteilten Produkts (Sekunden, je Prozess).
+*/
+struct DistTimes {
+	double compute;						// Lokale Produkte und Additionen
+	double wait;						// Warten auf Kommunikation
+};
+
+/**
+*  @brief  Verteilung des verteilten Strassen auf P = 7^L Prozesse.
+*/
+struct DistStrassenLayout {
+	int rank;							// Rang in MPI_COMM_WORLD (= Teilprodukt)
+	int size;							// Anzahl der Prozesse P
+	int levels;							// Verteilte Ebenen L
+	M_SIZE_TYPE blocks;					// Bloecke je Zeile bzw. Spalte (2^L)
+	M_SIZE_TYPE h;						// Dimension der Bloecke und Teilprodukte (n / 2^L)
+	M_SIZE_TYPE first;					// Erste eigene Zeile je Blockzeile
+	M_SIZE_TYPE rows;					// Eigene Zeilen je Blockzeile (Streifen: blocks * rows Zeilen)
+};
+
+/**
+*  @brief  Zeiten des verteilten Strassen (Sekunden, je Prozess).
+*/
+struct DistStrassenTimes {
+	double form;						// Operanden S_p, T_p bilden (lokale Zeilen)
+	double exchange;					// Beide MPI_Alltoallv
+	double multiply;					// Teilprodukt M_p
+	double combine;						// Eigene Zeilen von C aus den M_p
+};
+
+bool distGridCreate(DistGrid& grid, const int layers, std::string& error);
+
+void distGridFree(DistGrid& grid);
+
+void summaMultiply(const DistGrid& grid, const MatrixView& C, const MatrixView& A, const MatrixView& B, const M_SIZE_TYPE& b, DistTimes& times);
+
+VerifyResult distVerify(const DistGrid& grid, const ConstMatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& b, const int vectors);
+
+VerifyResult distVerifyWorst(const VerifyResult& result, MPI_Comm comm);
+
+bool distStrassenLayout(DistStrassenLayout& layout, const int levels, const M_SIZE_TYPE& n, std::string& error);
+
+void distStrassenMultiply(const DistStrassenLayout& layout, const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, DistStrassenTimes& times);
+
+VerifyResult distStrassenVerify(const DistStrassenLayout& layout, const ConstMatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const int vectors);
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
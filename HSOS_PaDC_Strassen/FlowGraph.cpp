@@ -0,0 +1,207 @@
+//============================================================================
+// Name        : FlowGraph.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "FlowGraph.h"
+#include "Strassen.h"
+#include "Workspace.h"
+#include <tbb/atomic.h>
+#include <tbb/flow_graph.h>
+#include <vector>
+
+namespace M_VAL_NAMESPACE {
+
+#define FLOW_OPERANDS 2					// Operandensummen je laufendem Produkt
+#define FLOW_MIN_SIZE 512				// Darunter rechnet die Task-Version weiter (Overhead je Graph)
+
+using namespace tbb::flow;
+
+/**
+*  @brief  Zustand einer Rekursionsebene des Graphen: Quadranten von A, B
+*  und C sowie die Produkte. Ein Produkt belegt seinen Speicher erst, wenn
+*  sein Knoten startet, und gibt ihn nach der letzten Akkumulation frei
+*  (pending). accumulated wird nur vom (seriellen) Knoten des jeweiligen
+*  Quadranten veraendert.
+*/
+struct FlowLevel {
+	std::vector<ConstMatrixView> a;
+	std::vector<ConstMatrixView> b;
+	std::vector<MatrixView> quadrant;
+	std::vector<MatrixView> product;
+	HeapFrame* productFrame[STRASSEN_PRODUCTS];
+	tbb::atomic<int> pending[STRASSEN_PRODUCTS];
+	M_SIZE_TYPE n;
+	M_SIZE_TYPE tile;
+	int accumulated[4];
+};
+
+/**
+*  @brief  Bildet einen Operanden aus bis zu zwei Quadranten. Ein einzelner
+*  Quadrant (Koeffizient 1) wird ohne Kopie direkt verwendet, sonst wird die
+*  Summe bzw. Differenz im frame belegt.
+*  @param         frame  Frame des Produktknotens.
+*  @param             Q  Quadranten (11, 12, 21, 22).
+*  @param  coefficients  Koeffizienten der Quadranten (siehe STRASSEN_LEFT, STRASSEN_RIGHT).
+*  @param             n  Dimension der Quadranten.
+*  @param          tile  Kachelgroesse im Morton-Layout (0: zeilenweise).
+*/
+static ConstMatrixView flowOperand(WorkspaceFrame& frame, const ConstMatrixView Q[4], const int coefficients[4], const M_SIZE_TYPE& n, const M_SIZE_TYPE& tile) {
+	int first = -1;
+	int second = -1;
+	for (int i = 0; i < 4; ++i) {
+		if (coefficients[i] != 0 && first < 0) {
+			first = i;
+		}
+		else if (coefficients[i] != 0) {
+			second = i;
+		}
+	}
+	if (second < 0) {
+		return Q[first];
+	}
+	const MatrixView T = frame.matrix(n, tile);
+	if (coefficients[first] < 0) {
+		matrixSubPar(T, Q[second], Q[first], n);
+	}
+	else if (coefficients[second] < 0) {
+		matrixSubPar(T, Q[first], Q[second], n);
+	}
+	else {
+		matrixAddPar(T, Q[first], Q[second], n);
+	}
+	return T;
+}
+
+/**
+*  @brief  Knoten: bildet die Operanden eines Produkts, belegt das Produkt
+*  (Heap, lebt bis zur letzten Akkumulation) und berechnet es rekursiv. Die
+*  Operanden werden am Ende des Knotens wieder freigegeben.
+*/
+struct FlowMultiplyBody {
+	FlowLevel* level;
+
+	FlowMultiplyBody(FlowLevel* __level) : level(__level) { }
+
+	int operator()(const int p) const {
+		TRACE_TASK_START(level->n, false);
+		TRACE_SCOPE(TRACE_TASK, level->n, 0, 0);
+		WorkspaceFrame frame;
+		const ConstMatrixView left = flowOperand(frame, &level->a[0], STRASSEN_LEFT[p], level->n, level->tile);
+		const ConstMatrixView right = flowOperand(frame, &level->b[0], STRASSEN_RIGHT[p], level->n, level->tile);
+		level->productFrame[p] = new HeapFrame();
+		level->product[p] = level->productFrame[p]->matrix(level->n, level->tile);
+		strassenFlowGraph(level->product[p], left, right, level->n);
+		return p;
+	}
+};
+
+/**
+*  @brief  Knoten (seriell je Quadrant): addiert fertige Produkte in der
+*  Reihenfolge ihres Eintreffens in den Quadranten. Die letzte Akkumulation
+*  eines Produkts gibt es frei.
+*/
+struct FlowAccumulateBody {
+	FlowLevel* level;
+	int q;
+
+	FlowAccumulateBody(FlowLevel* __level, const int __q) : level(__level), q(__q) { }
+
+	continue_msg operator()(const int p) const {
+		const int sign = STRASSEN_SIGNS[q][p];
+		if (sign != 0) {
+			const bool first = level->accumulated[q] == 0;
+			matrixCombinePar(MatrixAccumulatePBody(level->quadrant[q], level->product[p], sign, first), level->n, level->n, first ? 2 : 3, first ? 0 : 1);
+			++level->accumulated[q];
+			if (--level->pending[p] == 0) {
+				delete level->productFrame[p];
+			}
+		}
+		return continue_msg();
+	}
+};
+
+/**
+*  @brief  Berechnet die Groesse des Workspaces je Thread: Ein laufendes
+*  Produkt des Graphen belegt nur seine (hoechstens zwei) Operanden im
+*  Workspace, die Produkte liegen auf dem Heap. Den Bedarf bestimmen daher
+*  die Task-Version unterhalb von FLOW_MIN_SIZE und strassenRecursive
+*  unterhalb von CUT_OFF_TASK.
+*  @param  n  Matrixdimension (NxN).
+*  @return Benoetigte Elemente je Thread.
+*/
+M_SIZE_TYPE flowGraphWorkspaceElements(const M_SIZE_TYPE& n) {
+	return variantWorkspaceElements(n, SEQ_TEMPORARIES, TASK_TEMPORARIES > FLOW_OPERANDS ? TASK_TEMPORARIES : FLOW_OPERANDS);
+}
+
+/**
+*  @brief  Multipliziert zwei Matrizen mit einem Abhaengigkeitsgraphen je
+*  Rekursionsebene (tbb::flow): Jedes Produkt ist ein Knoten, der seine
+*  Operanden bildet und rekursiv multipliziert; jede Akkumulation in einen
+*  Quadranten von C ist ein Knoten und startet, sobald ein Produkt vorliegt.
+*  Operanden und Produkte werden erst im Knoten belegt, der Speicher einer
+*  Ebene waechst also mit den gleichzeitig laufenden Produkten.
+*  Unterhalb von FLOW_MIN_SIZE uebernimmt die Task-Version.
+*  FLOW_PRODUCTS_IN_FLIGHT (> 0) begrenzt die gleichzeitig berechneten
+*  Produkte je Graph und damit Parallelitaet und Zwischenmatrizen.
+*  @param  C  Matrix C (Ergebnismatrix, wird ueberschrieben).
+*  @param  A  Matrix A.
+*  @param  B  Matrix B.
+*  @param  n  Matrixdimension (NxN).
+*/
+void strassenFlowGraph(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
+	if (n <= CUT_OFF) {
+		strassenLeaf(C, A, B, n);
+		return;
+	}
+	if (n <= CUT_OFF_TASK) {
+		strassenRecursive(C, A, B, n);
+		return;
+	}
+	if (n < FLOW_MIN_SIZE) {
+		tbb::task::spawn_root_and_wait(*new (tbb::task::allocate_root()) Strassen(C, A, B, n));
+		return;
+	}
+	// Devide & Conquer (Quadranten als Sichten, ohne Kopie)
+	FlowLevel level;
+	level.n = n >> 1;
+	level.tile = C.tile;
+	for (int q = 0; q < 4; ++q) {
+		level.a.push_back(A.quadrant(q >> 1, q & 1));
+		level.b.push_back(B.quadrant(q >> 1, q & 1));
+		level.quadrant.push_back(C.quadrant(q >> 1, q & 1));
+		level.accumulated[q] = 0;
+	}
+	for (int p = 0; p < STRASSEN_PRODUCTS; ++p) {
+		level.product.push_back(MatrixView(NULL, 0, 0));
+		level.productFrame[p] = NULL;
+		level.pending[p] = 0;
+		for (int q = 0; q < 4; ++q) {
+			level.pending[p] += STRASSEN_SIGNS[q][p] != 0 ? 1 : 0;
+		}
+	}
+
+	// Graph: Multiplikation (Operanden, Produkt) -> Quadranten
+	graph g;
+	std::vector<function_node<int, continue_msg>*> accumulateNodes;
+	function_node<int, int> multiply(g, FLOW_PRODUCTS_IN_FLIGHT > 0 ? (size_t) FLOW_PRODUCTS_IN_FLIGHT : (size_t) unlimited, FlowMultiplyBody(&level));
+	for (int q = 0; q < 4; ++q) {
+		accumulateNodes.push_back(new function_node<int, continue_msg>(g, serial, FlowAccumulateBody(&level, q)));
+		make_edge(multiply, *accumulateNodes.back());
+	}
+	for (int p = 0; p < STRASSEN_PRODUCTS; ++p) {
+		multiply.try_put(p);
+	}
+	g.wait_for_all();
+
+	for (size_t i = 0; i < accumulateNodes.size(); ++i) {
+		delete accumulateNodes[i];
+	}
+}
+
+} // namespace M_VAL_NAMESPACE
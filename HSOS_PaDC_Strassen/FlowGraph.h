@@ -0,0 +1,25 @@
+//============================================================================
+// Name        : FlowGraph.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef FLOWGRAPH_H_
+#define FLOWGRAPH_H_
+
+#include "Definitions.h"
+#include "Matrix.h"
+
+namespace M_VAL_NAMESPACE {
+
+M_SIZE_TYPE flowGraphWorkspaceElements(const M_SIZE_TYPE& n);
+
+void strassenFlowGraph(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n);
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
@@ -0,0 +1,151 @@
+//============================================================================
+// Name        : Gemm.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Gemm.h"
+#include "Kernel.h"
+#include "Workspace.h"
+#include <tbb/blocked_range.h>
+#include <tbb/blocked_range2d.h>
+#include <tbb/parallel_for.h>
+
+namespace M_VAL_NAMESPACE {
+
+/**
+*  @brief  Rundet x auf ein Vielfaches von r auf.
+*/
+static inline M_SIZE_TYPE roundUp(const M_SIZE_TYPE& x, const M_SIZE_TYPE& r) {
+	return (x + r - 1) / r * r;
+}
+
+static inline M_SIZE_TYPE minSize(const M_SIZE_TYPE& a, const M_SIZE_TYPE& b) {
+	return a < b ? a : b;
+}
+
+/**
+*  @brief  Berechnet die Groesse der Packpuffer eines Threads fuer gemmSeq
+*  (ein A-Block und ein B-Panel).
+*  @return Benoetigte Elemente.
+*/
+M_SIZE_TYPE gemmPackElements(const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	const KernelInfo& K = activeKernel();
+	const M_SIZE_TYPE kc = minSize(k, GEMM_KC);
+	return roundUp(minSize(m, GEMM_MC), K.mr) * kc + roundUp(minSize(n, GEMM_NC), K.nr) * kc;
+}
+
+/**
+*  @brief  Funktionsobjekt zum parallelisierten Packen eines B-Panels
+*  (Bereich in Einheiten von NR-Streifen).
+*/
+struct GemmPackBPBody {
+	M_VAL_TYPE* bp;						// Gepacktes Panel (kc x nc)
+	ConstMatrixView B;					// Panel in B (ab Zeile pc, Spalte jc)
+	const M_SIZE_TYPE kc;
+	const M_SIZE_TYPE nc;
+
+	GemmPackBPBody(M_VAL_TYPE* __bp, const ConstMatrixView& __B, const M_SIZE_TYPE& __kc, const M_SIZE_TYPE& __nc) : bp(__bp), B(__B), kc(__kc), nc(__nc) { }
+
+	void operator()(const tbb::blocked_range<M_SIZE_TYPE>& range) const {
+		const M_SIZE_TYPE nr = activeKernel().nr;
+		const M_SIZE_TYPE j0 = range.begin() * nr;
+		const M_SIZE_TYPE j1 = minSize(range.end() * nr, nc);
+		kernelPackB(bp + j0 * kc, B.block(0, j0), kc, j1 - j0);
+	}
+};
+
+/**
+*  @brief  Funktionsobjekt fuer die Makrokacheln eines B-Panels: Zeilen in
+*  Einheiten von GEMM_MC, Spalten in Einheiten von NR-Streifen. Jeder Task
+*  packt seinen A-Block in den Workspace des ausfuehrenden Threads.
+*/
+struct GemmMacroPBody {
+	MatrixView C;						// Ergebnis ab Spalte jc
+	ConstMatrixView A;					// A ab Spalte pc
+	const M_VAL_TYPE* bp;				// Gepacktes B-Panel (kc x nc)
+	const M_SIZE_TYPE m;
+	const M_SIZE_TYPE nc;
+	const M_SIZE_TYPE kc;
+	const bool accumulate;
+
+	GemmMacroPBody(const MatrixView& __C, const ConstMatrixView& __A, const M_VAL_TYPE* __bp, const M_SIZE_TYPE& __m, const M_SIZE_TYPE& __nc, const M_SIZE_TYPE& __kc, const bool __accumulate) :
+			C(__C), A(__A), bp(__bp), m(__m), nc(__nc), kc(__kc), accumulate(__accumulate) {
+	}
+
+	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
+		const M_SIZE_TYPE nr = activeKernel().nr;
+		const M_SIZE_TYPE j0 = range.cols().begin() * nr;
+		const M_SIZE_TYPE j1 = minSize(range.cols().end() * nr, nc);
+		WorkspaceFrame frame;
+		M_VAL_TYPE* ap = frame.buffer(roundUp(GEMM_MC, activeKernel().mr) * kc);
+		for (M_SIZE_TYPE ib = range.rows().begin(); ib != range.rows().end(); ++ib) {
+			const M_SIZE_TYPE ic = ib * GEMM_MC;
+			const M_SIZE_TYPE mc = minSize(GEMM_MC, m - ic);
+			kernelPackA(ap, A.block(ic, 0), mc, kc);
+			kernelMacro(C.block(ic, j0), ap, bp + j0 * kc, mc, j1 - j0, kc, accumulate);
+		}
+	}
+};
+
+/**
+*  @brief  Multipliziert A (m x k) mit B (k x n) sequentiell, gekachelt fuer
+*  L1/L2/L3 (GEMM_KC/GEMM_MC/GEMM_NC) ueber gepackte Operanden und den
+*  Mikrokernel. Dient als Blatt der Strassen-Rekursion.
+*  @param           C  Matrix C (Ergebnismatrix).
+*  @param           A  Matrix A.
+*  @param           B  Matrix B.
+*  @param  accumulate  C += A * B (true) oder C = A * B (false).
+*/
+void gemmSeq(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const bool accumulate) {
+	const KernelInfo& K = activeKernel();
+	WorkspaceFrame frame;
+	const M_SIZE_TYPE kcMax = minSize(k, GEMM_KC);
+	M_VAL_TYPE* ap = frame.buffer(roundUp(minSize(m, GEMM_MC), K.mr) * kcMax);
+	M_VAL_TYPE* bp = frame.buffer(roundUp(minSize(n, GEMM_NC), K.nr) * kcMax);
+	for (M_SIZE_TYPE jc = 0; jc < n; jc += GEMM_NC) {
+		const M_SIZE_TYPE nc = minSize(GEMM_NC, n - jc);
+		for (M_SIZE_TYPE pc = 0; pc < k; pc += GEMM_KC) {
+			const M_SIZE_TYPE kc = minSize(GEMM_KC, k - pc);
+			kernelPackB(bp, B.block(pc, jc), kc, nc);
+			for (M_SIZE_TYPE ic = 0; ic < m; ic += GEMM_MC) {
+				const M_SIZE_TYPE mc = minSize(GEMM_MC, m - ic);
+				kernelPackA(ap, A.block(ic, pc), mc, kc);
+				kernelMacro(C.block(ic, jc), ap, bp, mc, nc, kc, accumulate || pc > 0);
+			}
+		}
+	}
+}
+
+/**
+*  @brief  Parallele Variante von gemmSeq: Je B-Panel wird dieses parallel
+*  gepackt und anschliessend parallel ueber die Makrokacheln (A-Block x
+*  NR-Streifen) multipliziert.
+*  @param           C  Matrix C (Ergebnismatrix).
+*  @param           A  Matrix A.
+*  @param           B  Matrix B.
+*  @param  accumulate  C += A * B (true) oder C = A * B (false).
+*/
+void gemmPar(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const bool accumulate) {
+	const KernelInfo& K = activeKernel();
+	WorkspaceFrame frame;
+	const M_SIZE_TYPE kcMax = minSize(k, GEMM_KC);
+	M_VAL_TYPE* bp = frame.buffer(roundUp(minSize(n, GEMM_NC), K.nr) * kcMax);
+	const M_SIZE_TYPE mBlocks = (m + GEMM_MC - 1) / GEMM_MC;
+	for (M_SIZE_TYPE jc = 0; jc < n; jc += GEMM_NC) {
+		const M_SIZE_TYPE nc = minSize(GEMM_NC, n - jc);
+		const M_SIZE_TYPE nPanels = (nc + K.nr - 1) / K.nr;
+		for (M_SIZE_TYPE pc = 0; pc < k; pc += GEMM_KC) {
+			const M_SIZE_TYPE kc = minSize(GEMM_KC, k - pc);
+			tbb::parallel_for(tbb::blocked_range<M_SIZE_TYPE>(0, nPanels), GemmPackBPBody(bp, B.block(pc, jc), kc, nc));
+			tbb::parallel_for(tbb::blocked_range2d<M_SIZE_TYPE>(0, mBlocks, 1, 0, nPanels, 16),
+					GemmMacroPBody(C.block(0, jc), A.block(0, pc), bp, m, nc, kc, accumulate || pc > 0));
+		}
+	}
+}
+
+} // namespace M_VAL_NAMESPACE
@@ -0,0 +1,30 @@
+//============================================================================
+// Name        : Gemm.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef GEMM_H_
+#define GEMM_H_
+
+#include "Definitions.h"
+
+namespace M_VAL_NAMESPACE {
+
+#define GEMM_MC 192						// Zeilen eines gepackten A-Blocks (L2-Cache)
+#define GEMM_KC 256						// Tiefe der gepackten Bloecke (L1-Cache je Mikrostreifen)
+#define GEMM_NC 4096					// Spalten eines gepackten B-Panels (L3-Cache)
+
+M_SIZE_TYPE gemmPackElements(const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k);
+
+void gemmSeq(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const bool accumulate = false);
+
+void gemmPar(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const bool accumulate = false);
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
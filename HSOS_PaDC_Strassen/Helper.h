@@ -12,6 +12,9 @@
 #define SRC_HELPER_H_
 
 #include "Definitions.h"
+#include "../HSOS_PaDC_Common/Random.h"
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include <iomanip> 			// Formatierung für Matrix-Ausgabe
 #include <iostream>
 #include <math.h>			// fabs
@@ -39,13 +42,76 @@ inline int show_usage(const char* name) {
     std::cerr << "Usage: " << name << " -<option> <value>\n"
 			  << "Options:\n"
 			  << "\t-h\tShow this help message\n"
-			  << "\t-n\tDimension of the matrices (n X n)\n"
+			  << "\t-n\tDimension of the matrices (n X n), columns of B and C\n"
+			  << "\t-m\tRows of A and C (default n)\n"
+			  << "\t-k\tColumns of A, rows of B (default n)\n"
+			  << "\t-b\tBatch mode: number of independent n x n products\n"
+			  << "\t-I\tInversion mode: invert A and solve A X = B with Strassen's inversion (1 on; float, double)\n"
 			  << "\t-c\tCut-Off\n"
+			  << "\t-C\tCut-Off of the task recursion (0: tasks down to -c)\n"
 			  << "\t-r\tRuns (e.g. 1111 for all)\n"
-	  	  	  << "\t-t\tNumber of threads\n";
+	  	  	  << "\t-t\tNumber of threads\n"
+	  	  	  << "\t-l\tLayout (0 row-major, 1 Morton, 2 both)\n"
+	  	  	  << "\t-N\tNUMA placement of the matrices (0 serial, 1 parallel first touch, 2 interleaved)\n"
+	  	  	  << "\t-a\tAlgorithm (0 Strassen, 1 Strassen-Winograd, 2 Strassen flow graph, 3 CAPS)\n"
+	  	  	  << "\t-f\tMax. products in flight per flow graph (0 unlimited)\n"
+	  	  	  << "\t-M\tMemory budget for CAPS temporaries in MiB (0 unlimited; at least the pure DFS need, about n^2 elements)\n"
+	  	  	  << "\t-T\tTune cut-offs and save the profile (1 -c, 2 -c and -C)\n"
+	  	  	  << "\t-p\tProfile path (default ~/.HSOS_PaDC_Strassen.profile)\n"
+	  	  	  << "\t-d\tElement type (float, double, int32, int64; default double)\n"
+	  	  	  << "\t-s\tSeed of the random matrices (default: current time)\n"
+	  	  	  << "\t-v\tVerify each Strassen result with Freivalds' test: random vectors (1-16, 0 off)\n"
+	  	  	  << "\t-j\tWrite per-level instrumentation (time, bytes, flops, tasks, steals) as JSON to this file\n"
+	  	  	  << "\t-B\tBenchmark mode: sweep these sizes (comma list, e.g. 512,1024,2048)\n"
+	  	  	  << "\t-P\tBenchmark: thread counts (comma list, default -t)\n"
+	  	  	  << "\t-K\tBenchmark: cut-offs (comma list of powers of two, default -c)\n"
+	  	  	  << "\t-R\tBenchmark: repeats per case (default 5)\n"
+	  	  	  << "\t-W\tBenchmark: warm-up runs per case (default 1)\n"
+	  	  	  << "\t-o\tBenchmark: result file (*.json JSON, otherwise CSV; default CSV on stdout)\n"
+	  	  	  << "\t-i\tMultiply matrix files A,B (binary format of MatrixFile.h, mapped without copy; type from A)\n"
+	  	  	  << "\t-w\tWrite the result of -i to this matrix file (layout of A)\n"
+	  	  	  << "\t-G\tCreate the files of -i first: random n x n matrices of type -d, tiled with this tile (0 row-major)\n"
+	  	  	  << "\t-O\tOut-of-core mode for -i/-w: RAM budget in MiB (square files, 0 off)\n"
+	  	  	  << "\t-S\tOut-of-core: directory of the scratch files (default: directory of -w)\n"
+	  	  	  << "\t-L\tMPI program: layers of the 2.5D distribution (1: 2D SUMMA)\n"
+	  	  	  << "\t-D\tMPI program: distributed Strassen levels (1: 7 processes, 2: 49 processes; 0: SUMMA)\n";
     return 1;
 }
 
+/**
+*  @brief  Sucht den Werttyp zu einem Namen (siehe M_VAL_TYPE_NAMES).
+*  @param  name  Name des Werttyps, z. B. "float".
+*  @return M_TYPE_* oder -1, falls unbekannt.
+*/
+inline int valueTypeFromName(const char* name) {
+	for (int type = 0; type < M_TYPE_COUNT; ++type) {
+		if (strcmp(name, M_VAL_TYPE_NAMES[type]) == 0) {
+			return type;
+		}
+	}
+	return -1;
+}
+
+/**
+*  @brief  Liest eine durch Kommata getrennte Liste positiver Zahlen.
+*  @param  text  Liste, z. B. "512,1024,2048".
+*  @param  list  Gelesene Werte.
+*  @return true, falls die Liste gueltig und nicht leer ist.
+*/
+inline bool parseSizeList(const char* text, std::vector<M_SIZE_TYPE>& list) {
+	list.clear();
+	while (*text != '\0') {
+		char* end;
+		const long value = strtol(text, &end, 10);
+		if (end == text || value <= 0 || (*end != ',' && *end != '\0')) {
+			return false;
+		}
+		list.push_back((M_SIZE_TYPE) value);
+		text = *end == ',' ? end + 1 : end;
+	}
+	return !list.empty();
+}
+
 /**
 *  @brief  Extrahiert die uebergebenen Argumente, falls angegeben.
 *  @param  argc  Anzahl der Argumente.
@@ -62,7 +128,7 @@ inline int init_arguments(const int argc, char* argv[]) {
 				if (strlen(argv[i]) != 2) {
 					return show_usage(argv[0]);
 				}
-				const char *options = "hnctr";
+				const char *options = "hnmkbIcCtrlNafMTpdsvjBPKRWoiwGOSLD";
 				if (strchr(options, argv[i][1]) == NULL) {
 					return show_usage(argv[0]);
 				}
@@ -78,12 +144,48 @@ inline int init_arguments(const int argc, char* argv[]) {
 					if (tmp <= 0) {
 						return show_usage(argv[0]);
 					}
-					if (!isPowerOfTwo(tmp)) {
-						std::cerr << "Matrix dimension n has to be a value of power of two\n";
-						return 1;
-					}
 					M_SIZE = tmp;
 					break;
+				case 'm':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp <= 0) {
+						return show_usage(argv[0]);
+					}
+					M_ROWS = tmp;
+					break;
+				case 'k':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp <= 0) {
+						return show_usage(argv[0]);
+					}
+					M_INNER = tmp;
+					break;
+				case 'b':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 0) {
+						return show_usage(argv[0]);
+					}
+					BATCH_COUNT = tmp;
+					break;
+				case 'I':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 0 || tmp > 1) {
+						return show_usage(argv[0]);
+					}
+					RUN_INVERSE = tmp;
+					break;
 				case 'c':
 					if (i + 1 >= argc) {
 						return show_usage(argv[0]);
@@ -97,6 +199,18 @@ inline int init_arguments(const int argc, char* argv[]) {
 						return 1;
 					}
 					CUT_OFF = tmp;
+					CUT_OFF_FIXED = 1;
+					break;
+				case 'C':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 0) {
+						return show_usage(argv[0]);
+					}
+					CUT_OFF_TASK = tmp;
+					CUT_OFF_FIXED = 1;
 					break;
 				case 'r':
 					if (i + 1 >= argc || strlen(argv[i + 1]) != 4) {
@@ -116,6 +230,217 @@ inline int init_arguments(const int argc, char* argv[]) {
 					}
 					NO_THREADS = atoi(argv[i + 1]);
 					break;
+				case 'l':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 0 || tmp > 2) {
+						return show_usage(argv[0]);
+					}
+					MATRIX_LAYOUT = tmp;
+					break;
+				case 'N':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < NUMA_SERIAL || tmp > NUMA_INTERLEAVE) {
+						return show_usage(argv[0]);
+					}
+					NUMA_POLICY = tmp;
+					break;
+				case 'a':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < VARIANT_STRASSEN || tmp > VARIANT_CAPS) {
+						return show_usage(argv[0]);
+					}
+					STRASSEN_VARIANT = tmp;
+					break;
+				case 'f':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 0) {
+						return show_usage(argv[0]);
+					}
+					FLOW_PRODUCTS_IN_FLIGHT = tmp;
+					break;
+				case 'M':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 0) {
+						return show_usage(argv[0]);
+					}
+					MEMORY_BUDGET_MIB = tmp;
+					break;
+				case 'T':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 0 || tmp > 2) {
+						return show_usage(argv[0]);
+					}
+					TUNE_MODE = tmp;
+					break;
+				case 'p':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					PROFILE_PATH = argv[i + 1];
+					break;
+				case 'd':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = valueTypeFromName(argv[i + 1]);
+					if (tmp < 0) {
+						return show_usage(argv[0]);
+					}
+					M_VAL_TYPE_SELECT = tmp;
+					break;
+				case 's':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					RANDOM_SEED = strtoull(argv[i + 1], NULL, 10);
+					if (RANDOM_SEED == 0) {
+						return show_usage(argv[0]);
+					}
+					break;
+				case 'v':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 0 || tmp > VERIFY_MAX_VECTORS) {
+						return show_usage(argv[0]);
+					}
+					VERIFY_VECTORS = tmp;
+					break;
+				case 'j':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					TRACE_PATH = argv[i + 1];
+					break;
+				case 'B':
+					if (i + 1 >= argc || !parseSizeList(argv[i + 1], BENCH_SIZES)) {
+						return show_usage(argv[0]);
+					}
+					break;
+				case 'P':
+					if (i + 1 >= argc || !parseSizeList(argv[i + 1], BENCH_THREADS)) {
+						return show_usage(argv[0]);
+					}
+					break;
+				case 'K':
+					if (i + 1 >= argc || !parseSizeList(argv[i + 1], BENCH_CUT_OFFS)) {
+						return show_usage(argv[0]);
+					}
+					for (size_t c = 0; c < BENCH_CUT_OFFS.size(); ++c) {
+						if (!isPowerOfTwo(BENCH_CUT_OFFS[c])) {
+							std::cerr << "Cut-Off c has to be a value of power of two\n";
+							return 1;
+						}
+					}
+					break;
+				case 'R':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp <= 0) {
+						return show_usage(argv[0]);
+					}
+					BENCH_REPEATS = tmp;
+					break;
+				case 'W':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 0) {
+						return show_usage(argv[0]);
+					}
+					BENCH_WARMUPS = tmp;
+					break;
+				case 'o':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					BENCH_PATH = argv[i + 1];
+					break;
+				case 'i':
+					if (i + 1 >= argc || strchr(argv[i + 1], ',') == NULL) {
+						return show_usage(argv[0]);
+					}
+					MATRIX_FILE_A = argv[i + 1];
+					MATRIX_FILE_B = strchr(argv[i + 1], ',') + 1;
+					*strchr(argv[i + 1], ',') = '\0';
+					if (MATRIX_FILE_A[0] == '\0' || MATRIX_FILE_B[0] == '\0') {
+						return show_usage(argv[0]);
+					}
+					break;
+				case 'w':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					MATRIX_FILE_C = argv[i + 1];
+					break;
+				case 'G':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 0) {
+						return show_usage(argv[0]);
+					}
+					MATRIX_FILE_TILE = tmp;
+					break;
+				case 'O':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 0) {
+						return show_usage(argv[0]);
+					}
+					OOC_BUDGET_MIB = tmp;
+					break;
+				case 'S':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					OOC_SCRATCH_DIR = argv[i + 1];
+					break;
+				case 'L':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 1) {
+						return show_usage(argv[0]);
+					}
+					DIST_LAYERS = tmp;
+					break;
+				case 'D':
+					if (i + 1 >= argc) {
+						return show_usage(argv[0]);
+					}
+					tmp = atoi(argv[i + 1]);
+					if (tmp < 0 || tmp > 2) {
+						return show_usage(argv[0]);
+					}
+					DIST_STRASSEN_LEVELS = tmp;
+					break;
 				default:
 					return show_usage(argv[0]);
 				}
@@ -127,42 +452,178 @@ inline int init_arguments(const int argc, char* argv[]) {
 }
 
 /**
-*  @brief  Initialisiert den Zufallsgenerator.
+*  @brief  Initialisiert den Zufallsgenerator: Ohne -s wird der Startwert aus
+*  der Uhrzeit gebildet. Mit demselben Startwert entstehen unabhaengig von der
+*  Thread-Anzahl bitgleiche Matrizen.
 */
 inline void initRandomizer() {
-	time_t t;
-	time(&t);
-	srand((unsigned int) t);
+	if (RANDOM_SEED == 0) {
+		RANDOM_SEED = (uint64_t) time(NULL);
+	}
 }
 
+#define PARALLEL_INIT_GRAIN 16			// Zeilen je Teilbereich der parallelen Initialisierung
+#define RANDOM_STREAM_A 0				// Philox-Stroeme der Operanden (unabhaengige Folgen)
+#define RANDOM_STREAM_B 1
+#define RANDOM_STREAM_VERIFY 2			// Zufallsvektoren der Freivalds-Pruefung
+
+namespace M_VAL_NAMESPACE {
+
 /**
-*  @brief  Initialisiert eine Matrix mit Zufallswerten.
-*  @param     M  Matrix M.
-*  @param  size  Matrixdimension (NxN).
+*  @brief  Bildet 32 Zufallsbits auf einen Wert ab. Ganzzahlige Werttypen
+*  erhalten kleine Werte (0 bis MAX_RAND_INT - 1), damit die Zwischensummen
+*  der Rekursion nicht ueberlaufen und das Ergebnis exakt bleibt.
+*  @param  bits  Zufallsbits (siehe randomBits).
+*/
+inline M_VAL_TYPE randomValue(const uint32_t bits) {
+#if M_VAL_IS_INTEGER
+	return (M_VAL_TYPE) (bits % MAX_RAND_INT);
+#else
+	return (M_VAL_TYPE) (bits >> 1) / (MAX_RAND_VAL);
+#endif
+}
+
+/**
+*  @brief  Prueft, ob zwei Werte voneinander abweichen: Ganzzahlige Werttypen
+*  werden exakt verglichen, double mit der absoluten Schranke THRESHOLD und
+*  float (24 Bit Mantisse) relativ zum Betrag des Referenzwerts.
+*  @param          a  Zu pruefender Wert.
+*  @param  reference  Referenzwert.
+*  @return true, falls die Werte (ausserhalb der Toleranz) verschieden sind.
+*/
+inline bool valuesDiffer(const M_VAL_TYPE& a, const M_VAL_TYPE& reference) {
+#if M_VAL_IS_INTEGER
+	return a != reference;
+#elif M_VAL_TYPE_ID == M_TYPE_FLOAT
+	const double scale = fabs((double) reference);
+	return fabs((double) a - (double) reference) > THRESHOLD * (scale > 1 ? scale : 1);
+#else
+	return fabs((double)(a - reference)) > THRESHOLD;
+#endif
+}
+
+/**
+*  @brief  Funktionsobjekt zum parallelisierten Initialisieren mit
+*  Zufallswerten: Element (i, j) erhaelt den Wert i * cols + j des Philox-
+*  Stroms, das Ergebnis haengt daher nicht von der Aufteilung ab. Die Seiten
+*  werden von den Threads beschrieben, die spaeter ihre Partition rechnen.
+*  Ein Block (Zeile row0, Spalte col0) einer Matrix mit stride Spalten
+*  erhaelt dieselben Werte wie in der vollstaendigen Matrix.
 */
-inline void initializeRandpriomMatrix(Matrix& M, const M_SIZE_TYPE& size) {
-	for (M_SIZE_TYPE i = 0; i < size; ++i) {
-		for (M_SIZE_TYPE j = 0; j < size; ++j) {
+struct InitRandomPBody {
+	MatrixView M;
+	const M_SIZE_TYPE cols;
+	const uint32_t stream;
+	const M_SIZE_TYPE row0;
+	const M_SIZE_TYPE col0;
+	const M_SIZE_TYPE stride;
+
+	InitRandomPBody(const MatrixView& __M, const M_SIZE_TYPE& __cols, const uint32_t __stream) : M(__M), cols(__cols), stream(__stream), row0(0), col0(0), stride(__cols) { }
+
+	InitRandomPBody(const MatrixView& __M, const M_SIZE_TYPE& __cols, const uint32_t __stream, const M_SIZE_TYPE& __row0, const M_SIZE_TYPE& __col0, const M_SIZE_TYPE& __stride) :
+			M(__M), cols(__cols), stream(__stream), row0(__row0), col0(__col0), stride(__stride) { }
+
+	void operator()(const tbb::blocked_range<M_SIZE_TYPE>& range) const {
 #if DEBUG
-			M[i][j] = 2;
+		for (M_SIZE_TYPE i = range.begin(); i != range.end(); ++i) {
+			for (M_SIZE_TYPE j = 0; j < cols; ++j) {
+				M[i][j] = 2;
+			}
+		}
 #else
-			M[i][j] = (M_VAL_TYPE) rand() / (MAX_RAND_VAL);
+		uint32_t bits[4];
+		uint64_t block = ~(uint64_t) 0;
+		for (M_SIZE_TYPE i = range.begin(); i != range.end(); ++i) {
+			for (M_SIZE_TYPE j = 0; j < cols; ++j) {
+				const uint64_t index = (uint64_t) (row0 + i) * stride + col0 + j;
+				if ((index >> 2) != block) {
+					block = index >> 2;
+					randomBlock(RANDOM_SEED, stream, block, bits);
+				}
+				M[i][j] = randomValue(bits[index & 3]);
+			}
+		}
 #endif
+	}
+};
+
+/**
+*  @brief  Funktionsobjekt zum parallelisierten Setzen eines Wertes.
+*/
+struct ResetValuesPBody {
+	MatrixView M;
+	const M_SIZE_TYPE cols;
+	const M_VAL_TYPE value;
+
+	ResetValuesPBody(const MatrixView& __M, const M_SIZE_TYPE& __cols, const M_VAL_TYPE& __value) : M(__M), cols(__cols), value(__value) { }
+
+	void operator()(const tbb::blocked_range<M_SIZE_TYPE>& range) const {
+		for (M_SIZE_TYPE i = range.begin(); i != range.end(); ++i) {
+			for (M_SIZE_TYPE j = 0; j < cols; ++j) {
+				M[i][j] = value;
+			}
 		}
 	}
+};
+
+/**
+*  @brief  Initialisiert eine rechteckige Matrix parallel mit Zufallswerten
+*  (NUMA_SERIAL: seriell im aufrufenden Thread).
+*  @param       M  Matrix M.
+*  @param    rows  Anzahl der Zeilen.
+*  @param    cols  Anzahl der Spalten.
+*  @param  stream  Philox-Strom (RANDOM_STREAM_*).
+*/
+inline void initializeRandpriomMatrix(const MatrixView& M, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols, const uint32_t stream) {
+	const InitRandomPBody body(M, cols, stream);
+	if (NUMA_POLICY == NUMA_SERIAL) {
+		body(tbb::blocked_range<M_SIZE_TYPE>(0, rows));
+	}
+	else {
+		tbb::parallel_for(tbb::blocked_range<M_SIZE_TYPE>(0, rows, PARALLEL_INIT_GRAIN), body);
+	}
+}
+
+/**
+*  @brief  Initialisiert einen Block rows x cols ab (row0, col0) einer
+*  zeilenweisen Matrix mit stride Spalten, z. B. den Block eines Prozesses.
+*  @param       M  Sicht auf den Block.
+*  @param    rows  Zeilen des Blocks.
+*  @param    cols  Spalten des Blocks.
+*  @param    row0  Erste Zeile des Blocks in der Matrix.
+*  @param    col0  Erste Spalte des Blocks in der Matrix.
+*  @param  stride  Spalten der Matrix.
+*  @param  stream  Philox-Strom (RANDOM_STREAM_*).
+*/
+inline void initializeRandpriomBlock(const MatrixView& M, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols,
+		const M_SIZE_TYPE& row0, const M_SIZE_TYPE& col0, const M_SIZE_TYPE& stride, const uint32_t stream) {
+	tbb::parallel_for(tbb::blocked_range<M_SIZE_TYPE>(0, rows, PARALLEL_INIT_GRAIN), InitRandomPBody(M, cols, stream, row0, col0, stride));
+}
+
+/**
+*  @brief  Initialisiert eine Matrix mit Zufallswerten.
+*  @param       M  Matrix M.
+*  @param    size  Matrixdimension (NxN).
+*  @param  stream  Philox-Strom (RANDOM_STREAM_*).
+*/
+inline void initializeRandpriomMatrix(Matrix& M, const M_SIZE_TYPE& size, const uint32_t stream) {
+	initializeRandpriomMatrix(MatrixView(M), size, size, stream);
 }
 
 /**
-*  @brief  Setzt alle Werte einer Matrix auf den uebergebenen Wert.
+*  @brief  Setzt alle Werte einer Matrix parallel auf den uebergebenen Wert
+*  (NUMA_SERIAL: seriell im aufrufenden Thread).
 *  @param      M  Matrix M.
 *  @param   size  Matrixdimension (NxN).
 *  @param  value  Zu setzender Wert (optional).
 */
 inline void resetValuesMatrix(Matrix& M, const M_SIZE_TYPE& size, const M_VAL_TYPE& value = 0) {
-	for (M_SIZE_TYPE i = 0; i < size; ++i) {
-		for (M_SIZE_TYPE j = 0; j < size; ++j) {
-			M[i][j] = value;
-		}
+	const ResetValuesPBody body(M, size, value);
+	if (NUMA_POLICY == NUMA_SERIAL) {
+		body(tbb::blocked_range<M_SIZE_TYPE>(0, size));
+	}
+	else {
+		tbb::parallel_for(tbb::blocked_range<M_SIZE_TYPE>(0, size, PARALLEL_INIT_GRAIN), body);
 	}
 }
 
@@ -196,8 +657,8 @@ inline void printMatrix(const Matrix& M, const char* matrixName = NULL) {
 
 /**
 *  @brief  Vergleich zwei Matrizen miteinander. Weicht ein Differenzwert
-*  staerker als die THRESHOLD definierte Konstante ab, so werden die
-*  Matrizen als ungleich angesehen.
+*  staerker als die THRESHOLD definierte Konstante ab (ganzzahlige Werttypen:
+*  ueberhaupt), so werden die Matrizen als ungleich angesehen.
 *  @param  A  Matrix A.
 *  @param  B  Matrix B.
 *  @param  n  Matrixdimension (NxN).
@@ -206,7 +667,7 @@ inline void printMatrix(const Matrix& M, const char* matrixName = NULL) {
 inline int compareMatrices(const Matrix& A, const Matrix& B, const M_SIZE_TYPE& n) {
 	for (M_SIZE_TYPE i = 0; i < n; ++i) {
 		for (M_SIZE_TYPE j = 0; j < n; ++j) {
-			if (fabs((double)(A[i][j] - B[i][j])) > THRESHOLD) {
+			if (valuesDiffer(A[i][j], B[i][j])) {
 				std::cout << "A[" << i << "][" << j << "](" << A[i][j] << ") != B[" << i << "][" << j << "](" << B[i][j] << ") ";
 				return 1;
 			}
@@ -215,4 +676,26 @@ inline int compareMatrices(const Matrix& A, const Matrix& B, const M_SIZE_TYPE&
 	return 0;
 }
 
+/**
+*  @brief  Vergleicht zwei rechteckige Matrizen miteinander (siehe oben).
+*  @param     A  Matrix A.
+*  @param     B  Matrix B.
+*  @param  rows  Anzahl der Zeilen.
+*  @param  cols  Anzahl der Spalten.
+*  @return 0 falls beide Matrizen gleich sind, andernfalls != 0.
+*/
+inline int compareMatrices(const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols) {
+	for (M_SIZE_TYPE i = 0; i < rows; ++i) {
+		for (M_SIZE_TYPE j = 0; j < cols; ++j) {
+			if (valuesDiffer(A[i][j], B[i][j])) {
+				std::cout << "A[" << i << "][" << j << "](" << A[i][j] << ") != B[" << i << "][" << j << "](" << B[i][j] << ") ";
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+} // namespace M_VAL_NAMESPACE
+
 #endif
@@ -0,0 +1,260 @@
+//============================================================================
+// Name        : Inverse.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Inverse.h"
+#include "Gemm.h"
+#include "Strassen.h"
+#include "StrassenRect.h"
+#include "Verify.h"
+#include <algorithm>
+#include <math.h>
+#include <vector>
+#include <tbb/parallel_invoke.h>
+
+namespace M_VAL_NAMESPACE {
+
+/**
+*  @brief  Blockprodukt C (m x n) = A (m x k) * B (k x n) der Inversion ueber
+*  den Strassen-Algorithmus (quadratisch: Variante gemaess STRASSEN_VARIANT).
+*/
+static void inverseProduct(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	if (m == n && n == k) {
+		strassenMultiplyPar(MatrixView(C.data, C.ld, n), ConstMatrixView(A.data, A.ld, n), ConstMatrixView(B.data, B.ld, n), n);
+	}
+	else {
+		strassenRectPar(C, A, B, m, n, k);
+	}
+}
+
+/**
+*  @brief  Funktionsobjekt fuer zwei unabhaengige Blockprodukte (parallel_invoke).
+*/
+struct InverseProductBody {
+	MatrixView C;
+	ConstMatrixView A;
+	ConstMatrixView B;
+	const M_SIZE_TYPE m;
+	const M_SIZE_TYPE n;
+	const M_SIZE_TYPE k;
+
+	InverseProductBody(const MatrixView& __C, const ConstMatrixView& __A, const ConstMatrixView& __B, const M_SIZE_TYPE& __m, const M_SIZE_TYPE& __n, const M_SIZE_TYPE& __k) :
+			C(__C), A(__A), B(__B), m(__m), n(__n), k(__k) {
+	}
+
+	void operator()() const {
+		inverseProduct(C, A, B, m, n, k);
+	}
+};
+
+/**
+*  @brief  Zwischenmatrizen II, III und IV/V aller Ebenen (in Elementen).
+*/
+static M_SIZE_TYPE inverseScratchElements(const M_SIZE_TYPE& n) {
+	if (n <= INVERSE_CUT_OFF) {
+		return 0;
+	}
+	const M_SIZE_TYPE h1 = n >> 1;
+	const M_SIZE_TYPE h2 = n - h1;
+	const M_SIZE_TYPE first = inverseScratchElements(h1);
+	const M_SIZE_TYPE second = inverseScratchElements(h2);
+	return 2 * h1 * h2 + h2 * h2 + (first > second ? first : second);
+}
+
+/**
+*  @brief  Berechnet die Groesse des Workspaces je Thread fuer die
+*  Blockprodukte der Inversion (groesstes Produkt: oberste Ebene).
+*  @param  n  Matrixdimension (NxN).
+*  @return Benoetigte Elemente je Thread.
+*/
+M_SIZE_TYPE inverseWorkspaceElements(const M_SIZE_TYPE& n) {
+	if (n <= INVERSE_CUT_OFF) {
+		return 0;
+	}
+	const M_SIZE_TYPE h1 = n >> 1;
+	const M_SIZE_TYPE h2 = n - h1;
+	const M_SIZE_TYPE square = h1 == h2 ? strassenWorkspaceElements(h1) : 0;
+	const M_SIZE_TYPE rect = h1 == h2 ? 0 : strassenRectWorkspaceElements(h2, h2, h2);
+	const M_SIZE_TYPE pack = gemmPackElements(CUT_OFF, CUT_OFF, CUT_OFF);
+	const M_SIZE_TYPE products = (square > rect ? square : rect) + pack;
+	const M_SIZE_TYPE deeper = inverseWorkspaceElements(h2);
+	return products > deeper ? products : deeper;
+}
+
+/**
+*  @brief  Invertiert eine Matrix mit dem Gauss-Jordan-Verfahren und
+*  Spaltenpivotsuche (Blatt der Rekursion bzw. Referenz, sequentiell).
+*  @param  X  Ergebnis A^-1 (darf nicht mit A ueberlappen).
+*  @param  A  Matrix A.
+*  @param  n  Matrixdimension (NxN).
+*  @return false, falls A (numerisch) singulaer ist.
+*/
+bool inverseGaussJordan(const MatrixView& X, const ConstMatrixView& A, const M_SIZE_TYPE& n) {
+	matrixCopySeq(X, A, n, n);
+	std::vector<M_SIZE_TYPE> pivots(n);
+	for (M_SIZE_TYPE k = 0; k < n; ++k) {
+		M_SIZE_TYPE p = k;
+		for (M_SIZE_TYPE i = k + 1; i < n; ++i) {
+			if (fabs((double) X[i][k]) > fabs((double) X[p][k])) {
+				p = i;
+			}
+		}
+		if (X[p][k] == 0) {
+			return false;
+		}
+		pivots[k] = p;
+		if (p != k) {
+			std::swap_ranges(X[k], X[k] + n, X[p]);
+		}
+
+		// Zeile k normieren, Spalte k in allen anderen Zeilen eliminieren
+		M_VAL_TYPE* rowK = X[k];
+		const M_VAL_TYPE inverse = (M_VAL_TYPE) 1 / rowK[k];
+		rowK[k] = 1;
+		for (M_SIZE_TYPE j = 0; j < n; ++j) {
+			rowK[j] *= inverse;
+		}
+		for (M_SIZE_TYPE i = 0; i < n; ++i) {
+			M_VAL_TYPE* rowI = X[i];
+			const M_VAL_TYPE factor = rowI[k];
+			if (i == k || factor == 0) {
+				continue;
+			}
+			rowI[k] = 0;
+			for (M_SIZE_TYPE j = 0; j < n; ++j) {
+				rowI[j] -= factor * rowK[j];
+			}
+		}
+	}
+
+	// Zeilenvertauschungen von A entsprechen Spaltenvertauschungen von A^-1
+	for (M_SIZE_TYPE k = n; k-- > 0;) {
+		if (pivots[k] != k) {
+			for (M_SIZE_TYPE i = 0; i < n; ++i) {
+				std::swap(X[i][k], X[i][pivots[k]]);
+			}
+		}
+	}
+	return true;
+}
+
+/**
+*  @brief  Rekursion der Inversion (siehe Inverse.h).
+*  @param        X  Ergebnis A^-1.
+*  @param        A  Matrix A.
+*  @param        n  Matrixdimension (NxN).
+*  @param  scratch  Zwischenmatrizen dieser und der tieferen Ebenen.
+*  @return false, falls ein Diagonalblock singulaer ist.
+*/
+static bool inverseRecursive(const MatrixView& X, const ConstMatrixView& A, const M_SIZE_TYPE& n, M_VAL_TYPE* scratch) {
+	if (n <= INVERSE_CUT_OFF) {
+		return inverseGaussJordan(X, A, n);
+	}
+	const M_SIZE_TYPE h1 = n >> 1;
+	const M_SIZE_TYPE h2 = n - h1;
+
+	const ConstMatrixView A11 = A.block(0, 0);
+	const ConstMatrixView A12 = A.block(0, h1);
+	const ConstMatrixView A21 = A.block(h1, 0);
+	const ConstMatrixView A22 = A.block(h1, h1);
+
+	const MatrixView X11 = X.block(0, 0);
+	const MatrixView X12 = X.block(0, h1);
+	const MatrixView X21 = X.block(h1, 0);
+	const MatrixView X22 = X.block(h1, h1);
+
+	const MatrixView T1(scratch, h1, 0);							// II (h2 x h1), danach VII (h1 x h1)
+	const MatrixView T2(scratch + h2 * h1, h2, 0);					// III (h1 x h2)
+	const MatrixView T3(scratch + 2 * h1 * h2, h2, 0);				// IV bzw. V (h2 x h2)
+	M_VAL_TYPE* deeper = scratch + 2 * h1 * h2 + h2 * h2;
+
+	// I = A11^-1 in X11
+	if (!inverseRecursive(X11, A11, h1, deeper)) {
+		return false;
+	}
+	tbb::parallel_invoke(
+			InverseProductBody(T1, A21, X11, h2, h1, h1),
+			InverseProductBody(T2, X11, A12, h1, h2, h1));
+
+	// V = A21 III - A22, VI = V^-1 in X22
+	inverseProduct(T3, A21, T2, h2, h2, h1);
+	matrixSubPar(T3, T3, A22, h2, h2);
+	if (!inverseRecursive(X22, T3, h2, deeper)) {
+		return false;
+	}
+	tbb::parallel_invoke(
+			InverseProductBody(X12, T2, X22, h1, h2, h2),
+			InverseProductBody(X21, X22, T1, h2, h1, h2));
+
+	// X11 = I - III X21, X22 = -VI
+	inverseProduct(T1, T2, X21, h1, h1, h2);
+	matrixSubPar(X11, X11, T1, h1, h1);
+	matrixApplyPar(MatrixAccumulatePBody(X22, X22, -1, true), h2, h2);
+	return true;
+}
+
+/**
+*  @brief  Invertiert eine Matrix nach Strassen (siehe Inverse.h). Der
+*  Workspace fuer die Blockprodukte muss reserviert sein
+*  (initWorkspaces mit inverseWorkspaceElements).
+*  @param  X  Ergebnis A^-1 (zeilenweise, darf nicht mit A ueberlappen).
+*  @param  A  Matrix A (zeilenweise).
+*  @param  n  Matrixdimension (NxN).
+*  @return false, falls ein Diagonalblock (numerisch) singulaer ist.
+*/
+bool strassenInvert(const MatrixView& X, const ConstMatrixView& A, const M_SIZE_TYPE& n) {
+	const M_SIZE_TYPE elements = inverseScratchElements(n);
+	MatrixStorage scratch(elements > 0 ? elements : 1);
+	return inverseRecursive(X, A, n, &scratch[0]);
+}
+
+/**
+*  @brief  Normweiser Rueckwaertsfehler des Systems A X = B an Zufallsvektoren
+*  x mit y = X x und b = B x (Unendlichnorm, groesster Wert ueber die Vektoren):
+*
+*      ||A y - b|| / (||A|| ||y|| + ||b||)
+*
+*  Fuer eine stabile Rechnung liegt er bei einem kleinen Vielfachen der
+*  Maschinengenauigkeit. Aufwand O(n^2).
+*  @param        A  Matrix A.
+*  @param        X  Loesung bzw. Inverse.
+*  @param        B  Rechte Seite (data NULL: Einheitsmatrix, d. h. X = A^-1).
+*  @param        n  Matrixdimension (NxN).
+*  @param  vectors  Anzahl der Zufallsvektoren (1 .. VERIFY_MAX_VECTORS).
+*/
+double inverseResidual(const ConstMatrixView& A, const ConstMatrixView& X, const ConstMatrixView& B, const M_SIZE_TYPE& n, const int vectors) {
+	const int v = vectors < 1 ? 1 : vectors > VERIFY_MAX_VECTORS ? VERIFY_MAX_VECTORS : vectors;
+	std::vector<VerifyValue> x(n * v), b(n * v), y(n * v), z(n * v);
+	std::vector<double> ones(n, 1.0), absA(n);
+	verifySigns(&x[0], n, v);
+	if (B.data != NULL) {
+		verifyMatVec(B, n, n, v, &x[0], &b[0]);
+	}
+	else {
+		b = x;
+	}
+	verifyMatVec(X, n, n, v, &x[0], &y[0]);
+	verifyMatVec(A, n, n, v, &y[0], &z[0], &ones[0], &absA[0]);
+
+	const double normA = *std::max_element(absA.begin(), absA.end());
+	double worst = 0;
+	for (int t = 0; t < v; ++t) {
+		double residual = 0, normY = 0, normB = 0;
+		for (M_SIZE_TYPE i = 0; i < n; ++i) {
+			residual = std::max(residual, fabs((double) (z[i * v + t] - b[i * v + t])));
+			normY = std::max(normY, fabs((double) y[i * v + t]));
+			normB = std::max(normB, fabs((double) b[i * v + t]));
+		}
+		const double error = residual / (normA * normY + normB);
+		worst = error > worst || error != error ? error : worst;
+	}
+	return worst;
+}
+
+} // namespace M_VAL_NAMESPACE
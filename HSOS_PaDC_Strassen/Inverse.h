@@ -0,0 +1,52 @@
+//============================================================================
+// Name        : Inverse.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef INVERSE_H_
+#define INVERSE_H_
+
+#include "Definitions.h"
+#include "Matrix.h"
+
+/*
+ * Inversion nach Strassen (1969, Abschnitt "Inversion"): Mit den Bloecken
+ * A11 (h1 x h1, h1 = n/2), A12, A21 und A22 (h2 x h2, h2 = n - h1) ist
+ *
+ *     I   = A11^-1              II  = A21 I          III = I A12
+ *     IV  = A21 III             V   = IV - A22       VI  = V^-1
+ *     X12 = III VI              X21 = VI II          VII = III X21
+ *     X11 = I - VII             X22 = -VI
+ *
+ * die Inverse X = A^-1. Die beiden Inversen laufen rekursiv, die sechs
+ * Blockprodukte ueber strassenMultiplyPar bzw. (ungerades n) strassenRectPar,
+ * die Inversion erbt damit den Exponenten log2(7) und die Task-
+ * Parallelitaet des Produkts; II/III und X12/X21 laufen zusaetzlich
+ * nebeneinander. Unterhalb von INVERSE_CUT_OFF rechnet Gauss-Jordan mit
+ * Spaltenpivotsuche. Zwischen den Bloecken wird nicht pivotisiert: A11 und
+ * das Schur-Komplement V muessen regulaer und gut konditioniert sein (z. B.
+ * diagonaldominant oder symmetrisch positiv definit), die Stabilitaet wird
+ * deshalb ueber das Residuum (inverseResidual) ueberwacht. Lineare Systeme
+ * A X = B werden ueber X = A^-1 B mit einem weiteren Strassen-Produkt geloest.
+ */
+
+#define INVERSE_CUT_OFF 64				// Darunter Gauss-Jordan (O(n^3), mit Spaltenpivotsuche)
+
+namespace M_VAL_NAMESPACE {
+
+M_SIZE_TYPE inverseWorkspaceElements(const M_SIZE_TYPE& n);
+
+bool inverseGaussJordan(const MatrixView& X, const ConstMatrixView& A, const M_SIZE_TYPE& n);
+
+bool strassenInvert(const MatrixView& X, const ConstMatrixView& A, const M_SIZE_TYPE& n);
+
+double inverseResidual(const ConstMatrixView& A, const ConstMatrixView& X, const ConstMatrixView& B, const M_SIZE_TYPE& n, const int vectors);
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
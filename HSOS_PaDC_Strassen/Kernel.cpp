@@ -0,0 +1,394 @@
+//============================================================================
+// Name        : Kernel.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Kernel.h"
+#include "Workspace.h"
+#include <fstream>
+#include <stdlib.h>
+#include <string>
+#include <tbb/tick_count.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNEL_X86 1
+#include <immintrin.h>
+#else
+#define KERNEL_X86 0
+#endif
+
+#define KERNEL_MAX_MR 8					// Groesste Zeilenzahl einer Mikrokachel
+#define KERNEL_MAX_NR 32				// Groesste Spaltenzahl einer Mikrokachel (float: 2 x 16)
+#define KERNEL_BENCH_SECONDS 0.2		// Mindestlaufzeit des Kernel-Benchmarks
+
+namespace M_VAL_NAMESPACE {
+
+/**
+*  @brief  Portabler Mikrokernel (4 x 4), Rueckfall ohne SIMD-Unterstuetzung
+*  und Kernel der ganzzahligen Werttypen (exakte Arithmetik).
+*/
+static void microKernelScalar(const M_SIZE_TYPE kc, const M_VAL_TYPE* a, const M_VAL_TYPE* b, M_VAL_TYPE* c, const M_SIZE_TYPE ldc, const bool accumulate) {
+	M_VAL_TYPE acc[4][4] = { { 0 } };
+	for (M_SIZE_TYPE p = 0; p < kc; ++p) {
+		for (M_SIZE_TYPE i = 0; i < 4; ++i) {
+			const M_VAL_TYPE ai = a[i];
+			for (M_SIZE_TYPE j = 0; j < 4; ++j) {
+				acc[i][j] += ai * b[j];
+			}
+		}
+		a += 4;
+		b += 4;
+	}
+	for (M_SIZE_TYPE i = 0; i < 4; ++i) {
+		for (M_SIZE_TYPE j = 0; j < 4; ++j) {
+			c[i * ldc + j] = accumulate ? c[i * ldc + j] + acc[i][j] : acc[i][j];
+		}
+	}
+}
+
+#if KERNEL_X86 && M_VAL_TYPE_ID == M_TYPE_DOUBLE
+/**
+*  @brief  AVX2/FMA-Mikrokernel (6 x 8): 12 Akkumulatoren in ymm-Registern.
+*/
+__attribute__((target("avx2,fma")))
+static void microKernelAvx2(const M_SIZE_TYPE kc, const M_VAL_TYPE* a, const M_VAL_TYPE* b, M_VAL_TYPE* c, const M_SIZE_TYPE ldc, const bool accumulate) {
+	__m256d acc[6][2];
+	for (int i = 0; i < 6; ++i) {
+		acc[i][0] = _mm256_setzero_pd();
+		acc[i][1] = _mm256_setzero_pd();
+	}
+	for (M_SIZE_TYPE p = 0; p < kc; ++p) {
+		const __m256d b0 = _mm256_loadu_pd(b);
+		const __m256d b1 = _mm256_loadu_pd(b + 4);
+		for (int i = 0; i < 6; ++i) {
+			const __m256d ai = _mm256_broadcast_sd(a + i);
+			acc[i][0] = _mm256_fmadd_pd(ai, b0, acc[i][0]);
+			acc[i][1] = _mm256_fmadd_pd(ai, b1, acc[i][1]);
+		}
+		a += 6;
+		b += 8;
+	}
+	for (int i = 0; i < 6; ++i) {
+		M_VAL_TYPE* ci = c + i * ldc;
+		if (accumulate) {
+			acc[i][0] = _mm256_add_pd(acc[i][0], _mm256_loadu_pd(ci));
+			acc[i][1] = _mm256_add_pd(acc[i][1], _mm256_loadu_pd(ci + 4));
+		}
+		_mm256_storeu_pd(ci, acc[i][0]);
+		_mm256_storeu_pd(ci + 4, acc[i][1]);
+	}
+}
+
+/**
+*  @brief  AVX-512-Mikrokernel (8 x 16): 16 Akkumulatoren in zmm-Registern.
+*/
+__attribute__((target("avx512f")))
+static void microKernelAvx512(const M_SIZE_TYPE kc, const M_VAL_TYPE* a, const M_VAL_TYPE* b, M_VAL_TYPE* c, const M_SIZE_TYPE ldc, const bool accumulate) {
+	__m512d acc[8][2];
+	for (int i = 0; i < 8; ++i) {
+		acc[i][0] = _mm512_setzero_pd();
+		acc[i][1] = _mm512_setzero_pd();
+	}
+	for (M_SIZE_TYPE p = 0; p < kc; ++p) {
+		const __m512d b0 = _mm512_loadu_pd(b);
+		const __m512d b1 = _mm512_loadu_pd(b + 8);
+		for (int i = 0; i < 8; ++i) {
+			const __m512d ai = _mm512_set1_pd(a[i]);
+			acc[i][0] = _mm512_fmadd_pd(ai, b0, acc[i][0]);
+			acc[i][1] = _mm512_fmadd_pd(ai, b1, acc[i][1]);
+		}
+		a += 8;
+		b += 16;
+	}
+	for (int i = 0; i < 8; ++i) {
+		M_VAL_TYPE* ci = c + i * ldc;
+		if (accumulate) {
+			acc[i][0] = _mm512_add_pd(acc[i][0], _mm512_loadu_pd(ci));
+			acc[i][1] = _mm512_add_pd(acc[i][1], _mm512_loadu_pd(ci + 8));
+		}
+		_mm512_storeu_pd(ci, acc[i][0]);
+		_mm512_storeu_pd(ci + 8, acc[i][1]);
+	}
+}
+#endif
+
+#if KERNEL_X86 && M_VAL_TYPE_ID == M_TYPE_FLOAT
+/**
+*  @brief  AVX2/FMA-Mikrokernel (6 x 16): 12 Akkumulatoren in ymm-Registern.
+*/
+__attribute__((target("avx2,fma")))
+static void microKernelAvx2(const M_SIZE_TYPE kc, const M_VAL_TYPE* a, const M_VAL_TYPE* b, M_VAL_TYPE* c, const M_SIZE_TYPE ldc, const bool accumulate) {
+	__m256 acc[6][2];
+	for (int i = 0; i < 6; ++i) {
+		acc[i][0] = _mm256_setzero_ps();
+		acc[i][1] = _mm256_setzero_ps();
+	}
+	for (M_SIZE_TYPE p = 0; p < kc; ++p) {
+		const __m256 b0 = _mm256_loadu_ps(b);
+		const __m256 b1 = _mm256_loadu_ps(b + 8);
+		for (int i = 0; i < 6; ++i) {
+			const __m256 ai = _mm256_broadcast_ss(a + i);
+			acc[i][0] = _mm256_fmadd_ps(ai, b0, acc[i][0]);
+			acc[i][1] = _mm256_fmadd_ps(ai, b1, acc[i][1]);
+		}
+		a += 6;
+		b += 16;
+	}
+	for (int i = 0; i < 6; ++i) {
+		M_VAL_TYPE* ci = c + i * ldc;
+		if (accumulate) {
+			acc[i][0] = _mm256_add_ps(acc[i][0], _mm256_loadu_ps(ci));
+			acc[i][1] = _mm256_add_ps(acc[i][1], _mm256_loadu_ps(ci + 8));
+		}
+		_mm256_storeu_ps(ci, acc[i][0]);
+		_mm256_storeu_ps(ci + 8, acc[i][1]);
+	}
+}
+
+/**
+*  @brief  AVX-512-Mikrokernel (8 x 32): 16 Akkumulatoren in zmm-Registern.
+*/
+__attribute__((target("avx512f")))
+static void microKernelAvx512(const M_SIZE_TYPE kc, const M_VAL_TYPE* a, const M_VAL_TYPE* b, M_VAL_TYPE* c, const M_SIZE_TYPE ldc, const bool accumulate) {
+	__m512 acc[8][2];
+	for (int i = 0; i < 8; ++i) {
+		acc[i][0] = _mm512_setzero_ps();
+		acc[i][1] = _mm512_setzero_ps();
+	}
+	for (M_SIZE_TYPE p = 0; p < kc; ++p) {
+		const __m512 b0 = _mm512_loadu_ps(b);
+		const __m512 b1 = _mm512_loadu_ps(b + 16);
+		for (int i = 0; i < 8; ++i) {
+			const __m512 ai = _mm512_set1_ps(a[i]);
+			acc[i][0] = _mm512_fmadd_ps(ai, b0, acc[i][0]);
+			acc[i][1] = _mm512_fmadd_ps(ai, b1, acc[i][1]);
+		}
+		a += 8;
+		b += 32;
+	}
+	for (int i = 0; i < 8; ++i) {
+		M_VAL_TYPE* ci = c + i * ldc;
+		if (accumulate) {
+			acc[i][0] = _mm512_add_ps(acc[i][0], _mm512_loadu_ps(ci));
+			acc[i][1] = _mm512_add_ps(acc[i][1], _mm512_loadu_ps(ci + 16));
+		}
+		_mm512_storeu_ps(ci, acc[i][0]);
+		_mm512_storeu_ps(ci + 16, acc[i][1]);
+	}
+}
+#endif
+
+/**
+*  @brief  Waehlt einmalig den schnellsten vom Prozessor unterstuetzten
+*  Mikrokernel aus. Die Spitzenleistung setzt zwei FMA-Einheiten voraus.
+*  @return Beschreibung des Mikrokernels.
+*/
+static KernelInfo selectKernel() {
+	KernelInfo info = { "scalar", 4, 4, M_VAL_IS_INTEGER ? 0 : 4, microKernelScalar };	// Ganzzahlig: keine Spitzenleistung angeben
+#if KERNEL_X86 && !M_VAL_IS_INTEGER
+	// float: doppelte Anzahl Elemente je Register (doppelte Spaltenzahl NR)
+	const unsigned lanes = M_VAL_TYPE_ID == M_TYPE_FLOAT ? 2 : 1;
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) {
+		KernelInfo avx512 = { "avx512", 8, 16 * lanes, 32 * lanes, microKernelAvx512 };
+		info = avx512;
+	}
+	else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+		KernelInfo avx2 = { "avx2", 6, 8 * lanes, 16 * lanes, microKernelAvx2 };
+		info = avx2;
+	}
+#endif
+	return info;
+}
+
+/**
+*  @brief  Liefert den zur Laufzeit ausgewaehlten Mikrokernel.
+*/
+const KernelInfo& activeKernel() {
+	static const KernelInfo info = selectKernel();
+	return info;
+}
+
+/**
+*  @brief  Berechnet die Groesse der Packpuffer fuer A (m x k) und B (k x n),
+*  aufgerundet auf ganze Mikrokacheln.
+*  @return Benoetigte Elemente.
+*/
+M_SIZE_TYPE kernelPackElements(const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	const KernelInfo& K = activeKernel();
+	const M_SIZE_TYPE mPadded = (m + K.mr - 1) / K.mr * K.mr;
+	const M_SIZE_TYPE nPadded = (n + K.nr - 1) / K.nr * K.nr;
+	return (mPadded + nPadded) * k;
+}
+
+/**
+*  @brief  Packt A (m x k) in Streifen zu je MR Zeilen, spaltenweise verschraenkt.
+*  Fehlende Zeilen am Rand werden mit 0 aufgefuellt.
+*  @param     ap  Packpuffer.
+*  @param      A  Matrix A (bei trans: k x m gespeichert).
+*  @param      m  Zeilen von op(A).
+*  @param      k  Spalten von op(A).
+*  @param  trans  op(A) = A^T (optional).
+*  @param  alpha  Faktor, mit dem A beim Packen skaliert wird (optional).
+*/
+void kernelPackA(M_VAL_TYPE* ap, const ConstMatrixView& A, const M_SIZE_TYPE& m, const M_SIZE_TYPE& k, const bool trans, const M_VAL_TYPE alpha) {
+	const M_SIZE_TYPE mr = activeKernel().mr;
+	for (M_SIZE_TYPE i0 = 0; i0 < m; i0 += mr) {
+		const M_SIZE_TYPE rows = m - i0 < mr ? m - i0 : mr;
+		for (M_SIZE_TYPE p = 0; p < k; ++p) {
+			if (trans) {
+				const M_VAL_TYPE* a = A[p] + i0;
+				for (M_SIZE_TYPE i = 0; i < rows; ++i) {
+					ap[i] = alpha * a[i];
+				}
+			}
+			else {
+				for (M_SIZE_TYPE i = 0; i < rows; ++i) {
+					ap[i] = alpha * A[i0 + i][p];
+				}
+			}
+			for (M_SIZE_TYPE i = rows; i < mr; ++i) {
+				ap[i] = 0;
+			}
+			ap += mr;
+		}
+	}
+}
+
+/**
+*  @brief  Packt B (k x n) in Streifen zu je NR Spalten, zeilenweise verschraenkt.
+*  Fehlende Spalten am Rand werden mit 0 aufgefuellt.
+*  @param     bp  Packpuffer.
+*  @param      B  Matrix B (bei trans: n x k gespeichert).
+*  @param      k  Zeilen von op(B).
+*  @param      n  Spalten von op(B).
+*  @param  trans  op(B) = B^T (optional).
+*/
+void kernelPackB(M_VAL_TYPE* bp, const ConstMatrixView& B, const M_SIZE_TYPE& k, const M_SIZE_TYPE& n, const bool trans) {
+	const M_SIZE_TYPE nr = activeKernel().nr;
+	for (M_SIZE_TYPE j0 = 0; j0 < n; j0 += nr) {
+		const M_SIZE_TYPE cols = n - j0 < nr ? n - j0 : nr;
+		for (M_SIZE_TYPE p = 0; p < k; ++p) {
+			if (trans) {
+				for (M_SIZE_TYPE j = 0; j < cols; ++j) {
+					bp[j] = B[j0 + j][p];
+				}
+			}
+			else {
+				const M_VAL_TYPE* b = B[p] + j0;
+				for (M_SIZE_TYPE j = 0; j < cols; ++j) {
+					bp[j] = b[j];
+				}
+			}
+			for (M_SIZE_TYPE j = cols; j < nr; ++j) {
+				bp[j] = 0;
+			}
+			bp += nr;
+		}
+	}
+}
+
+/**
+*  @brief  Multipliziert gepackte Operanden kachelweise mit dem Mikrokernel.
+*  Randkacheln werden in einem lokalen Puffer berechnet.
+*  @param           C  Matrix C (m x n).
+*  @param          ap  Gepacktes A (siehe kernelPackA).
+*  @param          bp  Gepacktes B (siehe kernelPackB).
+*  @param  accumulate  C += A * B (true) oder C = A * B (false).
+*/
+void kernelMacro(const MatrixView& C, const M_VAL_TYPE* ap, const M_VAL_TYPE* bp, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const bool accumulate) {
+	const KernelInfo& K = activeKernel();
+	M_VAL_TYPE edge[KERNEL_MAX_MR * KERNEL_MAX_NR];
+	for (M_SIZE_TYPE j0 = 0; j0 < n; j0 += K.nr) {
+		const M_SIZE_TYPE cols = n - j0 < K.nr ? n - j0 : K.nr;
+		const M_VAL_TYPE* b = bp + j0 * k;
+		for (M_SIZE_TYPE i0 = 0; i0 < m; i0 += K.mr) {
+			const M_SIZE_TYPE rows = m - i0 < K.mr ? m - i0 : K.mr;
+			const M_VAL_TYPE* a = ap + i0 * k;
+			if (rows == K.mr && cols == K.nr) {
+				K.kernel(k, a, b, C[i0] + j0, C.ld, accumulate);
+			}
+			else {
+				K.kernel(k, a, b, edge, K.nr, false);
+				for (M_SIZE_TYPE i = 0; i < rows; ++i) {
+					M_VAL_TYPE* c = C[i0 + i] + j0;
+					for (M_SIZE_TYPE j = 0; j < cols; ++j) {
+						c[j] = accumulate ? c[j] + edge[i * K.nr + j] : edge[i * K.nr + j];
+					}
+				}
+			}
+		}
+	}
+}
+
+/**
+*  @brief  Multipliziert A (m x k) mit B (k x n) sequentiell ueber gepackte
+*  Operanden und den Mikrokernel. Die Packpuffer stammen aus dem Workspace
+*  des ausfuehrenden Threads. Gedacht fuer Blaetter der Rekursion (k <= Cut-Off).
+*  @param           C  Matrix C (Ergebnismatrix).
+*  @param           A  Matrix A.
+*  @param           B  Matrix B.
+*  @param  accumulate  C += A * B (true) oder C = A * B (false).
+*/
+void kernelMultiply(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const bool accumulate) {
+	const KernelInfo& K = activeKernel();
+	WorkspaceFrame frame;
+	M_VAL_TYPE* ap = frame.buffer(kernelPackElements(m, n, k));
+	M_VAL_TYPE* bp = ap + (m + K.mr - 1) / K.mr * K.mr * k;
+	kernelPackA(ap, A, m, k);
+	kernelPackB(bp, B, k, n);
+	kernelMacro(C, ap, bp, m, n, k, accumulate);
+}
+
+/**
+*  @brief  Ermittelt den maximalen Prozessortakt (Linux: sysfs bzw. /proc/cpuinfo).
+*  @return Takt in GHz oder 0, falls unbekannt.
+*/
+double cpuFrequencyGHz() {
+	std::ifstream sysfs("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq");
+	double kHz = 0;
+	if (sysfs >> kHz && kHz > 0) {
+		return kHz / 1e6;
+	}
+	std::ifstream cpuinfo("/proc/cpuinfo");
+	std::string line;
+	while (std::getline(cpuinfo, line)) {
+		if (line.compare(0, 7, "cpu MHz") == 0) {
+			const std::string::size_type colon = line.find(':');
+			if (colon != std::string::npos) {
+				return atof(line.c_str() + colon + 1) / 1e3;
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+*  @brief  Misst die Leistung des Mikrokernels fuer eine n x n Multiplikation
+*  auf einem Kern (wiederholt, bis KERNEL_BENCH_SECONDS erreicht sind).
+*  @param  n  Matrixdimension (NxN), z. B. der Cut-Off.
+*  @return GFLOP/s.
+*/
+double kernelBenchmark(const M_SIZE_TYPE& n) {
+	InnerArray a(n * n, 1), b(n * n, 1), c(n * n, 0);
+	const MatrixView C(&c[0], n, n);
+	const ConstMatrixView A(&a[0], n, n);
+	const ConstMatrixView B(&b[0], n, n);
+	kernelMultiply(C, A, B, n);
+	unsigned long runs = 0;
+	const tbb::tick_count t0 = tbb::tick_count::now();
+	double seconds = 0;
+	do {
+		kernelMultiply(C, A, B, n);
+		++runs;
+		seconds = (tbb::tick_count::now() - t0).seconds();
+	} while (seconds < KERNEL_BENCH_SECONDS);
+	return 2.0 * n * n * n * runs / seconds / 1e9;
+}
+
+} // namespace M_VAL_NAMESPACE
@@ -0,0 +1,65 @@
+//============================================================================
+// Name        : Kernel.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef KERNEL_H_
+#define KERNEL_H_
+
+#include "Definitions.h"
+
+namespace M_VAL_NAMESPACE {
+
+/**
+*  @brief  Mikrokernel: Berechnet einen MR x NR Block von C aus einem gepackten
+*  A-Streifen (MR Zeilen) und einem gepackten B-Streifen (NR Spalten) der
+*  Laenge kc. Bei accumulate == false wird der Block ueberschrieben.
+*/
+typedef void (*MicroKernel)(const M_SIZE_TYPE kc, const M_VAL_TYPE* a, const M_VAL_TYPE* b, M_VAL_TYPE* c, const M_SIZE_TYPE ldc, const bool accumulate);
+
+/**
+*  @brief  Beschreibt den zur Laufzeit ausgewaehlten Mikrokernel.
+*/
+struct KernelInfo {
+	const char* name;					// Befehlssatz (z. B. "avx512")
+	M_SIZE_TYPE mr;						// Zeilen je Mikrokachel (Register-Blockung)
+	M_SIZE_TYPE nr;						// Spalten je Mikrokachel (Register-Blockung)
+	unsigned flopsPerCycle;				// Theoretische Spitzenleistung je Kern und Takt
+	MicroKernel kernel;
+};
+
+const KernelInfo& activeKernel();
+
+M_SIZE_TYPE kernelPackElements(const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k);
+
+void kernelPackA(M_VAL_TYPE* ap, const ConstMatrixView& A, const M_SIZE_TYPE& m, const M_SIZE_TYPE& k, const bool trans = false, const M_VAL_TYPE alpha = 1);
+
+void kernelPackB(M_VAL_TYPE* bp, const ConstMatrixView& B, const M_SIZE_TYPE& k, const M_SIZE_TYPE& n, const bool trans = false);
+
+void kernelMacro(const MatrixView& C, const M_VAL_TYPE* ap, const M_VAL_TYPE* bp, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const bool accumulate);
+
+void kernelMultiply(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const bool accumulate = false);
+
+/**
+*  @brief  Multipliziert zwei quadratische Matrizen mit dem Mikrokernel (C = A * B).
+*  @param  C  Matrix C (Ergebnismatrix, wird ueberschrieben).
+*  @param  A  Matrix A.
+*  @param  B  Matrix B.
+*  @param  n  Matrixdimension (NxN).
+*/
+inline void kernelMultiply(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
+	kernelMultiply(C, A, B, n, n, n, false);
+}
+
+double cpuFrequencyGHz();
+
+double kernelBenchmark(const M_SIZE_TYPE& n);
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
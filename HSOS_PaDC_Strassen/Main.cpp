@@ -10,16 +10,9 @@
 
 #include "Definitions.h"
 #include "Helper.h"
-#include "Matrix.h"
-#include "Strassen.h"
-#include <tbb/blocked_range2d.h>
-#include <tbb/parallel_for.h>
-#include <tbb/task.h>
+#include "MatrixFile.h"
+#include "Run.h"
 #include <tbb/task_scheduler_init.h>
-#include <tbb/tick_count.h>
-#include <vector>
-
-using namespace tbb;
 
 /**
 *  @brief  Main-Methode zum Ausfuehren der Algorithmen.
@@ -30,70 +23,34 @@ int main(int argc, char* argv[]) {
 	if (result != 0) {
 		return result;
 	}
-	tbb::task_scheduler_init init(NO_THREADS);
-	std::cout << "Threads:\t" << NO_THREADS << "\n";
-	std::cout << "Dimension:\t" << M_SIZE << " x " << M_SIZE << "\n";
-	std::cout << "Cut-Off:\t" << CUT_OFF << "\n";
-
-	tick_count t0, t1;
-	Matrix A(M_SIZE, InnerArray(M_SIZE));
-	Matrix B(M_SIZE, InnerArray(M_SIZE));
-	Matrix C1(M_SIZE, InnerArray(M_SIZE));
-	Matrix C2(M_SIZE, InnerArray(M_SIZE));
-
-	initRandomizer();
-	initializeRandpriomMatrix(A, M_SIZE);
-	initializeRandpriomMatrix(B, M_SIZE);
-
-	printMatrix(A, "A");
-	printMatrix(B, "B");
-
-	// Naiv
-	if (RUN_NAIV_SEQ != 0) {
-		resetValuesMatrix(C2, M_SIZE);
-		t0 = tick_count::now();
-		matrixMultSeq(C2, A, B, M_SIZE);
-		t1 = tick_count::now();
-		printMatrix(C2, "C2 = A * B");
-		std::cout << "Naiv Seq:\tTime was " << (t1 - t0).seconds() << "s - Naiv\n";
+	// Benchmark-Modus: Scheduler fuer die groesste Thread-Anzahl (Faelle laufen in task_arenas)
+	for (size_t t = 0; t < BENCH_THREADS.size(); ++t) {
+		NO_THREADS = BENCH_THREADS[t] > NO_THREADS ? (unsigned) BENCH_THREADS[t] : NO_THREADS;
 	}
-
-	// Naiv-Parallel
-	if (RUN_NAIV_PAR != 0) {
-		resetValuesMatrix(C2, M_SIZE);
-		t0 = tick_count::now();
-		parallel_for(blocked_range2d<M_SIZE_TYPE>(0, M_SIZE, 0, M_SIZE), MatrixMultPBody(C2, A, B, M_SIZE));
-		t1 = tick_count::now();
-		printMatrix(C2, "C2 = A * B");
-		std::cout << "Naiv Par:\tTime was " << (t1 - t0).seconds() << "s - Naiv-Parallel\n";
-	}
-
-	// Strassen-Algorithmus: Non-Tasks
-	if (RUN_STRASSEN_SEQ != 0) {
-		resetValuesMatrix(C1, M_SIZE);
-		t0 = tick_count::now();
-		strassenRecursive(C1, A, B, M_SIZE);
-		t1 = tick_count::now();
-		printMatrix(C1, "C1 = A * B");
-		std::cout << "Strassen Seq:\tTime was " << (t1 - t0).seconds() << "s - Strassen-Alg.: Non-Tasks\n";
-		if (RUN_NAIV_PAR) {
-			compareMatrices(C1, C2, M_SIZE) ? std::cout << "Num stability:\tSome differences!\n" : std::cout << "Num stability:\tOK\n";
+	tbb::task_scheduler_init init(NO_THREADS);
+	// Matrixdateien: Werttyp aus dem Kopf von A (neu angelegte Dateien: -d)
+	if (MATRIX_FILE_A != NULL && MATRIX_FILE_TILE < 0) {
+		MatrixFileHeader header;
+		std::string error;
+		if (!readMatrixFileHeader(MATRIX_FILE_A, header, error)) {
+			std::cerr << error << "\n";
+			return 1;
 		}
+		M_VAL_TYPE_SELECT = header.type;
 	}
-
-	// Strassen-Algorithmus: Tasks
-	if (RUN_STRASSEN_PAR != 0) {
-		resetValuesMatrix(C1, M_SIZE);
-		t0 = tick_count::now();
-		task::spawn_root_and_wait(*new (task::allocate_root()) Strassen(C1, A, B, M_SIZE));
-		t1 = tick_count::now();
-		printMatrix(C1, "C1 = A * B");
-		std::cout << "Strassen Par:\tTime was " << (t1 - t0).seconds() << "s - Strassen-Alg.: Tasks\n";
-		if (RUN_NAIV_PAR) {
-			compareMatrices(C1, C2, M_SIZE) ? std::cout << "Num stability:\tSome differences!\n" : std::cout << "Num stability:\tOK\n";
-		}
+	initRandomizer();
+	std::cout << "Threads:\t" << NO_THREADS << "\n";
+	std::cout << "Type:\t\t" << M_VAL_TYPE_NAMES[M_VAL_TYPE_SELECT] << "\n";
+	std::cout << "Seed:\t\t" << RANDOM_SEED << "\n";
+
+	switch (M_VAL_TYPE_SELECT) {
+	case M_TYPE_FLOAT:
+		return strassen_float::run();
+	case M_TYPE_INT32:
+		return strassen_int32::run();
+	case M_TYPE_INT64:
+		return strassen_int64::run();
+	default:
+		return strassen_double::run();
 	}
-
-	std::cout << "\n\nEND\n" ;
-	return 0;
 }
@@ -0,0 +1,55 @@
+//============================================================================
+// Name        : MainMpi.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Definitions.h"
+#include "Helper.h"
+#include "RunMpi.h"
+#include <mpi.h>
+#include <tbb/task_scheduler_init.h>
+
+/**
+*  @brief  Main-Methode des MPI-Programms (ein Prozess je Rang, je Prozess
+*  NO_THREADS tbb-Threads; siehe Distributed.h).
+*/
+int main(int argc, char* argv[]) {
+	int provided, rank;
+	MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	NO_THREADS = tbb::task_scheduler_init::default_num_threads();
+	int result = init_arguments(argc, argv);
+	if (result == 0) {
+		tbb::task_scheduler_init init(NO_THREADS);
+		// Alle Prozesse muessen dieselben Matrizen erzeugen
+		initRandomizer();
+		MPI_Bcast(&RANDOM_SEED, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+		if (rank == 0) {
+			std::cout << "Threads:\t" << NO_THREADS << " per process\n";
+			std::cout << "Type:\t\t" << M_VAL_TYPE_NAMES[M_VAL_TYPE_SELECT] << "\n";
+			std::cout << "Seed:\t\t" << RANDOM_SEED << "\n";
+		}
+
+		switch (M_VAL_TYPE_SELECT) {
+		case M_TYPE_FLOAT:
+			result = strassen_float::runDistributed();
+			break;
+		case M_TYPE_INT32:
+			result = strassen_int32::runDistributed();
+			break;
+		case M_TYPE_INT64:
+			result = strassen_int64::runDistributed();
+			break;
+		default:
+			result = strassen_double::runDistributed();
+			break;
+		}
+	}
+	MPI_Finalize();
+	return result;
+}
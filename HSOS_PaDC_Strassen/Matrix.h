@@ -12,17 +12,38 @@
 #define MATRIX_H_
 
 #include "Definitions.h"
+#include "Trace.h"
 #include <tbb/blocked_range2d.h>
 #include <tbb/parallel_for.h>
 
+namespace M_VAL_NAMESPACE {
+
+#define PARALLEL_ADD_THRESHOLD 256		// Ab dieser Dimension werden Additionen und Kombination in Tasks parallelisiert
+#define PARALLEL_ADD_GRAIN 16			// Zeilen je Teilbereich der parallelen Additionen
+
 /**
- *  @brief  Subtrahiert Matrix B von Matrix A sequentiell.
+ *  @brief  Setzt alle Werte einer Matrix sequentiell auf 0.
+ *  @param  C  Matrix C.
+ *  @param  n  Matrixdimension (NxN).
+ */
+inline void matrixZeroSeq(const MatrixView& C, const M_SIZE_TYPE& n) {
+	for (M_SIZE_TYPE i = 0; i < n; ++i) {
+		for (M_SIZE_TYPE j = 0; j < n; ++j) {
+			C[i][j] = 0;
+		}
+	}
+}
+
+/**
+ *  @brief  Subtrahiert Matrix B von Matrix A sequentiell. Alle Matrizen
+ *  werden als Sicht uebergeben und duerfen Quadranten groesserer Matrizen sein.
  *  @param  C  Matrix C (Ergebnismatrix).
  *  @param  A  Matrix A.
  *  @param  B  Matrix B.
  *  @param  n  Matrixdimension (NxN).
  */
-inline void matrixSubSeq(Matrix& C, const Matrix& A, const Matrix& B, const M_SIZE_TYPE& n) {
+inline void matrixSubSeq(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
+	TRACE_SCOPE(TRACE_ADD, n, 3.0 * n * n * sizeof(M_VAL_TYPE), (double) n * n);
 	for (M_SIZE_TYPE i = 0; i < n; ++i) {
 		for (M_SIZE_TYPE j = 0; j < n; ++j) {
 			C[i][j] = A[i][j] - B[i][j];
@@ -37,7 +58,8 @@ inline void matrixSubSeq(Matrix& C, const Matrix& A, const Matrix& B, const M_SI
  *  @param  B  Matrix B.
  *  @param  n  Matrixdimension (NxN).
  */
-inline void matrixAddSeq(Matrix& C, const Matrix& A, const Matrix& B, const M_SIZE_TYPE& n) {
+inline void matrixAddSeq(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
+	TRACE_SCOPE(TRACE_ADD, n, 3.0 * n * n * sizeof(M_VAL_TYPE), (double) n * n);
 	for (M_SIZE_TYPE i = 0; i < n; ++i) {
 		for (M_SIZE_TYPE j = 0; j < n; ++j) {
 			C[i][j] = A[i][j] + B[i][j];
@@ -45,6 +67,55 @@ inline void matrixAddSeq(Matrix& C, const Matrix& A, const Matrix& B, const M_SI
 	}
 }
 
+/**
+ *  @brief  Subtrahiert Matrix B von Matrix A sequentiell (rechteckig).
+ *  @param     C  Matrix C (Ergebnismatrix).
+ *  @param     A  Matrix A.
+ *  @param     B  Matrix B.
+ *  @param  rows  Anzahl der Zeilen.
+ *  @param  cols  Anzahl der Spalten.
+ */
+inline void matrixSubSeq(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols) {
+	TRACE_SCOPE(TRACE_ADD, rows > cols ? rows : cols, 3.0 * rows * cols * sizeof(M_VAL_TYPE), (double) rows * cols);
+	for (M_SIZE_TYPE i = 0; i < rows; ++i) {
+		for (M_SIZE_TYPE j = 0; j < cols; ++j) {
+			C[i][j] = A[i][j] - B[i][j];
+		}
+	}
+}
+
+/**
+ *  @brief  Addiert Matrix B zu Matrix A sequentiell (rechteckig).
+ *  @param     C  Matrix C (Ergebnismatrix).
+ *  @param     A  Matrix A.
+ *  @param     B  Matrix B.
+ *  @param  rows  Anzahl der Zeilen.
+ *  @param  cols  Anzahl der Spalten.
+ */
+inline void matrixAddSeq(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols) {
+	TRACE_SCOPE(TRACE_ADD, rows > cols ? rows : cols, 3.0 * rows * cols * sizeof(M_VAL_TYPE), (double) rows * cols);
+	for (M_SIZE_TYPE i = 0; i < rows; ++i) {
+		for (M_SIZE_TYPE j = 0; j < cols; ++j) {
+			C[i][j] = A[i][j] + B[i][j];
+		}
+	}
+}
+
+/**
+ *  @brief  Kopiert Matrix A sequentiell nach Matrix C (rechteckig).
+ *  @param     C  Matrix C (Zielmatrix).
+ *  @param     A  Matrix A.
+ *  @param  rows  Anzahl der Zeilen.
+ *  @param  cols  Anzahl der Spalten.
+ */
+inline void matrixCopySeq(const MatrixView& C, const ConstMatrixView& A, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols) {
+	for (M_SIZE_TYPE i = 0; i < rows; ++i) {
+		for (M_SIZE_TYPE j = 0; j < cols; ++j) {
+			C[i][j] = A[i][j];
+		}
+	}
+}
+
 /**
  *  @brief  Multipliziert Matrix B mit Matrix A sequentiell.
  *  @param  C  Matrix C (Ergebnismatrix).
@@ -52,7 +123,7 @@ inline void matrixAddSeq(Matrix& C, const Matrix& A, const Matrix& B, const M_SI
  *  @param  B  Matrix B.
  *  @param  n  Matrixdimension (NxN).
  */
-inline void matrixMultSeq(Matrix& C, const Matrix& A, const Matrix& B, const M_SIZE_TYPE& n) {
+inline void matrixMultSeq(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
 #if USE_IKJ
 	for (M_SIZE_TYPE i = 0; i < n; ++i) {
 		for (M_SIZE_TYPE k = 0; k < n; ++k) {
@@ -78,11 +149,11 @@ inline void matrixMultSeq(Matrix& C, const Matrix& A, const Matrix& B, const M_S
  *  Wird von den nachfolgenden Klassen vererbt.
  */
 struct MatrixPBody {
-	Matrix& C;
-	const Matrix& A;
-	const Matrix& B;
+	MatrixView C;
+	ConstMatrixView A;
+	ConstMatrixView B;
 
-	MatrixPBody(Matrix& __C, const Matrix& __A, const Matrix& __B) :
+	MatrixPBody(const MatrixView& __C, const ConstMatrixView& __A, const ConstMatrixView& __B) :
 			C(__C), A(__A), B(__B) {
 	}
 };
@@ -91,7 +162,7 @@ struct MatrixPBody {
  *  @brief  Funktionsobjekt zum parallelisierten Subtrahieren.
  */
 struct MatrixSubPBody: public MatrixPBody {
-	MatrixSubPBody(Matrix& __C, const Matrix& __A, const Matrix& __B) : MatrixPBody(__C, __A, __B) { }
+	MatrixSubPBody(const MatrixView& __C, const ConstMatrixView& __A, const ConstMatrixView& __B) : MatrixPBody(__C, __A, __B) { }
 
 	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
 		for (M_SIZE_TYPE i = range.rows().begin(); i != range.rows().end(); ++i) {
@@ -106,7 +177,7 @@ struct MatrixSubPBody: public MatrixPBody {
  *  @brief  Funktionsobjekt zum parallelisierten Addieren.
  */
 struct MatrixAddPBody: public MatrixPBody {
-	MatrixAddPBody(Matrix& __C, const Matrix& __A, const Matrix& __B) : MatrixPBody(__C, __A, __B) { }
+	MatrixAddPBody(const MatrixView& __C, const ConstMatrixView& __A, const ConstMatrixView& __B) : MatrixPBody(__C, __A, __B) { }
 
 	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
 		for (M_SIZE_TYPE i = range.rows().begin(); i != range.rows().end(); ++i) {
@@ -118,23 +189,98 @@ struct MatrixAddPBody: public MatrixPBody {
 };
 
 /**
- *  @brief  Funktionsobjekt zum parallelisierten Multiplizieren.
+ *  @brief  Funktionsobjekt zum Aufsummieren eines Produkts: C = sign * M
+ *  (erster Beitrag) bzw. C += sign * M.
  */
-struct MatrixMultPBody: public MatrixPBody {
-	const M_SIZE_TYPE& n;
+struct MatrixAccumulatePBody {
+	MatrixView C;
+	ConstMatrixView M;
+	int sign;
+	bool first;
 
-	MatrixMultPBody(Matrix& __C, const Matrix& __A, const Matrix& __B, const M_SIZE_TYPE& __n) : MatrixPBody(__C, __A, __B), n(__n) { }
+	MatrixAccumulatePBody(const MatrixView& __C, const ConstMatrixView& __M, const int __sign, const bool __first) : C(__C), M(__M), sign(__sign), first(__first) { }
 
 	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
 		for (M_SIZE_TYPE i = range.rows().begin(); i != range.rows().end(); ++i) {
-			for (M_SIZE_TYPE k = 0; k < n; ++k) {
-				const M_VAL_TYPE a = A[i][k];
-				for (M_SIZE_TYPE j = range.cols().begin(); j != range.cols().end(); ++j) {
-					C[i][j] += a * B[k][j];
-				}
+			for (M_SIZE_TYPE j = range.cols().begin(); j != range.cols().end(); ++j) {
+				const M_VAL_TYPE value = sign > 0 ? M[i][j] : -M[i][j];
+				C[i][j] = first ? value : C[i][j] + value;
 			}
 		}
 	}
 };
 
+/**
+ *  @brief  Fuehrt ein elementweises Funktionsobjekt ueber rows x cols aus.
+ *  Ab PARALLEL_ADD_THRESHOLD^2 Elementen wird zeilenweise mit parallel_for
+ *  aufgeteilt, darunter laeuft das Funktionsobjekt direkt im aufrufenden Task.
+ *  @param  body  Funktionsobjekt mit operator()(blocked_range2d).
+ *  @param  rows  Anzahl der Zeilen.
+ *  @param  cols  Anzahl der Spalten.
+ */
+template <typename Body>
+inline void matrixApplyPar(const Body& body, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols) {
+	if (rows == 0 || cols == 0) {
+		return;
+	}
+	const tbb::blocked_range2d<M_SIZE_TYPE> range(0, rows, PARALLEL_ADD_GRAIN, 0, cols, cols);
+	if (rows * cols >= (M_SIZE_TYPE) PARALLEL_ADD_THRESHOLD * PARALLEL_ADD_THRESHOLD) {
+		tbb::parallel_for(range, body);
+	}
+	else {
+		body(range);
+	}
+}
+
+/**
+ *  @brief  Wie matrixApplyPar, fuer das Zusammensetzen der Quadranten aus den
+ *  Produkten; wird als Phase TRACE_COMBINE erfasst.
+ *  @param      body  Funktionsobjekt mit operator()(blocked_range2d).
+ *  @param      rows  Anzahl der Zeilen.
+ *  @param      cols  Anzahl der Spalten.
+ *  @param  accesses  Gelesene und geschriebene Elemente je Position.
+ *  @param     flops  Additionen je Position.
+ */
+template <typename Body>
+inline void matrixCombinePar(const Body& body, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols, const int accesses, const int flops) {
+	TRACE_SCOPE(TRACE_COMBINE, rows > cols ? rows : cols, (double) accesses * rows * cols * sizeof(M_VAL_TYPE), (double) flops * rows * cols);
+	matrixApplyPar(body, rows, cols);
+}
+
+/**
+ *  @brief  Subtrahiert Matrix B von Matrix A, ab PARALLEL_ADD_THRESHOLD parallel.
+ *  @param     C  Matrix C (Ergebnismatrix).
+ *  @param     A  Matrix A.
+ *  @param     B  Matrix B.
+ *  @param  rows  Anzahl der Zeilen.
+ *  @param  cols  Anzahl der Spalten.
+ */
+inline void matrixSubPar(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols) {
+	TRACE_SCOPE(TRACE_ADD, rows > cols ? rows : cols, 3.0 * rows * cols * sizeof(M_VAL_TYPE), (double) rows * cols);
+	matrixApplyPar(MatrixSubPBody(C, A, B), rows, cols);
+}
+
+inline void matrixSubPar(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
+	matrixSubPar(C, A, B, n, n);
+}
+
+/**
+ *  @brief  Addiert Matrix B zu Matrix A, ab PARALLEL_ADD_THRESHOLD parallel.
+ *  @param     C  Matrix C (Ergebnismatrix).
+ *  @param     A  Matrix A.
+ *  @param     B  Matrix B.
+ *  @param  rows  Anzahl der Zeilen.
+ *  @param  cols  Anzahl der Spalten.
+ */
+inline void matrixAddPar(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols) {
+	TRACE_SCOPE(TRACE_ADD, rows > cols ? rows : cols, 3.0 * rows * cols * sizeof(M_VAL_TYPE), (double) rows * cols);
+	matrixApplyPar(MatrixAddPBody(C, A, B), rows, cols);
+}
+
+inline void matrixAddPar(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
+	matrixAddPar(C, A, B, n, n);
+}
+
+} // namespace M_VAL_NAMESPACE
+
 #endif
@@ -0,0 +1,233 @@
+//============================================================================
+// Name        : MatrixFile.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "MatrixFile.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+*  @brief  Groesse eines Elements des Werttyps in Bytes (0: unbekannt).
+*/
+size_t matrixFileElementSize(const int type) {
+	switch (type) {
+	case M_TYPE_FLOAT:
+	case M_TYPE_INT32:
+		return 4;
+	case M_TYPE_DOUBLE:
+	case M_TYPE_INT64:
+		return 8;
+	default:
+		return 0;
+	}
+}
+
+const char* matrixFileLayoutName(const int layout) {
+	return layout == MATRIX_FILE_TILED ? "tiled (Morton)" : "row-major";
+}
+
+/**
+*  @brief  Prueft einen Kopf auf Konsistenz.
+*  @return Leerer String, falls gueltig, sonst der Grund.
+*/
+static std::string checkHeader(const MatrixFileHeader& h) {
+	if (memcmp(h.magic, MATRIX_FILE_MAGIC, sizeof(h.magic)) != 0) {
+		return "not a matrix file";
+	}
+	if (h.endian != MATRIX_FILE_ENDIAN) {
+		return "written with a different byte order";
+	}
+	if (h.version != MATRIX_FILE_VERSION) {
+		return "unsupported version";
+	}
+	if (matrixFileElementSize(h.type) == 0) {
+		return "unknown element type";
+	}
+	if (h.rows == 0 || h.cols == 0 || h.dataOffset < sizeof(MatrixFileHeader) || h.dataOffset % MATRIX_FILE_ALIGN != 0) {
+		return "invalid dimensions or data offset";
+	}
+
+	// Vor dem Ausmultiplizieren pruefen: ein beschaedigter Kopf darf weder den
+	// Indextyp noch die Byteanzahl (dataOffset + rows * width * size) ueberlaufen
+	const uint64_t limit = (uint64_t) std::numeric_limits<M_SIZE_TYPE>::max();
+	if (h.rows > limit || h.cols > limit || h.ld > limit || h.tile > limit) {
+		return "dimensions exceed the index type";
+	}
+	const uint64_t most = std::numeric_limits<uint64_t>::max();
+	const uint64_t size = matrixFileElementSize(h.type);
+	const uint64_t width = h.layout == MATRIX_FILE_TILED ? h.cols : h.ld;
+	if (width > most / size || (width != 0 && h.rows > (most - h.dataOffset) / (width * size))
+			|| h.dataOffset + h.rows * width * size > (uint64_t) std::numeric_limits<size_t>::max()) {
+		return "data size overflows";
+	}
+	if (h.layout == MATRIX_FILE_ROW_MAJOR) {
+		return h.ld >= h.cols ? "" : "row stride below the number of columns";
+	}
+	if (h.layout == MATRIX_FILE_TILED) {
+		const uint64_t tiles = h.tile != 0 && h.cols % h.tile == 0 ? h.cols / h.tile : 0;
+		return h.rows == h.cols && tiles != 0 && (tiles & (tiles - 1)) == 0 ? "" : "tiled layout needs a square matrix with n / tile = 2^k";
+	}
+	return "unknown layout";
+}
+
+/**
+*  @brief  Benoetigte Bytes der Daten laut Kopf (nur nach checkHeader, das
+*  einen Ueberlauf ausschliesst).
+*/
+static uint64_t headerDataBytes(const MatrixFileHeader& h) {
+	return h.rows * (h.layout == MATRIX_FILE_TILED ? h.cols : h.ld) * matrixFileElementSize(h.type);
+}
+
+/**
+*  @brief  Liest nur den Kopf einer Matrixdatei (z. B. zur Wahl des Werttyps).
+*  @param    path  Pfad der Datei.
+*  @param  header  Gelesener Kopf.
+*  @param   error  Grund, falls die Datei ungueltig ist.
+*  @return true bei Erfolg.
+*/
+bool readMatrixFileHeader(const char* path, MatrixFileHeader& header, std::string& error) {
+	const int fd = ::open(path, O_RDONLY);
+	if (fd < 0) {
+		error = std::string(path) + ": " + strerror(errno);
+		return false;
+	}
+	const ssize_t bytes = read(fd, &header, sizeof(header));
+	::close(fd);
+	error = bytes == (ssize_t) sizeof(header) ? checkHeader(header) : "file too short";
+	if (!error.empty()) {
+		error = std::string(path) + ": " + error;
+		return false;
+	}
+	return true;
+}
+
+MatrixFile::MatrixFile() : base(NULL), length(0) {
+	memset(&head, 0, sizeof(head));
+}
+
+MatrixFile::~MatrixFile() {
+	close();
+}
+
+bool MatrixFile::fail(const std::string& path, const std::string& reason) {
+	close();
+	message = path + ": " + reason;
+	return false;
+}
+
+/**
+*  @brief  Blendet eine vorhandene Matrixdatei ein (ohne die Daten zu lesen).
+*  @param      path  Pfad der Datei.
+*  @param  writable  Schreibend einblenden (Aenderungen gehen in die Datei).
+*  @return true bei Erfolg, sonst siehe error().
+*/
+bool MatrixFile::open(const char* path, const bool writable) {
+	close();
+	const int fd = ::open(path, writable ? O_RDWR : O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		const std::string reason = strerror(errno);
+		if (fd >= 0) {
+			::close(fd);
+		}
+		return fail(path, reason);
+	}
+	if ((size_t) st.st_size < sizeof(MatrixFileHeader)) {
+		::close(fd);
+		return fail(path, "file too short");
+	}
+	void* p = mmap(NULL, st.st_size, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, fd, 0);
+	::close(fd);
+	if (p == MAP_FAILED) {
+		return fail(path, strerror(errno));
+	}
+	base = (char*) p;
+	length = st.st_size;
+	memcpy(&head, base, sizeof(head));
+	const std::string reason = checkHeader(head);
+	if (!reason.empty()) {
+		return fail(path, reason);
+	}
+	if (head.dataOffset + headerDataBytes(head) > length) {
+		return fail(path, "file shorter than its header claims");
+	}
+	return true;
+}
+
+/**
+*  @brief  Legt eine Matrixdatei an (vorhandene Dateien werden ersetzt) und
+*  blendet sie schreibend ein. Die Daten sind mit 0 initialisiert, die Engine
+*  schreibt das Ergebnis direkt in die Einblendung.
+*  @param    path  Pfad der Datei.
+*  @param    type  Werttyp (M_TYPE_*).
+*  @param    rows  Zeilen.
+*  @param    cols  Spalten.
+*  @param  layout  MATRIX_FILE_ROW_MAJOR oder MATRIX_FILE_TILED.
+*  @param    tile  Kachelgroesse (nur MATRIX_FILE_TILED).
+*  @return true bei Erfolg, sonst siehe error().
+*/
+bool MatrixFile::create(const char* path, const int type, const uint64_t rows, const uint64_t cols, const int layout, const uint64_t tile) {
+	close();
+	MatrixFileHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, MATRIX_FILE_MAGIC, sizeof(h.magic));
+	h.version = MATRIX_FILE_VERSION;
+	h.endian = MATRIX_FILE_ENDIAN;
+	h.type = type;
+	h.layout = layout;
+	h.rows = rows;
+	h.cols = cols;
+	h.ld = cols;
+	h.tile = layout == MATRIX_FILE_TILED ? tile : 0;
+	h.dataOffset = MATRIX_FILE_ALIGN;
+	const std::string reason = checkHeader(h);
+	if (!reason.empty()) {
+		return fail(path, reason);
+	}
+
+	const int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	const size_t bytes = h.dataOffset + headerDataBytes(h);
+	if (fd < 0 || ftruncate(fd, bytes) != 0) {
+		const std::string error = strerror(errno);
+		if (fd >= 0) {
+			::close(fd);
+		}
+		return fail(path, error);
+	}
+	void* p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (p == MAP_FAILED) {
+		return fail(path, strerror(errno));
+	}
+	base = (char*) p;
+	length = bytes;
+	head = h;
+	memcpy(base, &head, sizeof(head));
+	return true;
+}
+
+/**
+*  @brief  Schreibt geaenderte Seiten synchron in die Datei.
+*/
+bool MatrixFile::sync() {
+	return base == NULL || msync(base, length, MS_SYNC) == 0;
+}
+
+void MatrixFile::close() {
+	if (base != NULL) {
+		munmap(base, length);
+		base = NULL;
+		length = 0;
+	}
+}
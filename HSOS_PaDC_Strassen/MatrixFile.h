@@ -0,0 +1,123 @@
+//============================================================================
+// Name        : MatrixFile.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef MATRIXFILE_H_
+#define MATRIXFILE_H_
+
+#include "Definitions.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#define MATRIX_FILE_MAGIC "HSOSMAT"			// Kennung (8 Bytes inkl. '\0')
+#define MATRIX_FILE_VERSION 1
+#define MATRIX_FILE_ENDIAN 0x01020304U		// Erkennung der Byte-Reihenfolge
+#define MATRIX_FILE_ALIGN 4096				// Beginn der Daten (Seitengrenze)
+#define MATRIX_FILE_ROW_MAJOR 0				// Zeilenweise, Zeilenabstand ld Elemente
+#define MATRIX_FILE_TILED 1					// Morton-Layout aus Kacheln tile x tile (siehe Morton.h)
+
+/*
+ * Binaeres Matrixformat fuer den Austausch mit vor- und nachgelagerten Jobs:
+ * Auf den Kopf (MatrixFileHeader, 64 Bytes, native Byte-Reihenfolge) folgen
+ * ab dataOffset (Vielfaches von MATRIX_FILE_ALIGN) die Elemente ohne
+ * weitere Kodierung, wahlweise zeilenweise (rows x ld, ld >= cols) oder im
+ * Morton-Layout der Engine (quadratisch, cols / tile = 2^k; Kachel (i, j)
+ * liegt zeilenweise ab Element mortonIndex(i, j) * tile^2). Da die Daten
+ * seitenweise ausgerichtet sind, arbeitet die Engine per mmap direkt auf der
+ * Datei (kein Parsen, keine Kopie); Ergebnisse werden ebenso in eine per
+ * mmap angelegte Datei geschrieben. Typunabhaengig (nur einmal uebersetzt),
+ * die Sichten je Werttyp liefert matrixFileView.
+ */
+
+/**
+*  @brief  Kopf einer Matrixdatei (64 Bytes).
+*/
+struct MatrixFileHeader {
+	char magic[8];						// MATRIX_FILE_MAGIC
+	uint32_t version;					// MATRIX_FILE_VERSION
+	uint32_t endian;					// MATRIX_FILE_ENDIAN
+	uint32_t type;						// Werttyp (M_TYPE_*)
+	uint32_t layout;					// MATRIX_FILE_ROW_MAJOR bzw. MATRIX_FILE_TILED
+	uint64_t rows;						// Zeilen
+	uint64_t cols;						// Spalten
+	uint64_t ld;						// Zeilenabstand in Elementen (Morton: cols)
+	uint64_t tile;						// Kachelgroesse (Morton; zeilenweise: 0)
+	uint64_t dataOffset;				// Beginn der Daten in Bytes
+};
+
+/**
+*  @brief  Per mmap eingeblendete Matrixdatei (nicht kopierbar).
+*/
+class MatrixFile {
+	MatrixFileHeader head;				// Kopf (Kopie aus der Datei)
+	char* base;							// Beginn der Einblendung (NULL: geschlossen)
+	size_t length;						// Laenge der Einblendung in Bytes
+	std::string message;				// Grund des letzten Fehlers
+
+	MatrixFile(const MatrixFile&);
+	MatrixFile& operator=(const MatrixFile&);
+
+	bool fail(const std::string& path, const std::string& reason);
+
+public:
+	MatrixFile();
+
+	~MatrixFile();
+
+	bool open(const char* path, const bool writable = false);
+
+	bool create(const char* path, const int type, const uint64_t rows, const uint64_t cols, const int layout, const uint64_t tile = 0);
+
+	bool sync();
+
+	void close();
+
+	const MatrixFileHeader& header() const {
+		return head;
+	}
+
+	void* data() const {
+		return base + head.dataOffset;
+	}
+
+	size_t dataBytes() const {
+		return length - head.dataOffset;
+	}
+
+	const std::string& error() const {
+		return message;
+	}
+};
+
+size_t matrixFileElementSize(const int type);
+
+bool readMatrixFileHeader(const char* path, MatrixFileHeader& header, std::string& error);
+
+const char* matrixFileLayoutName(const int layout);
+
+namespace M_VAL_NAMESPACE {
+
+/**
+*  @brief  Sicht der Engine auf die Daten einer Matrixdatei (ohne Kopie).
+*  Zeilenweise rechteckige Dateien liefern wie block() n = 0.
+*  @param  file  Geoeffnete Datei des Werttyps M_VAL_TYPE.
+*/
+inline MatrixView matrixFileView(const MatrixFile& file) {
+	const MatrixFileHeader& h = file.header();
+	const M_SIZE_TYPE n = h.rows == h.cols ? (M_SIZE_TYPE) h.cols : 0;
+	if (h.layout == MATRIX_FILE_TILED) {
+		return MatrixView((M_VAL_TYPE*) file.data(), (M_SIZE_TYPE) h.cols, n, (M_SIZE_TYPE) h.tile);
+	}
+	return MatrixView((M_VAL_TYPE*) file.data(), (M_SIZE_TYPE) h.ld, n);
+}
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
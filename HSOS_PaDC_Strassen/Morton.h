@@ -0,0 +1,127 @@
+//============================================================================
+// Name        : Morton.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef MORTON_H_
+#define MORTON_H_
+
+#include "Definitions.h"
+#include <tbb/blocked_range2d.h>
+#include <tbb/parallel_for.h>
+
+namespace M_VAL_NAMESPACE {
+
+/**
+ *  @brief  Berechnet die Position einer Kachel in Z-Ordnung, indem die Bits
+ *  von Zeilen- und Spaltenindex verschraenkt werden (Zeile hoeherwertig).
+ *  @param  row  Zeilenindex der Kachel.
+ *  @param  col  Spaltenindex der Kachel.
+ *  @return Index der Kachel im Morton-Layout.
+ */
+inline M_SIZE_TYPE mortonIndex(const M_SIZE_TYPE& row, const M_SIZE_TYPE& col) {
+	M_SIZE_TYPE index = 0;
+	for (M_SIZE_TYPE bit = 0; (row >> bit) != 0 || (col >> bit) != 0; ++bit) {
+		index |= ((row >> bit) & 1) << ((bit << 1) + 1);
+		index |= ((col >> bit) & 1) << (bit << 1);
+	}
+	return index;
+}
+
+/**
+ *  @brief  Prueft, ob eine Matrix der Dimension n in Kacheln der Groesse
+ *  tile im Morton-Layout abgelegt werden kann (n / tile = 2^k).
+ *  @param     n  Matrixdimension (NxN).
+ *  @param  tile  Kachelgroesse.
+ *  @return true, falls das Layout moeglich ist.
+ */
+inline bool isMortonCompatible(const M_SIZE_TYPE& n, const M_SIZE_TYPE& tile) {
+	if (tile == 0 || n < tile || n % tile != 0) {
+		return false;
+	}
+	const M_SIZE_TYPE tiles = n / tile;
+	return (tiles & (tiles - 1)) == 0;
+}
+
+/**
+ *  @brief  Funktionsobjekt zum parallelisierten Umsortieren vom zeilenweisen
+ *  Layout ins Morton-Layout. Iteriert ueber Kacheln.
+ */
+struct MortonToPBody {
+	MatrixView Z;						// Ziel im Morton-Layout
+	ConstMatrixView R;					// Quelle im zeilenweisen Layout
+
+	MortonToPBody(const MatrixView& __Z, const ConstMatrixView& __R) : Z(__Z), R(__R) { }
+
+	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
+		const M_SIZE_TYPE tile = Z.tile;
+		for (M_SIZE_TYPE ti = range.rows().begin(); ti != range.rows().end(); ++ti) {
+			for (M_SIZE_TYPE tj = range.cols().begin(); tj != range.cols().end(); ++tj) {
+				M_VAL_TYPE* block = Z.data + mortonIndex(ti, tj) * tile * tile;
+				for (M_SIZE_TYPE i = 0; i < tile; ++i) {
+					const M_VAL_TYPE* r = R[ti * tile + i] + tj * tile;
+					for (M_SIZE_TYPE j = 0; j < tile; ++j) {
+						block[i * tile + j] = r[j];
+					}
+				}
+			}
+		}
+	}
+};
+
+/**
+ *  @brief  Funktionsobjekt zum parallelisierten Umsortieren vom Morton-Layout
+ *  ins zeilenweise Layout. Iteriert ueber Kacheln.
+ */
+struct MortonFromPBody {
+	MatrixView R;						// Ziel im zeilenweisen Layout
+	ConstMatrixView Z;					// Quelle im Morton-Layout
+
+	MortonFromPBody(const MatrixView& __R, const ConstMatrixView& __Z) : R(__R), Z(__Z) { }
+
+	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
+		const M_SIZE_TYPE tile = Z.tile;
+		for (M_SIZE_TYPE ti = range.rows().begin(); ti != range.rows().end(); ++ti) {
+			for (M_SIZE_TYPE tj = range.cols().begin(); tj != range.cols().end(); ++tj) {
+				const M_VAL_TYPE* block = Z.data + mortonIndex(ti, tj) * tile * tile;
+				for (M_SIZE_TYPE i = 0; i < tile; ++i) {
+					M_VAL_TYPE* r = R[ti * tile + i] + tj * tile;
+					for (M_SIZE_TYPE j = 0; j < tile; ++j) {
+						r[j] = block[i * tile + j];
+					}
+				}
+			}
+		}
+	}
+};
+
+/**
+ *  @brief  Legt eine zeilenweise Matrix im Morton-Layout ab (parallel).
+ *  @param  Z  Zielmatrix (Morton-Layout, Z.tile gesetzt, n^2 Elemente).
+ *  @param  R  Quellmatrix (zeilenweise).
+ *  @param  n  Matrixdimension (NxN).
+ */
+inline void matrixToMorton(const MatrixView& Z, const ConstMatrixView& R, const M_SIZE_TYPE& n) {
+	const M_SIZE_TYPE tiles = n / Z.tile;
+	tbb::parallel_for(tbb::blocked_range2d<M_SIZE_TYPE>(0, tiles, 0, tiles), MortonToPBody(Z, R));
+}
+
+/**
+ *  @brief  Legt eine Matrix im Morton-Layout zeilenweise ab (parallel).
+ *  @param  R  Zielmatrix (zeilenweise).
+ *  @param  Z  Quellmatrix (Morton-Layout, Z.tile gesetzt).
+ *  @param  n  Matrixdimension (NxN).
+ */
+inline void matrixFromMorton(const MatrixView& R, const ConstMatrixView& Z, const M_SIZE_TYPE& n) {
+	const M_SIZE_TYPE tiles = n / Z.tile;
+	tbb::parallel_for(tbb::blocked_range2d<M_SIZE_TYPE>(0, tiles, 0, tiles), MortonFromPBody(R, Z));
+}
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
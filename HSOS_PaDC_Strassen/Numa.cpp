@@ -0,0 +1,167 @@
+//============================================================================
+// Name        : Numa.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Numa.h"
+#include "Definitions.h"
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <errno.h>
+#include <iostream>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+#if USE_NUMA && defined(__linux__)
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define NUMA_LINUX 1
+#ifndef MPOL_INTERLEAVE
+#define MPOL_INTERLEAVE 3				// Siehe linux/mempolicy.h
+#endif
+#else
+#define NUMA_LINUX 0
+#endif
+
+#define NUMA_PAGE_SIZE 4096				// Seitengroesse (Granularitaet der Platzierung)
+#define NUMA_TOUCH_GRAIN 64				// Seiten je Teilbereich der parallelen ersten Beruehrung
+
+/**
+*  @brief  Funktionsobjekt zur parallelen ersten Beruehrung: Jeder Thread
+*  setzt seine Seiten auf 0, das Betriebssystem legt sie auf seinem Knoten an.
+*/
+struct NumaTouchPBody {
+	char* data;
+	const size_t bytes;
+
+	NumaTouchPBody(char* _data, const size_t _bytes) : data(_data), bytes(_bytes) { }
+
+	void operator()(const tbb::blocked_range<size_t>& range) const {
+		const size_t begin = range.begin() * NUMA_PAGE_SIZE;
+		const size_t end = range.end() * NUMA_PAGE_SIZE < bytes ? range.end() * NUMA_PAGE_SIZE : bytes;
+		memset(data + begin, 0, end - begin);
+	}
+};
+
+#define NUMA_MAX_NODES 1024				// Groesste unterstuetzte Knotennummer + 1 (Maske fuer mbind)
+#define NUMA_MASK_WORDS (NUMA_MAX_NODES / (8 * sizeof(unsigned long)))
+
+static int nodeCount = 0;									// Anzahl der Knoten (0: noch nicht ermittelt)
+static unsigned long nodeMask[NUMA_MASK_WORDS];				// Vorhandene Knoten (Nummern muessen nicht lueckenlos sein)
+
+/**
+*  @brief  Ermittelt die vorhandenen NUMA-Knoten (Linux: sysfs, einmalig).
+*/
+static void numaScan() {
+	if (nodeCount != 0) {
+		return;
+	}
+	memset(nodeMask, 0, sizeof(nodeMask));
+	int nodes = 0;
+#if NUMA_LINUX
+	DIR* dir = opendir("/sys/devices/system/node");
+	if (dir != NULL) {
+		for (struct dirent* entry = readdir(dir); entry != NULL; entry = readdir(dir)) {
+			if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+				const long id = strtol(entry->d_name + 4, NULL, 10);
+				if (id < NUMA_MAX_NODES) {
+					nodeMask[id / (8 * sizeof(unsigned long))] |= 1UL << (id % (8 * sizeof(unsigned long)));
+					++nodes;
+				}
+			}
+		}
+		closedir(dir);
+	}
+#endif
+	nodeCount = nodes > 0 ? nodes : 1;
+}
+
+/**
+*  @brief  Ermittelt die Anzahl der NUMA-Knoten (Linux: sysfs).
+*  @return Anzahl der Knoten, mindestens 1.
+*/
+int numaNodes() {
+	numaScan();
+	return nodeCount;
+}
+
+/**
+*  @brief  Liefert den Namen einer Platzierungsstrategie (NUMA_*).
+*/
+const char* numaPolicyName(const int policy) {
+	switch (policy) {
+	case NUMA_SERIAL:
+		return "serial first touch";
+	case NUMA_FIRST_TOUCH:
+		return "parallel first touch";
+	default:
+		return "interleaved";
+	}
+}
+
+/**
+*  @brief  Allokiert seitenweise ausgerichteten Speicher, platziert ihn gemaess
+*  NUMA_POLICY und initialisiert ihn mit 0. Bei NUMA_INTERLEAVE wird der
+*  Bereich vor der ersten Beruehrung per mbind auf alle vorhandenen Knoten
+*  verteilt; schlaegt das fehl, bleibt es (mit Warnung) bei der parallelen
+*  ersten Beruehrung.
+*  @param  bytes  Groesse in Bytes.
+*  @return Zeiger auf den Speicher (NULL bei bytes == 0).
+*/
+void* numaAllocate(const size_t bytes) {
+	if (bytes == 0) {
+		return NULL;
+	}
+#if NUMA_LINUX
+	void* p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED) {
+		throw std::bad_alloc();
+	}
+	if (NUMA_POLICY == NUMA_INTERLEAVE && numaNodes() > 1
+			&& syscall(SYS_mbind, p, bytes, MPOL_INTERLEAVE, nodeMask, NUMA_MAX_NODES + 1, 0) != 0) {	// maxnode zaehlt ein Bit mehr als die Maske
+		// Ohne Verteilung bleibt es bei der parallelen ersten Beruehrung
+		static bool reported = false;
+		if (!reported) {
+			std::cerr << "Warning: mbind(MPOL_INTERLEAVE) failed (" << strerror(errno) << "), using parallel first touch\n";
+			reported = true;
+		}
+	}
+#else
+	void* p = NULL;
+	if (posix_memalign(&p, NUMA_PAGE_SIZE, bytes) != 0) {
+		throw std::bad_alloc();
+	}
+#endif
+	if (NUMA_POLICY == NUMA_SERIAL) {
+		memset(p, 0, bytes);
+	}
+	else {
+		const size_t pages = (bytes + NUMA_PAGE_SIZE - 1) / NUMA_PAGE_SIZE;
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, pages, NUMA_TOUCH_GRAIN), NumaTouchPBody(static_cast<char*>(p), bytes));
+	}
+	return p;
+}
+
+/**
+*  @brief  Gibt per numaAllocate allokierten Speicher frei.
+*  @param      p  Zeiger auf den Speicher.
+*  @param  bytes  Groesse in Bytes (wie bei der Allokation).
+*/
+void numaFree(void* p, const size_t bytes) {
+	if (p == NULL) {
+		return;
+	}
+#if NUMA_LINUX
+	munmap(p, bytes);
+#else
+	free(p);
+#endif
+}
@@ -0,0 +1,32 @@
+//============================================================================
+// Name        : Numa.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef NUMA_H_
+#define NUMA_H_
+
+#include <stddef.h>
+
+#define NUMA_SERIAL 0					// Erste Beruehrung seriell im Hauptthread (alle Seiten auf einem Knoten)
+#define NUMA_FIRST_TOUCH 1				// Parallele erste Beruehrung: Seiten liegen beim Knoten des initialisierenden Threads
+#define NUMA_INTERLEAVE 2				// Seiten reihum auf alle Knoten verteilt (mbind), parallel beruehrt
+
+/*
+ * Speicher grosser Matrizen: seitenweise ausgerichtet, gemaess NUMA_POLICY
+ * platziert und mit 0 initialisiert. Typunabhaengig (nur einmal uebersetzt).
+ */
+void* numaAllocate(const size_t bytes);
+
+void numaFree(void* p, const size_t bytes);
+
+int numaNodes();
+
+const char* numaPolicyName(const int policy);
+
+#endif
@@ -0,0 +1,355 @@
+//============================================================================
+// Name        : OutOfCore.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "OutOfCore.h"
+#include "Gemm.h"
+#include "MatrixFile.h"
+#include "Strassen.h"
+#include "StrassenRect.h"
+#include "Workspace.h"
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <sstream>
+#include <vector>
+
+namespace M_VAL_NAMESPACE {
+
+#define OOC_TEMPORARIES 3				// Operand aus A, Operand aus B, Produkt
+
+/**
+*  @brief  Zwischendateien einer Ebene (Dimension n/2 der Ebene).
+*/
+struct OocScratch {
+	MatrixFile left;
+	MatrixFile right;
+	MatrixFile product;
+};
+
+/**
+*  @brief  Zustand eines Out-of-Core-Produkts: RAM-Puffer der In-Core-Ebene
+*  und Zwischendateien der Ebenen darueber (Index: Tiefe).
+*/
+struct OocContext {
+	const OutOfCorePlan& plan;
+	const bool parallel;
+	MatrixView left;
+	MatrixView right;
+	MatrixView product;
+	std::vector<OocScratch*> scratch;
+
+	OocContext(const OutOfCorePlan& __plan, const bool __parallel, M_VAL_TYPE* ram) : plan(__plan), parallel(__parallel),
+			left(ram, plan.inCore, plan.inCore, plan.tile),
+			right(ram + (size_t) plan.inCore * plan.inCore, plan.inCore, plan.inCore, plan.tile),
+			product(ram + 2 * (size_t) plan.inCore * plan.inCore, plan.inCore, plan.inCore, plan.tile) { }
+
+	~OocContext() {
+		for (size_t i = 0; i < scratch.size(); ++i) {
+			delete scratch[i];
+		}
+	}
+};
+
+/**
+*  @brief  Workspace-Elemente je Thread fuer ein Produkt n x n im RAM.
+*/
+static M_SIZE_TYPE oocWorkspaceElements(const M_SIZE_TYPE& n) {
+	const M_SIZE_TYPE gemmElements = gemmPackElements(n, n, n);
+	const M_SIZE_TYPE strassenElements = strassenWorkspaceElements(n);
+	return gemmElements > strassenElements ? gemmElements : strassenElements;
+}
+
+/**
+*  @brief  Zwischenmatrizen eines Produkts n x n im RAM, die WorkspaceFrame
+*  auf dem Heap belegt (ueber WORKSPACE_HEAP_ELEMENTS): je Ebene hoechstens
+*  min(7^Ebene, NO_THREADS) gleichzeitig bearbeitete Teilprodukte.
+*/
+static M_SIZE_TYPE oocHeapElements(const M_SIZE_TYPE& n) {
+	M_SIZE_TYPE elements = 0;
+	M_SIZE_TYPE active = 1;
+	for (M_SIZE_TYPE size = n; size > CUT_OFF && workspaceShare((size >> 1) * (size >> 1)) == 0; size >>= 1) {
+		elements += TASK_TEMPORARIES * (size >> 1) * (size >> 1) * active;
+		active = active * STRASSEN_PRODUCTS < NO_THREADS ? active * STRASSEN_PRODUCTS : NO_THREADS;
+	}
+	return elements;
+}
+
+/**
+*  @brief  Erstellt die Aufteilung: Die Teilproblemdimension wird so lange
+*  halbiert, bis Operanden, Produkt und Workspaces aller Threads in das
+*  Budget passen, jedoch nicht unter die Kachelgroesse (Morton) bzw. CUT_OFF.
+*  @param            n  Dimension von A, B und C.
+*  @param         tile  Kachelgroesse der Dateien (0: zeilenweise).
+*  @param  budgetBytes  Budget fuer den RAM in Bytes.
+*/
+OutOfCorePlan outOfCorePlan(const M_SIZE_TYPE& n, const M_SIZE_TYPE& tile, const size_t budgetBytes) {
+	OutOfCorePlan plan;
+	plan.n = n;
+	plan.tile = tile;
+	plan.inCore = n;
+	plan.levels = 0;
+	plan.overBudget = false;
+	plan.scratchBytes = 0;
+	plan.ramBytes = ((size_t) NO_THREADS * oocWorkspaceElements(n) + oocHeapElements(n)) * sizeof(M_VAL_TYPE);
+	const M_SIZE_TYPE minimum = tile != 0 ? tile : CUT_OFF;
+	while (plan.ramBytes > budgetBytes) {
+		if (plan.inCore <= minimum || (plan.inCore & 1) != 0) {
+			plan.overBudget = true;
+			break;
+		}
+		if (plan.levels > 0) {
+			// Die bisherige In-Core-Ebene legt ihre Zwischenmatrizen nun auf der Platte ab
+			plan.scratchBytes += OOC_TEMPORARIES * (size_t) plan.inCore * plan.inCore * sizeof(M_VAL_TYPE);
+		}
+		plan.inCore >>= 1;
+		++plan.levels;
+		plan.ramBytes = (OOC_TEMPORARIES * (size_t) plan.inCore * plan.inCore + (size_t) NO_THREADS * oocWorkspaceElements(plan.inCore)
+				+ oocHeapElements(plan.inCore)) * sizeof(M_VAL_TYPE);
+	}
+	return plan;
+}
+
+/**
+*  @brief  Workspace-Elemente je Thread fuer initWorkspaces (nur die In-Core-Ebene).
+*/
+M_SIZE_TYPE outOfCoreWorkspaceElements(const OutOfCorePlan& plan) {
+	return oocWorkspaceElements(plan.inCore);
+}
+
+/**
+*  @brief  Hinweis an den Kernel fuer einen Speicherbereich einer Einblendung,
+*  auf ganze Seiten erweitert. MADV_REMOVE (Loch in der Datei) darf daher nur
+*  fuer ganze Zwischendateien verwendet werden; wird es vom Dateisystem nicht
+*  unterstuetzt, werden die Seiten nur aus der Einblendung entfernt.
+*/
+static void oocAdvise(const void* data, const size_t bytes, const int advice) {
+	static const uintptr_t page = (uintptr_t) sysconf(_SC_PAGESIZE);
+	const uintptr_t begin = (uintptr_t) data & ~(page - 1);
+	const uintptr_t end = ((uintptr_t) data + bytes + page - 1) & ~(page - 1);
+	if (madvise((void*) begin, end - begin, advice) != 0 && advice == MADV_REMOVE) {
+		madvise((void*) begin, end - begin, MADV_DONTNEED);
+	}
+}
+
+/**
+*  @brief  Hinweis fuer die Zeilen eines Quadranten (zeilenweise: der
+*  umschliessende Bereich inkl. der Nachbarspalten, Morton: zusammenhaengend).
+*/
+static void oocAdvise(const ConstMatrixView& Q, const M_SIZE_TYPE& n, const int advice) {
+	oocAdvise(Q.data, ((size_t) (n - 1) * Q.ld + n) * sizeof(M_VAL_TYPE), advice);
+}
+
+/**
+*  @brief  Letztes Produkt, das einen Quadranten von A bzw. B liest.
+*/
+static int oocLastUse(const int coefficients[STRASSEN_PRODUCTS][4], const int quadrant) {
+	int p = STRASSEN_PRODUCTS - 1;
+	while (coefficients[p][quadrant] == 0) {
+		--p;
+	}
+	return p;
+}
+
+/**
+*  @brief  Erstes bzw. letztes Produkt, das in einen Quadranten von C eingeht.
+*/
+static int oocFirstSign(const int quadrant) {
+	int p = 0;
+	while (STRASSEN_SIGNS[quadrant][p] == 0) {
+		++p;
+	}
+	return p;
+}
+
+static int oocLastSign(const int quadrant) {
+	int p = STRASSEN_PRODUCTS - 1;
+	while (STRASSEN_SIGNS[quadrant][p] == 0) {
+		--p;
+	}
+	return p;
+}
+
+/**
+*  @brief  Bildet einen Operanden aus bis zu zwei Quadranten. Ein einzelner
+*  Quadrant (Koeffizient 1) wird ohne Kopie direkt verwendet.
+*  @param             T  Zwischenmatrix fuer Summe bzw. Differenz.
+*  @param             Q  Quadranten (11, 12, 21, 22).
+*  @param  coefficients  Koeffizienten der Quadranten (siehe STRASSEN_LEFT, STRASSEN_RIGHT).
+*  @param             n  Dimension der Quadranten.
+*/
+static ConstMatrixView oocOperand(const MatrixView& T, const ConstMatrixView Q[4], const int coefficients[4], const M_SIZE_TYPE& n) {
+	int first = -1;
+	int second = -1;
+	for (int i = 0; i < 4; ++i) {
+		if (coefficients[i] != 0 && first < 0) {
+			first = i;
+		}
+		else if (coefficients[i] != 0) {
+			second = i;
+		}
+	}
+	if (second < 0) {
+		return Q[first];
+	}
+	if (coefficients[first] < 0) {
+		matrixSubPar(T, Q[second], Q[first], n);
+	}
+	else if (coefficients[second] < 0) {
+		matrixSubPar(T, Q[first], Q[second], n);
+	}
+	else {
+		matrixAddPar(T, Q[first], Q[second], n);
+	}
+	return T;
+}
+
+/**
+*  @brief  Stoesst das Vorauslesen der Quadranten von Produkt p an (kehrt
+*  sofort zurueck, der Kernel liest parallel zur Rechnung), inkl. der bereits
+*  beschriebenen Quadranten von C, die p aktualisiert.
+*/
+static void oocPrefetch(const ConstMatrixView a[4], const ConstMatrixView b[4], const MatrixView c[4], const int p, const M_SIZE_TYPE& n) {
+	for (int i = 0; i < 4; ++i) {
+		if (STRASSEN_LEFT[p][i] != 0) {
+			oocAdvise(a[i], n, MADV_WILLNEED);
+		}
+		if (STRASSEN_RIGHT[p][i] != 0) {
+			oocAdvise(b[i], n, MADV_WILLNEED);
+		}
+		if (STRASSEN_SIGNS[i][p] != 0 && oocFirstSign(i) < p) {
+			oocAdvise(c[i], n, MADV_WILLNEED);
+		}
+	}
+}
+
+/**
+*  @brief  Entfernt die Quadranten nach ihrer letzten Verwendung in Produkt p
+*  aus der Einblendung. Geaenderte Seiten von C bleiben im Seiten-Cache und
+*  werden vom Kernel zurueckgeschrieben.
+*/
+static void oocRelease(const ConstMatrixView a[4], const ConstMatrixView b[4], const MatrixView c[4], const int p, const M_SIZE_TYPE& n) {
+	for (int i = 0; i < 4; ++i) {
+		if (oocLastUse(STRASSEN_LEFT, i) == p) {
+			oocAdvise(a[i], n, MADV_DONTNEED);
+		}
+		if (oocLastUse(STRASSEN_RIGHT, i) == p) {
+			oocAdvise(b[i], n, MADV_DONTNEED);
+		}
+		if (oocLastSign(i) == p) {
+			oocAdvise(c[i], n, MADV_DONTNEED);
+		}
+	}
+}
+
+/**
+*  @brief  Eine Ebene auf der Platte: Die sieben Produkte werden nacheinander
+*  gebildet und in die Quadranten von C summiert. Die Zwischenmatrizen liegen
+*  in den Zwischendateien der Ebene bzw. (letzte Ebene) in den RAM-Puffern.
+*  A, B und C sind stets eingeblendete Dateien.
+*  @param    ctx  Zustand des Produkts.
+*  @param      n  Dimension von A, B und C.
+*  @param  depth  Tiefe der Ebene (0: Eingabedateien).
+*/
+static void oocMultiply(OocContext& ctx, const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n, const int depth) {
+	const M_SIZE_TYPE half = n >> 1;
+	const ConstMatrixView a[4] = { A.quadrant(0, 0), A.quadrant(0, 1), A.quadrant(1, 0), A.quadrant(1, 1) };
+	const ConstMatrixView b[4] = { B.quadrant(0, 0), B.quadrant(0, 1), B.quadrant(1, 0), B.quadrant(1, 1) };
+	const MatrixView c[4] = { C.quadrant(0, 0), C.quadrant(0, 1), C.quadrant(1, 0), C.quadrant(1, 1) };
+
+	const bool inCore = depth + 1 == ctx.plan.levels;
+	OocScratch* scratch = inCore ? NULL : ctx.scratch[depth];
+	const MatrixView S = inCore ? ctx.left : matrixFileView(scratch->left);
+	const MatrixView T = inCore ? ctx.right : matrixFileView(scratch->right);
+	const MatrixView M = inCore ? ctx.product : matrixFileView(scratch->product);
+	int accumulated[4] = { 0, 0, 0, 0 };
+
+	oocPrefetch(a, b, c, 0, half);
+	for (int p = 0; p < STRASSEN_PRODUCTS; ++p) {
+		const ConstMatrixView left = oocOperand(S, a, STRASSEN_LEFT[p], half);
+		const ConstMatrixView right = oocOperand(T, b, STRASSEN_RIGHT[p], half);
+		if (p + 1 < STRASSEN_PRODUCTS) {
+			oocPrefetch(a, b, c, p + 1, half);
+		}
+		if (!inCore) {
+			oocMultiply(ctx, M, left, right, half, depth + 1);
+		}
+		else if (ctx.parallel) {
+			strassenMultiplyPar(M, left, right, half);
+		}
+		else {
+			strassenMultiplySeq(M, left, right, half);
+		}
+		for (int q = 0; q < 4; ++q) {
+			const int sign = STRASSEN_SIGNS[q][p];
+			if (sign != 0) {
+				const bool first = accumulated[q] == 0;
+				matrixCombinePar(MatrixAccumulatePBody(c[q], M, sign, first), half, half, first ? 2 : 3, first ? 0 : 1);
+				++accumulated[q];
+			}
+		}
+		oocRelease(a, b, c, p, half);
+		if (!inCore) {
+			// Verbrauchte Zwischenmatrizen: ohne Rueckschreiben verwerfen, Neuschreiben ohne Lesen
+			oocAdvise(scratch->left.data(), scratch->left.dataBytes(), MADV_REMOVE);
+			oocAdvise(scratch->right.data(), scratch->right.dataBytes(), MADV_REMOVE);
+			oocAdvise(scratch->product.data(), scratch->product.dataBytes(), MADV_REMOVE);
+		}
+	}
+}
+
+/**
+*  @brief  Multipliziert zwei eingeblendete Matrixdateien gemaess Aufteilung
+*  (siehe outOfCorePlan). Die Workspaces muessen fuer
+*  outOfCoreWorkspaceElements(plan) initialisiert sein.
+*  @param           C  Ergebnis (Einblendung, Layout wie A).
+*  @param           A  Matrix A (Einblendung).
+*  @param           B  Matrix B (Einblendung, Layout wie A).
+*  @param        plan  Aufteilung auf Platte und RAM.
+*  @param  scratchDir  Verzeichnis der Zwischendateien.
+*  @param    parallel  Produkte im RAM mit Tasks (sonst sequentiell).
+*  @param       error  Grund, falls eine Zwischendatei nicht angelegt werden kann
+*  oder n im Morton-Layout nicht bis zur Kachel halbierbar ist.
+*  @return true bei Erfolg.
+*/
+bool strassenOutOfCore(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const OutOfCorePlan& plan,
+		const std::string& scratchDir, const bool parallel, std::string& error) {
+	// Morton-Daten duerfen nicht in die Variante mit Abschaelen fallen
+	if (plan.tile != 0 && !isStrassenDivisible(plan.inCore)) {
+		std::ostringstream message;
+		message << "Tiled files: " << plan.inCore << " x " << plan.inCore << " does not halve to the cut-off " << CUT_OFF << " (tile " << plan.tile << ")";
+		error = message.str();
+		return false;
+	}
+	if (plan.levels == 0) {
+		parallel ? strassenMultiplyPar(C, A, B, plan.n) : strassenMultiplySeq(C, A, B, plan.n);
+		return true;
+	}
+	MatrixStorage ram(OOC_TEMPORARIES * (size_t) plan.inCore * plan.inCore);
+	OocContext ctx(plan, parallel, &ram[0]);
+	for (int depth = 0; depth + 1 < plan.levels; ++depth) {
+		ctx.scratch.push_back(new OocScratch());
+		MatrixFile* files[OOC_TEMPORARIES] = { &ctx.scratch.back()->left, &ctx.scratch.back()->right, &ctx.scratch.back()->product };
+		const M_SIZE_TYPE size = plan.n >> (depth + 1);
+		for (int i = 0; i < OOC_TEMPORARIES; ++i) {
+			std::ostringstream path;
+			path << scratchDir << "/.HSOS_PaDC_Strassen." << getpid() << "." << depth << "STM"[i];
+			if (!files[i]->create(path.str().c_str(), M_VAL_TYPE_ID, size, size, plan.tile != 0 ? MATRIX_FILE_TILED : MATRIX_FILE_ROW_MAJOR, plan.tile)) {
+				error = files[i]->error();
+				return false;
+			}
+			// Die Einblendung haelt die Datei, der Name wird nicht mehr gebraucht
+			unlink(path.str().c_str());
+		}
+	}
+	oocMultiply(ctx, C, A, B, plan.n, 0);
+	return true;
+}
+
+} // namespace M_VAL_NAMESPACE
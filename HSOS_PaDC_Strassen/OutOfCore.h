@@ -0,0 +1,57 @@
+//============================================================================
+// Name        : OutOfCore.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef OUTOFCORE_H_
+#define OUTOFCORE_H_
+
+#include "Definitions.h"
+#include "Matrix.h"
+#include <stddef.h>
+#include <string>
+
+namespace M_VAL_NAMESPACE {
+
+/*
+ * Out-of-Core-Modus (-O <MiB> zusammen mit -i/-w): A, B und C bleiben in den
+ * per mmap eingeblendeten Matrixdateien. Die obersten Ebenen der Rekursion
+ * bilden die sieben Produkte nacheinander, ihre Operandensummen und Produkte
+ * liegen je Ebene in Zwischendateien (-S, nach dem Anlegen geloescht). Erst
+ * ab der Teilproblemdimension inCore passen Operanden, Produkt und die
+ * Workspaces der Threads in das Budget und die Ebene rechnet im RAM mit
+ * strassenMultiplyPar/Seq. Waehrend Produkt p rechnet, liest der Kernel die
+ * Quadranten von Produkt p + 1 voraus (MADV_WILLNEED); Quadranten nach ihrer
+ * letzten Verwendung werden aus der Einblendung entfernt (MADV_DONTNEED),
+ * verbrauchte Zwischendateien freigegeben (MADV_REMOVE). Das Budget begrenzt
+ * den anonymen Speicher, der Seiten-Cache bleibt vom Kernel verdraengbar.
+ */
+
+/**
+*  @brief  Aufteilung eines Out-of-Core-Produkts auf Platte und RAM.
+*/
+struct OutOfCorePlan {
+	M_SIZE_TYPE n;						// Dimension von A, B und C
+	M_SIZE_TYPE tile;					// Kachelgroesse der Dateien (0: zeilenweise)
+	M_SIZE_TYPE inCore;					// Ab dieser Teilproblemdimension wird im RAM gerechnet
+	int levels;							// Ebenen bis inCore (0: alles im RAM)
+	bool overBudget;					// Budget auch bei kleinstem inCore ueberschritten
+	size_t ramBytes;					// Arbeitsmenge im RAM (Puffer und Workspaces)
+	size_t scratchBytes;				// Zwischendateien aller Ebenen auf der Platte
+};
+
+OutOfCorePlan outOfCorePlan(const M_SIZE_TYPE& n, const M_SIZE_TYPE& tile, const size_t budgetBytes);
+
+M_SIZE_TYPE outOfCoreWorkspaceElements(const OutOfCorePlan& plan);
+
+bool strassenOutOfCore(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const OutOfCorePlan& plan,
+		const std::string& scratchDir, const bool parallel, std::string& error);
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
@@ -0,0 +1,790 @@
+//============================================================================
+// Name        : Run.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Bench.h"
+#include "Blas.h"
+#include "Caps.h"
+#include "Definitions.h"
+#include "Gemm.h"
+#include "Helper.h"
+#include "Inverse.h"
+#include "Kernel.h"
+#include "Matrix.h"
+#include "MatrixFile.h"
+#include "Morton.h"
+#include "Numa.h"
+#include "OutOfCore.h"
+#include "Run.h"
+#include "Strassen.h"
+#include "StrassenRect.h"
+#include "Trace.h"
+#include "Tuner.h"
+#include "Verify.h"
+#include "Workspace.h"
+#include "../HSOS_PaDC_Common/PerfCounters.h"
+#include <tbb/blocked_range2d.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task.h>
+#include <tbb/tick_count.h>
+#include <limits>
+#include <math.h>
+#include <vector>
+
+namespace M_VAL_NAMESPACE {
+
+using namespace tbb;
+
+/**
+*  @brief  Schreibt die Instrumentierung aller Strassen-Laeufe (nur mit -j).
+*/
+static void reportTrace() {
+	if (TRACE_PATH == NULL) {
+		return;
+	}
+	if (traceWrite(TRACE_PATH)) {
+		std::cout << "Trace:\t\twritten to " << TRACE_PATH << "\n";
+	} else {
+		std::cerr << "Could not write trace to " << TRACE_PATH << "\n";
+	}
+}
+
+/**
+*  @brief  Prueft ein Ergebnis C = A * B per Freivalds (nur mit -v) und gibt
+*  das Ergebnis aus.
+*  @param  C  Ergebnis (m x n).
+*  @param  A  Matrix A (m x k).
+*  @param  B  Matrix B (k x n).
+*  @param  m  Zeilen von A und C.
+*  @param  n  Spalten von B und C.
+*  @param  k  Spalten von A bzw. Zeilen von B.
+*/
+static void reportVerification(const ConstMatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B,
+		const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	if (VERIFY_VECTORS == 0) {
+		return;
+	}
+	const tick_count t0 = tick_count::now();
+	const VerifyResult result = verifyProduct(C, A, B, m, n, k, VERIFY_VECTORS);
+	const tick_count t1 = tick_count::now();
+	std::cout << "Freivalds:\t" << (result.ok ? "OK" : "FAILED") << " - " << VERIFY_VECTORS << " vector(s), row " << result.row
+			  << ": residual " << result.residual << ", bound " << result.bound << ", time " << (t1 - t0).seconds() << "s\n";
+}
+
+/**
+*  @brief  Fuehrt die Algorithmen fuer rechteckige Matrizen aus:
+*  C (m x n) = A (m x k) * B (k x n). Referenz ist die gekachelte GEMM.
+*  @param  m  Zeilen von A und C.
+*  @param  n  Spalten von B und C.
+*  @param  k  Spalten von A bzw. Zeilen von B.
+*  @return 0 bei Erfolg.
+*/
+static int runRectangular(const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	tick_count t0, t1;
+	PerfCounters counters;
+	MatrixStorage a(m * k), b(k * n), c1(m * n), c2(m * n);
+	const MatrixView A(&a[0], k, 0);
+	const MatrixView B(&b[0], n, 0);
+	const MatrixView C1(&c1[0], n, 0);
+	const MatrixView C2(&c2[0], n, 0);
+	const double flops = 2.0 * m * n * k;
+
+	initializeRandpriomMatrix(A, m, k, RANDOM_STREAM_A);
+	initializeRandpriomMatrix(B, k, n, RANDOM_STREAM_B);
+
+	const M_SIZE_TYPE gemmElements = gemmPackElements(m, n, k);
+	const M_SIZE_TYPE strassenElements = strassenRectWorkspaceElements(m, n, k);
+	initWorkspaces(gemmElements > strassenElements ? gemmElements : strassenElements);
+
+	if (RUN_NAIV_SEQ != 0) {
+		counters.start();
+		t0 = tick_count::now();
+		gemmSeq(C2, A, B, m, n, k);
+		t1 = tick_count::now();
+		counters.stop();
+		std::cout << "Naiv Seq:\tTime was " << (t1 - t0).seconds() << "s - tiled GEMM, " << flops / (t1 - t0).seconds() * 1e-9 << " GFLOP/s\n";
+		counters.print(std::cout, (t1 - t0).seconds());
+	}
+
+	if (RUN_NAIV_PAR != 0) {
+		counters.start();
+		t0 = tick_count::now();
+		gemmPar(C2, A, B, m, n, k);
+		t1 = tick_count::now();
+		counters.stop();
+		std::cout << "Naiv Par:\tTime was " << (t1 - t0).seconds() << "s - Naiv-Parallel (tiled GEMM), " << flops / (t1 - t0).seconds() * 1e-9 << " GFLOP/s\n";
+		counters.print(std::cout, (t1 - t0).seconds());
+	}
+
+	if (RUN_STRASSEN_SEQ != 0) {
+		traceBegin(m > n ? (m > k ? m : k) : (n > k ? n : k));
+		counters.start();
+		t0 = tick_count::now();
+		strassenRectRecursive(C1, A, B, m, n, k);
+		t1 = tick_count::now();
+		counters.stop();
+		traceEnd("Strassen Seq", strassenVariantName(VARIANT_STRASSEN), (t1 - t0).seconds());
+		std::cout << "Strassen Seq:\tTime was " << (t1 - t0).seconds() << "s - Strassen-Alg.: Non-Tasks, " << flops / (t1 - t0).seconds() * 1e-9 << " GFLOP/s (effective)\n";
+		counters.print(std::cout, (t1 - t0).seconds());
+		reportVerification(C1, A, B, m, n, k);
+		if (RUN_NAIV_SEQ || RUN_NAIV_PAR) {
+			compareMatrices(C1, C2, m, n) ? std::cout << "Num stability:\tSome differences!\n" : std::cout << "Num stability:\tOK\n";
+		}
+	}
+
+	if (RUN_STRASSEN_PAR != 0) {
+		traceBegin(m > n ? (m > k ? m : k) : (n > k ? n : k));
+		counters.start();
+		t0 = tick_count::now();
+		strassenRectPar(C1, A, B, m, n, k);
+		t1 = tick_count::now();
+		counters.stop();
+		traceEnd("Strassen Par", strassenVariantName(VARIANT_STRASSEN), (t1 - t0).seconds());
+		std::cout << "Strassen Par:\tTime was " << (t1 - t0).seconds() << "s - Strassen-Alg.: Tasks, " << flops / (t1 - t0).seconds() * 1e-9 << " GFLOP/s (effective)\n";
+		counters.print(std::cout, (t1 - t0).seconds());
+		reportVerification(C1, A, B, m, n, k);
+		if (RUN_NAIV_SEQ || RUN_NAIV_PAR) {
+			compareMatrices(C1, C2, m, n) ? std::cout << "Num stability:\tSome differences!\n" : std::cout << "Num stability:\tOK\n";
+		}
+	}
+
+	std::cout << "Workspace:\t" << (workspaceReservedBytes() >> 20) << " MiB reserved, "
+			  << (workspacePeakBytes() >> 20) << " MiB peak, "
+			  << workspaceOverflows() << " overflows\n";
+	reportTrace();
+	std::cout << "\n\nEND\n" ;
+	return 0;
+}
+
+/**
+*  @brief  Liefert eine Sicht von B im Layout von A. Weicht das Layout ab,
+*  wird B in storage umsortiert (sonst ohne Kopie direkt auf der Datei).
+*  @param        B  Sicht auf die Datei von B (quadratisch, falls umsortiert wird).
+*  @param        a  Kopf von A (Ziel-Layout).
+*  @param        b  Kopf von B.
+*  @param  storage  Speicher fuer die umsortierte Matrix.
+*/
+static ConstMatrixView matrixInLayoutOf(const ConstMatrixView& B, const MatrixFileHeader& a, const MatrixFileHeader& b, InnerArray& storage) {
+	if (a.layout == b.layout && a.tile == b.tile) {
+		return B;
+	}
+	const M_SIZE_TYPE n = (M_SIZE_TYPE) b.cols;
+	if (a.layout == MATRIX_FILE_ROW_MAJOR) {
+		storage.resize(n * n);
+		matrixFromMorton(MatrixView(&storage[0], n, n), B, n);
+		return ConstMatrixView(&storage[0], n, n);
+	}
+	InnerArray rowMajor;
+	ConstMatrixView R = B;
+	if (b.layout == MATRIX_FILE_TILED) {
+		rowMajor.resize(n * n);
+		matrixFromMorton(MatrixView(&rowMajor[0], n, n), B, n);
+		R = ConstMatrixView(&rowMajor[0], n, n);
+	}
+	storage.resize(n * n);
+	matrixToMorton(MatrixView(&storage[0], n, n, (M_SIZE_TYPE) a.tile), R, n);
+	return ConstMatrixView(&storage[0], n, n, (M_SIZE_TYPE) a.tile);
+}
+
+/**
+*  @brief  Verzeichnis der Zwischendateien im Out-of-Core-Modus: -S bzw. das
+*  Verzeichnis der Ergebnisdatei (-w).
+*/
+static std::string scratchDirectory() {
+	if (OOC_SCRATCH_DIR != NULL) {
+		return OOC_SCRATCH_DIR;
+	}
+	const std::string path = MATRIX_FILE_C;
+	const size_t slash = path.rfind('/');
+	return slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+}
+
+/**
+*  @brief  Prueft das Budget der CAPS-Variante (-M): Schon eine reine
+*  DFS-Rekursion belegt capsMinimumElements(n), darunter wuerde es
+*  ueberschritten.
+*  @param  n  Matrixdimension (NxN).
+*  @return true, falls CAPS nicht gewaehlt ist oder das Budget reicht.
+*/
+static bool capsBudgetFits(const M_SIZE_TYPE& n) {
+	if (STRASSEN_VARIANT != VARIANT_CAPS || MEMORY_BUDGET_MIB == 0) {
+		return true;
+	}
+	const size_t minimum = (size_t) capsMinimumElements(n) * sizeof(M_VAL_TYPE);
+	if (((size_t) MEMORY_BUDGET_MIB << 20) < minimum) {
+		std::cerr << "CAPS budget of " << MEMORY_BUDGET_MIB << " MiB is below the pure DFS need of " << ((minimum + (1 << 20) - 1) >> 20)
+				  << " MiB for " << n << " x " << n << "\n";
+		return false;
+	}
+	return true;
+}
+
+/**
+*  @brief  Legt die Dateien von -i als Zufallsmatrizen n x n an (-G), z. B.
+*  fuer Tests mit ungeraden Kachelgroessen. Gekachelte Dateien werden
+*  zeilenweise erzeugt und ins Morton-Layout umsortiert.
+*  @return 0 bei Erfolg.
+*/
+static int createRandomFiles() {
+	const M_SIZE_TYPE n = M_SIZE;
+	const M_SIZE_TYPE tile = (M_SIZE_TYPE) MATRIX_FILE_TILE;
+	const char* paths[2] = { MATRIX_FILE_A, MATRIX_FILE_B };
+	const uint32_t streams[2] = { RANDOM_STREAM_A, RANDOM_STREAM_B };
+	InnerArray rowMajor(tile != 0 ? n * n : 0);
+	for (int i = 0; i < 2; ++i) {
+		MatrixFile file;
+		if (!file.create(paths[i], M_VAL_TYPE_ID, n, n, tile != 0 ? MATRIX_FILE_TILED : MATRIX_FILE_ROW_MAJOR, tile)) {
+			std::cerr << file.error() << "\n";
+			return 1;
+		}
+		if (tile != 0) {
+			initializeRandpriomMatrix(MatrixView(&rowMajor[0], n, n), n, n, streams[i]);
+			matrixToMorton(matrixFileView(file), ConstMatrixView(&rowMajor[0], n, n), n);
+		}
+		else {
+			initializeRandpriomMatrix(matrixFileView(file), n, n, streams[i]);
+		}
+		if (!file.sync()) {
+			std::cerr << "Could not write " << paths[i] << "\n";
+			return 1;
+		}
+	}
+	std::cout << "Files:\t\tcreated " << paths[0] << " and " << paths[1] << " (" << n << " x " << n
+			  << ", " << matrixFileLayoutName(tile != 0 ? MATRIX_FILE_TILED : MATRIX_FILE_ROW_MAJOR) << ")\n";
+	return 0;
+}
+
+/**
+*  @brief  Multipliziert zwei Matrixdateien (-i): A und B werden per mmap
+*  ohne Kopie eingeblendet, C wird mit -w als Matrixdatei im Layout von A
+*  angelegt und direkt beschrieben. Gekachelte Dateien rechnen im
+*  Morton-Layout (CUT_OFF gleich tile), zeilenweise rechteckige Dateien
+*  mit dem rechteckigen Strassen. Mit -O rechnen quadratische Dateien
+*  out-of-core (siehe OutOfCore.h).
+*  @return 0 bei Erfolg.
+*/
+static int runFiles() {
+	tick_count t0, t1;
+	PerfCounters counters;
+	MatrixFile fileA, fileB, fileC;
+	if (!fileA.open(MATRIX_FILE_A) || !fileB.open(MATRIX_FILE_B)) {
+		std::cerr << (fileA.error().empty() ? fileB.error() : fileA.error()) << "\n";
+		return 1;
+	}
+	const MatrixFileHeader& a = fileA.header();
+	const MatrixFileHeader& b = fileB.header();
+	if (a.type != M_VAL_TYPE_ID || b.type != M_VAL_TYPE_ID) {
+		std::cerr << "Element types of A and B differ (" << M_VAL_TYPE_NAMES[a.type] << ", " << M_VAL_TYPE_NAMES[b.type] << ")\n";
+		return 1;
+	}
+	if (a.cols != b.rows) {
+		std::cerr << "Dimensions do not match: A is " << a.rows << " x " << a.cols << ", B is " << b.rows << " x " << b.cols << "\n";
+		return 1;
+	}
+	const M_SIZE_TYPE m = (M_SIZE_TYPE) a.rows;
+	const M_SIZE_TYPE k = (M_SIZE_TYPE) a.cols;
+	const M_SIZE_TYPE n = (M_SIZE_TYPE) b.cols;
+	const bool square = m == n && n == k;
+	const bool tiled = a.layout == MATRIX_FILE_TILED;
+	if (!square && (a.layout == MATRIX_FILE_TILED || b.layout == MATRIX_FILE_TILED)) {
+		std::cerr << "Tiled files must be square\n";
+		return 1;
+	}
+	const bool outOfCore = OOC_BUDGET_MIB != 0;
+	if (outOfCore && (!square || MATRIX_FILE_C == NULL || a.layout != b.layout || a.tile != b.tile)) {
+		std::cerr << "Out-of-core mode needs square files A and B in the same layout and a result file (-w)\n";
+		return 1;
+	}
+	std::cout << "Files:\t\tA " << m << " x " << k << " " << matrixFileLayoutName(a.layout)
+			  << ", B " << k << " x " << n << " " << matrixFileLayoutName(b.layout) << "\n";
+
+	InnerArray converted;
+	const ConstMatrixView A = matrixFileView(fileA);
+	const ConstMatrixView B = matrixInLayoutOf(matrixFileView(fileB), a, b, converted);
+	if (!converted.empty()) {
+		std::cout << "Layout:\t\tB converted to the layout of A\n";
+	}
+	InnerArray c;
+	if (MATRIX_FILE_C != NULL) {
+		if (!fileC.create(MATRIX_FILE_C, M_VAL_TYPE_ID, m, n, a.layout, a.tile)) {
+			std::cerr << fileC.error() << "\n";
+			return 1;
+		}
+	}
+	else {
+		c.resize(m * n);
+	}
+	const MatrixView C = MATRIX_FILE_C != NULL ? matrixFileView(fileC)
+			: MatrixView(&c[0], n, square ? n : 0, tiled ? (M_SIZE_TYPE) a.tile : 0);
+
+	// Morton-Daten sind nur kachelweise zeilenweise: Die Rekursion endet genau
+	// auf den Kacheln, abgeschaelt (block()) wird dort nicht
+	if (tiled) {
+		CUT_OFF = (M_SIZE_TYPE) a.tile;
+	}
+	if (tiled && !isStrassenDivisible(n)) {
+		std::cerr << "Tiled files need n / tile = 2^k (n " << n << ", tile " << a.tile << ")\n";
+		return 1;
+	}
+	std::cout << "Cut-Off:\t" << CUT_OFF << " (tasks: " << (CUT_OFF_TASK > CUT_OFF ? CUT_OFF_TASK : CUT_OFF) << ")\n";
+	std::cout << "Algorithm:\t" << (square ? strassenVariantName(STRASSEN_VARIANT) : "Strassen (dynamic peeling)") << "\n";
+	const OutOfCorePlan plan = outOfCorePlan(n, tiled ? (M_SIZE_TYPE) a.tile : 0, (size_t) OOC_BUDGET_MIB << 20);
+	const std::string scratchDir = outOfCore ? scratchDirectory() : "";
+	if (square && !capsBudgetFits(outOfCore ? plan.inCore : n)) {
+		return 1;
+	}
+	if (outOfCore) {
+		std::cout << "Out-of-core:\t" << plan.levels << " level(s) on disk, in core from " << plan.inCore << " x " << plan.inCore
+				  << ", RAM " << (plan.ramBytes >> 20) << " of " << OOC_BUDGET_MIB << " MiB, scratch " << (plan.scratchBytes >> 20) << " MiB in " << scratchDir << "\n";
+		if (plan.overBudget) {
+			std::cout << "Out-of-core:\tbudget below the working set of the smallest level (" << plan.inCore << " x " << plan.inCore << "), exceeding it\n";
+		}
+		initWorkspaces(outOfCoreWorkspaceElements(plan));
+	}
+	else {
+		const M_SIZE_TYPE gemmElements = gemmPackElements(m, n, k);
+		const M_SIZE_TYPE strassenElements = square ? strassenWorkspaceElements(n) : strassenRectWorkspaceElements(m, n, k);
+		initWorkspaces(gemmElements > strassenElements ? gemmElements : strassenElements);
+	}
+
+	const bool parallel = RUN_STRASSEN_PAR != 0;
+	std::string error;
+	traceBegin(m > n ? (m > k ? m : k) : (n > k ? n : k));
+	counters.start();
+	t0 = tick_count::now();
+	if (outOfCore) {
+		if (!strassenOutOfCore(C, A, B, plan, scratchDir, parallel, error)) {
+			std::cerr << error << "\n";
+			return 1;
+		}
+	}
+	else if (square) {
+		parallel ? strassenMultiplyPar(C, A, B, n) : strassenMultiplySeq(C, A, B, n);
+	}
+	else {
+		parallel ? strassenRectPar(C, A, B, m, n, k) : strassenRectRecursive(C, A, B, m, n, k);
+	}
+	t1 = tick_count::now();
+	counters.stop();
+	traceEnd(parallel ? "Strassen Par" : "Strassen Seq", square ? strassenVariantName(STRASSEN_VARIANT) : strassenVariantName(VARIANT_STRASSEN), (t1 - t0).seconds());
+	std::cout << (parallel ? "Strassen Par:\t" : "Strassen Seq:\t") << "Time was " << (t1 - t0).seconds() << "s - "
+			  << 2.0 * m * n * k / (t1 - t0).seconds() * 1e-9 << " GFLOP/s (effective)\n";
+	counters.print(std::cout, (t1 - t0).seconds());
+
+	if (VERIFY_VECTORS != 0 && tiled && outOfCore) {
+		// Die zeilenweisen Kopien fuer Freivalds passen hier nicht in den Speicher
+		std::cout << "Freivalds:\tskipped (tiled files in out-of-core mode)\n";
+	}
+	else if (VERIFY_VECTORS != 0 && tiled) {
+		// Freivalds arbeitet zeilenweise: Kopien nur fuer die Pruefung
+		InnerArray ra(n * n), rb(n * n), rc(n * n);
+		matrixFromMorton(MatrixView(&ra[0], n, n), A, n);
+		matrixFromMorton(MatrixView(&rb[0], n, n), B, n);
+		matrixFromMorton(MatrixView(&rc[0], n, n), C, n);
+		reportVerification(ConstMatrixView(&rc[0], n, n), ConstMatrixView(&ra[0], n, n), ConstMatrixView(&rb[0], n, n), n, n, n);
+	}
+	else {
+		reportVerification(C, A, B, m, n, k);
+	}
+	if (MATRIX_FILE_C != NULL) {
+		t0 = tick_count::now();
+		if (!fileC.sync()) {
+			std::cerr << "Could not write " << MATRIX_FILE_C << "\n";
+			return 1;
+		}
+		t1 = tick_count::now();
+		std::cout << "Result:\t\twritten to " << MATRIX_FILE_C << " (" << matrixFileLayoutName(a.layout) << "), sync " << (t1 - t0).seconds() << "s\n";
+	}
+	reportTrace();
+	std::cout << "\n\nEND\n" ;
+	return 0;
+}
+
+/**
+*  @brief  Stapelbetrieb: count unabhaengige Produkte n x n, einmal als
+*  Schleife ueber gemm (parallel innerhalb eines Produkts) und einmal per
+*  gemmStridedBatched (parallel ueber den Stapel).
+*  @param      n  Matrixdimension (NxN) eines Eintrags.
+*  @param  count  Anzahl der Eintraege.
+*  @return 0 bei Erfolg.
+*/
+static int runBatched(const M_SIZE_TYPE& n, const M_SIZE_TYPE& count) {
+	tick_count t0, t1;
+	PerfCounters counters;
+	const M_SIZE_TYPE stride = n * n;
+	MatrixStorage a(count * stride), b(count * stride), c1(count * stride), c2(count * stride);
+	const double flops = 2.0 * n * n * n * count;
+
+	initializeRandpriomMatrix(MatrixView(&a[0], n, 0), count * n, n, RANDOM_STREAM_A);
+	initializeRandpriomMatrix(MatrixView(&b[0], n, 0), count * n, n, RANDOM_STREAM_B);
+
+	counters.start();
+	t0 = tick_count::now();
+	for (M_SIZE_TYPE i = 0; i < count; ++i) {
+		gemm('N', 'N', n, n, n, (M_VAL_TYPE) 1, &a[i * stride], n, &b[i * stride], n, (M_VAL_TYPE) 0, &c2[i * stride], n);
+	}
+	t1 = tick_count::now();
+	counters.stop();
+	std::cout << "Loop of gemm:\tTime was " << (t1 - t0).seconds() << "s - " << flops / (t1 - t0).seconds() * 1e-9 << " GFLOP/s\n";
+	counters.print(std::cout, (t1 - t0).seconds());
+
+	counters.start();
+	t0 = tick_count::now();
+	gemmStridedBatched('N', 'N', n, n, n, (M_VAL_TYPE) 1, &a[0], n, stride, &b[0], n, stride, (M_VAL_TYPE) 0, &c1[0], n, stride, count);
+	t1 = tick_count::now();
+	counters.stop();
+	std::cout << "Batched:\tTime was " << (t1 - t0).seconds() << "s - " << flops / (t1 - t0).seconds() * 1e-9 << " GFLOP/s\n";
+	counters.print(std::cout, (t1 - t0).seconds());
+	compareMatrices(MatrixView(&c1[0], n, 0), MatrixView(&c2[0], n, 0), count * n, n) ? std::cout << "Num stability:\tSome differences!\n" : std::cout << "Num stability:\tOK\n";
+
+	std::cout << "\n\nEND\n" ;
+	return 0;
+}
+
+#if !M_VAL_IS_INTEGER
+/**
+*  @brief  Gibt einen Rueckwaertsfehler (inverseResidual) absolut und in
+*  Vielfachen der Maschinengenauigkeit aus.
+*/
+static void reportResidual(const char* label, const double residual) {
+	std::cout << label << residual << " (" << residual / std::numeric_limits<M_VAL_TYPE>::epsilon() << " eps)\n";
+}
+#endif
+
+/**
+*  @brief  Inversionsbetrieb (-I): invertiert A nach Strassen (siehe
+*  Inverse.h), loest A X = B ueber X = A^-1 B und gibt die normweisen
+*  Rueckwaertsfehler aus (Zufallsvektoren: -v, mindestens einer). Referenz
+*  (-r 1...) ist Gauss-Jordan mit Spaltenpivotsuche. Da zwischen den Bloecken
+*  nicht pivotisiert wird, wird A streng diagonaldominant gemacht (dann sind
+*  auch A11 und alle Schur-Komplemente regulaer), auch im DEBUG-Modus mit
+*  konstanten Eintraegen.
+*  @param  n  Matrixdimension (NxN).
+*  @return 0 bei Erfolg.
+*/
+static int runInverse(const M_SIZE_TYPE& n) {
+#if M_VAL_IS_INTEGER
+	(void) n;
+	std::cerr << "Inversion needs a floating-point element type (-d float or -d double)\n";
+	return 1;
+#else
+	std::cout << "Dimension:\t" << n << " x " << n << "\n";
+	std::cout << "Algorithm:\tStrassen inversion (Gauss-Jordan below " << INVERSE_CUT_OFF << "), products: " << strassenVariantName(STRASSEN_VARIANT)
+			  << ", cut-off " << CUT_OFF << "\n";
+	tick_count t0, t1;
+	PerfCounters counters;
+	MatrixStorage a(n * n), b(n * n), inverse(n * n), x(n * n);
+	const MatrixView A(&a[0], n, n);
+	const MatrixView B(&b[0], n, n);
+	const MatrixView Inverse(&inverse[0], n, n);
+	const MatrixView X(&x[0], n, n);
+	const ConstMatrixView identity(NULL, n, n);
+	const int vectors = VERIFY_VECTORS != 0 ? VERIFY_VECTORS : 1;
+	const double flops = 2.0 * n * n * n;
+
+	initializeRandpriomMatrix(A, n, n, RANDOM_STREAM_A);
+	initializeRandpriomMatrix(B, n, n, RANDOM_STREAM_B);
+	for (M_SIZE_TYPE i = 0; i < n; ++i) {
+		M_VAL_TYPE sum = 0;
+		for (M_SIZE_TYPE j = 0; j < n; ++j) {
+			sum += fabs(A[i][j]);
+		}
+		A[i][i] += 2 * sum;	// |a_ii| > Summe der uebrigen Betraege der Zeile
+	}
+
+	const M_SIZE_TYPE inverseElements = inverseWorkspaceElements(n);
+	const M_SIZE_TYPE productElements = strassenWorkspaceElements(n);
+	initWorkspaces(inverseElements > productElements ? inverseElements : productElements);
+
+	if (RUN_NAIV_SEQ != 0) {
+		t0 = tick_count::now();
+		const bool regular = inverseGaussJordan(Inverse, A, n);
+		t1 = tick_count::now();
+		std::cout << "Gauss-Jordan:\tTime was " << (t1 - t0).seconds() << "s - " << flops / (t1 - t0).seconds() * 1e-9 << " GFLOP/s\n";
+		if (regular) {
+			reportResidual("Residual:\t", inverseResidual(A, Inverse, identity, n, vectors));
+		}
+		else {
+			std::cout << "Residual:\tA is singular\n";
+		}
+	}
+
+	counters.start();
+	t0 = tick_count::now();
+	const bool regular = strassenInvert(Inverse, A, n);
+	t1 = tick_count::now();
+	counters.stop();
+	if (!regular) {
+		std::cerr << "Inversion failed: a diagonal block is singular (no pivoting between the blocks)\n";
+		return 1;
+	}
+	std::cout << "Inversion:\tTime was " << (t1 - t0).seconds() << "s - " << flops / (t1 - t0).seconds() * 1e-9 << " GFLOP/s (2 n^3 of Gauss-Jordan)\n";
+	counters.print(std::cout, (t1 - t0).seconds());
+	reportResidual("Residual:\t||A (A^-1 x) - x|| / (||A|| ||A^-1 x|| + ||x||) = ", inverseResidual(A, Inverse, identity, n, vectors));
+
+	counters.start();
+	t0 = tick_count::now();
+	strassenMultiplyPar(X, Inverse, B, n);
+	t1 = tick_count::now();
+	counters.stop();
+	std::cout << "Solve:\t\tTime was " << (t1 - t0).seconds() << "s - " << flops / (t1 - t0).seconds() * 1e-9 << " GFLOP/s (X = A^-1 B, " << n << " right-hand sides)\n";
+	counters.print(std::cout, (t1 - t0).seconds());
+	reportResidual("Residual:\t||A X x - B x|| / (||A|| ||X x|| + ||B x||) = ", inverseResidual(A, X, B, n, vectors));
+
+	std::cout << "\n\nEND\n" ;
+	return 0;
+#endif
+}
+
+/**
+*  @brief  Fuehrt die Algorithmen mit dem Werttyp dieses Namensraums aus
+*  (Argumente und Scheduler sind bereits initialisiert, siehe main).
+*  @return 0 bei Erfolg.
+*/
+int run() {
+	// Cut-Offs: Tuning auf dieser Maschine bzw. Profil laden (sofern nicht per -c/-C gesetzt)
+	const std::string profilePath = tuneProfilePath();
+	if (TUNE_MODE != 0) {
+		const M_SIZE_TYPE tuneSize = M_SIZE >= TUNE_MIN_SIZE ? M_SIZE : TUNE_DEFAULT_SIZE;
+		std::cout << "Tuning:\t\t" << tuneSize << " x " << tuneSize << ", " << tuneProfileKey() << "\n";
+		const TuneProfile profile = tuneCutOffs(tuneSize, TUNE_MODE);
+		if (saveTuneProfile(profilePath, profile)) {
+			std::cout << "Profile:\tsaved to " << profilePath << "\n";
+		}
+		else {
+			std::cerr << "Could not write profile " << profilePath << "\n";
+		}
+	}
+	else if (!CUT_OFF_FIXED) {
+		TuneProfile profile;
+		if (loadTuneProfile(profilePath, profile)) {
+			CUT_OFF = profile.cutOff;
+			CUT_OFF_TASK = profile.cutOffTask;
+			std::cout << "Profile:\tloaded from " << profilePath << "\n";
+		}
+	}
+	if (!BENCH_SIZES.empty()) {
+		for (size_t s = 0; s < BENCH_SIZES.size(); ++s) {
+			if (!capsBudgetFits(BENCH_SIZES[s])) {
+				return 1;
+			}
+		}
+		return runBenchmark();
+	}
+	if (MATRIX_FILE_A != NULL) {
+		if (MATRIX_FILE_TILE >= 0 && createRandomFiles() != 0) {
+			return 1;
+		}
+		return runFiles();
+	}
+	if (BATCH_COUNT != 0) {
+		std::cout << "Batch:\t\t" << BATCH_COUNT << " x (" << M_SIZE << " x " << M_SIZE << ")\n";
+		return runBatched(M_SIZE, BATCH_COUNT);
+	}
+	if (RUN_INVERSE != 0) {
+		return runInverse(M_SIZE);
+	}
+	const M_SIZE_TYPE rows = M_ROWS != 0 ? M_ROWS : M_SIZE;
+	const M_SIZE_TYPE inner = M_INNER != 0 ? M_INNER : M_SIZE;
+	if (rows != M_SIZE || inner != M_SIZE) {
+		std::cout << "Dimension:\t" << rows << " x " << inner << " * " << inner << " x " << M_SIZE << "\n";
+		std::cout << "Cut-Off:\t" << CUT_OFF << " (tasks: " << (CUT_OFF_TASK > CUT_OFF ? CUT_OFF_TASK : CUT_OFF) << ")\n";
+		std::cout << "Algorithm:\t" << strassenVariantName(VARIANT_STRASSEN) << " (dynamic peeling)\n";
+		return runRectangular(rows, M_SIZE, inner);
+	}
+	std::cout << "Dimension:\t" << M_SIZE << " x " << M_SIZE << "\n";
+	std::cout << "Cut-Off:\t" << CUT_OFF << " (tasks: " << (CUT_OFF_TASK > CUT_OFF ? CUT_OFF_TASK : CUT_OFF) << ")\n";
+	std::cout << "Algorithm:\t" << strassenVariantName(STRASSEN_VARIANT);
+	if (STRASSEN_VARIANT == VARIANT_FLOW_GRAPH && FLOW_PRODUCTS_IN_FLIGHT > 0) {
+		std::cout << ", max. " << FLOW_PRODUCTS_IN_FLIGHT << " products in flight";
+	}
+	std::cout << "\n";
+	if (STRASSEN_VARIANT == VARIANT_CAPS) {
+		std::cout << "CAPS plan:\t" << capsPlan(M_SIZE) << ", budget " << MEMORY_BUDGET_MIB << " MiB (0: unlimited)\n";
+	}
+	if (!capsBudgetFits(M_SIZE)) {
+		return 1;
+	}
+	std::cout << "Layout:\t\t" << (MATRIX_LAYOUT == 0 ? "row-major" : MATRIX_LAYOUT == 1 ? "Morton" : "row-major + Morton") << "\n";
+
+	// Allokation und Initialisierung gemaess NUMA_POLICY (Seiten bei den rechnenden Threads)
+	tick_count t0 = tick_count::now(), t1;
+	PerfCounters counters;
+	Matrix A(M_SIZE, InnerArray(M_SIZE));
+	Matrix B(M_SIZE, InnerArray(M_SIZE));
+	Matrix C1(M_SIZE, InnerArray(M_SIZE));
+	Matrix C2(M_SIZE, InnerArray(M_SIZE));
+
+	initializeRandpriomMatrix(A, M_SIZE, RANDOM_STREAM_A);
+	initializeRandpriomMatrix(B, M_SIZE, RANDOM_STREAM_B);
+	t1 = tick_count::now();
+	std::cout << "NUMA:\t\t" << numaNodes() << " node(s), " << numaPolicyName(NUMA_POLICY) << ", setup " << (t1 - t0).seconds() << "s\n";
+
+	printMatrix(A, "A");
+	printMatrix(B, "B");
+
+	// Workspace fuer die Zwischenmatrizen und Packpuffer einmalig reservieren
+	if (RUN_NAIV_PAR != 0 || RUN_STRASSEN_SEQ != 0 || RUN_STRASSEN_PAR != 0) {
+		const M_SIZE_TYPE gemmElements = gemmPackElements(M_SIZE, M_SIZE, M_SIZE);
+		const M_SIZE_TYPE strassenElements = RUN_STRASSEN_SEQ != 0 || RUN_STRASSEN_PAR != 0 ? strassenWorkspaceElements(M_SIZE) : 0;
+		initWorkspaces(gemmElements > strassenElements ? gemmElements : strassenElements);
+	}
+
+	// Leistung des Mikrokernels in den Blaettern messen (ein Kern)
+	if (RUN_STRASSEN_SEQ != 0 || RUN_STRASSEN_PAR != 0) {
+		const KernelInfo& kernel = activeKernel();
+		const double gflops = kernelBenchmark(CUT_OFF);
+		const double peak = cpuFrequencyGHz() * kernel.flopsPerCycle;
+		std::cout << "Kernel:\t\t" << kernel.name << " " << kernel.mr << "x" << kernel.nr << ", "
+				  << gflops << " GFLOP/s per core at n = " << CUT_OFF;
+		if (peak > 0) {
+			std::cout << " (" << 100.0 * gflops / peak << "% of " << peak << " GFLOP/s peak)";
+		}
+		std::cout << "\n";
+	}
+
+	// Naiv
+	if (RUN_NAIV_SEQ != 0) {
+		resetValuesMatrix(C2, M_SIZE);
+		counters.start();
+		t0 = tick_count::now();
+		matrixMultSeq(C2, A, B, M_SIZE);
+		t1 = tick_count::now();
+		counters.stop();
+		printMatrix(C2, "C2 = A * B");
+		std::cout << "Naiv Seq:\tTime was " << (t1 - t0).seconds() << "s - Naiv\n";
+		counters.print(std::cout, (t1 - t0).seconds());
+	}
+
+	// Naiv-Parallel
+	if (RUN_NAIV_PAR != 0) {
+		resetValuesMatrix(C2, M_SIZE);
+		counters.start();
+		t0 = tick_count::now();
+		gemmPar(C2, A, B, M_SIZE, M_SIZE, M_SIZE);
+		t1 = tick_count::now();
+		counters.stop();
+		printMatrix(C2, "C2 = A * B");
+		std::cout << "Naiv Par:\tTime was " << (t1 - t0).seconds() << "s - Naiv-Parallel (tiled GEMM)\n";
+		counters.print(std::cout, (t1 - t0).seconds());
+	}
+
+	// Morton-Layout: Kacheln der Groesse CUT_OFF, Quadranten zusammenhaengend
+	const M_SIZE_TYPE mortonTile = CUT_OFF < M_SIZE ? CUT_OFF : M_SIZE;
+	const M_SIZE_TYPE mortonSize = MATRIX_LAYOUT != 0 ? M_SIZE : 0;
+	Matrix Az(mortonSize, InnerArray(mortonSize));
+	Matrix Bz(mortonSize, InnerArray(mortonSize));
+	Matrix Cz(mortonSize, InnerArray(mortonSize));
+	if (MATRIX_LAYOUT != 0) {
+		if (!isMortonCompatible(M_SIZE, mortonTile)) {
+			std::cerr << "Morton layout requires n / c to be a power of two\n";
+			return 1;
+		}
+		counters.start();
+		t0 = tick_count::now();
+		matrixToMorton(MatrixView(&Az.mdArray[0], M_SIZE, M_SIZE, mortonTile), A, M_SIZE);
+		matrixToMorton(MatrixView(&Bz.mdArray[0], M_SIZE, M_SIZE, mortonTile), B, M_SIZE);
+		t1 = tick_count::now();
+		counters.stop();
+		std::cout << "Morton conv:\tTime was " << (t1 - t0).seconds() << "s - A, B to Morton\n";
+		counters.print(std::cout, (t1 - t0).seconds());
+	}
+	const MatrixView AzView(&Az.mdArray[0], M_SIZE, M_SIZE, mortonTile);
+	const MatrixView BzView(&Bz.mdArray[0], M_SIZE, M_SIZE, mortonTile);
+	const MatrixView CzView(&Cz.mdArray[0], M_SIZE, M_SIZE, mortonTile);
+
+	// Strassen-Algorithmus: Non-Tasks
+	if (RUN_STRASSEN_SEQ != 0 && MATRIX_LAYOUT != 1) {
+		resetValuesMatrix(C1, M_SIZE);
+		traceBegin(M_SIZE);
+		counters.start();
+		t0 = tick_count::now();
+		strassenMultiplySeq(C1, A, B, M_SIZE);
+		t1 = tick_count::now();
+		counters.stop();
+		traceEnd("Strassen Seq", strassenVariantName(STRASSEN_VARIANT), (t1 - t0).seconds());
+		printMatrix(C1, "C1 = A * B");
+		std::cout << "Strassen Seq:\tTime was " << (t1 - t0).seconds() << "s - Strassen-Alg.: Non-Tasks\n";
+		counters.print(std::cout, (t1 - t0).seconds());
+		reportVerification(C1, A, B, M_SIZE, M_SIZE, M_SIZE);
+		if (RUN_NAIV_PAR) {
+			compareMatrices(C1, C2, M_SIZE) ? std::cout << "Num stability:\tSome differences!\n" : std::cout << "Num stability:\tOK\n";
+		}
+	}
+
+	// Strassen-Algorithmus: Non-Tasks (Morton-Layout)
+	if (RUN_STRASSEN_SEQ != 0 && MATRIX_LAYOUT != 0) {
+		traceBegin(M_SIZE);
+		counters.start();
+		t0 = tick_count::now();
+		strassenMultiplySeq(CzView, AzView, BzView, M_SIZE);
+		t1 = tick_count::now();
+		counters.stop();
+		traceEnd("Strassen Seq Z", strassenVariantName(STRASSEN_VARIANT), (t1 - t0).seconds());
+		matrixFromMorton(C1, CzView, M_SIZE);
+		printMatrix(C1, "C1 = A * B");
+		std::cout << "Strassen Seq Z:\tTime was " << (t1 - t0).seconds() << "s - Strassen-Alg.: Non-Tasks (Morton)\n";
+		counters.print(std::cout, (t1 - t0).seconds());
+		reportVerification(C1, A, B, M_SIZE, M_SIZE, M_SIZE);
+		if (RUN_NAIV_PAR) {
+			compareMatrices(C1, C2, M_SIZE) ? std::cout << "Num stability:\tSome differences!\n" : std::cout << "Num stability:\tOK\n";
+		}
+	}
+
+	// Strassen-Algorithmus: Tasks
+	if (RUN_STRASSEN_PAR != 0 && MATRIX_LAYOUT != 1) {
+		resetValuesMatrix(C1, M_SIZE);
+		traceBegin(M_SIZE);
+		counters.start();
+		t0 = tick_count::now();
+		strassenMultiplyPar(C1, A, B, M_SIZE);
+		t1 = tick_count::now();
+		counters.stop();
+		traceEnd("Strassen Par", strassenVariantName(STRASSEN_VARIANT), (t1 - t0).seconds());
+		printMatrix(C1, "C1 = A * B");
+		std::cout << "Strassen Par:\tTime was " << (t1 - t0).seconds() << "s - Strassen-Alg.: Tasks\n";
+		counters.print(std::cout, (t1 - t0).seconds());
+		reportVerification(C1, A, B, M_SIZE, M_SIZE, M_SIZE);
+		if (RUN_NAIV_PAR) {
+			compareMatrices(C1, C2, M_SIZE) ? std::cout << "Num stability:\tSome differences!\n" : std::cout << "Num stability:\tOK\n";
+		}
+	}
+
+	// Strassen-Algorithmus: Tasks (Morton-Layout)
+	if (RUN_STRASSEN_PAR != 0 && MATRIX_LAYOUT != 0) {
+		traceBegin(M_SIZE);
+		counters.start();
+		t0 = tick_count::now();
+		strassenMultiplyPar(CzView, AzView, BzView, M_SIZE);
+		t1 = tick_count::now();
+		counters.stop();
+		traceEnd("Strassen Par Z", strassenVariantName(STRASSEN_VARIANT), (t1 - t0).seconds());
+		matrixFromMorton(C1, CzView, M_SIZE);
+		printMatrix(C1, "C1 = A * B");
+		std::cout << "Strassen Par Z:\tTime was " << (t1 - t0).seconds() << "s - Strassen-Alg.: Tasks (Morton)\n";
+		counters.print(std::cout, (t1 - t0).seconds());
+		reportVerification(C1, A, B, M_SIZE, M_SIZE, M_SIZE);
+		if (RUN_NAIV_PAR) {
+			compareMatrices(C1, C2, M_SIZE) ? std::cout << "Num stability:\tSome differences!\n" : std::cout << "Num stability:\tOK\n";
+		}
+	}
+
+	if (RUN_NAIV_PAR != 0 || RUN_STRASSEN_SEQ != 0 || RUN_STRASSEN_PAR != 0) {
+		std::cout << "Workspace:\t" << (workspaceReservedBytes() >> 20) << " MiB reserved, "
+				  << (workspacePeakBytes() >> 20) << " MiB peak, "
+				  << workspaceOverflows() << " overflows, "
+				  << (heapPeakBytes() >> 20) << " MiB heap peak\n";
+	}
+	reportTrace();
+
+	std::cout << "\n\nEND\n" ;
+	return 0;
+}
+
+} // namespace M_VAL_NAMESPACE
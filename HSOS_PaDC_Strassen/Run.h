@@ -0,0 +1,33 @@
+//============================================================================
+// Name        : Run.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef RUN_H_
+#define RUN_H_
+
+/*
+ * Einstiegspunkte je Werttyp (Run.cpp wird je Werttyp uebersetzt).
+ */
+namespace strassen_float {
+int run();
+}
+
+namespace strassen_double {
+int run();
+}
+
+namespace strassen_int32 {
+int run();
+}
+
+namespace strassen_int64 {
+int run();
+}
+
+#endif
@@ -0,0 +1,177 @@
+//============================================================================
+// Name        : RunMpi.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Distributed.h"
+#include "Helper.h"
+#include "RunMpi.h"
+#include <limits.h>
+#include <tbb/tick_count.h>
+
+namespace M_VAL_NAMESPACE {
+
+using tbb::tick_count;
+
+/**
+*  @brief  Gibt das Ergebnis der verteilten Freivalds-Pruefung aus (Rang 0).
+*/
+static void reportDistVerification(const DistGrid& grid, const ConstMatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& b) {
+	if (VERIFY_VECTORS == 0 || grid.layer != 0) {
+		return;
+	}
+	const tick_count t0 = tick_count::now();
+	const VerifyResult result = distVerify(grid, C, A, B, b, VERIFY_VECTORS);
+	const tick_count t1 = tick_count::now();
+	if (grid.rank == 0) {
+		std::cout << "Freivalds:\t" << (result.ok ? "OK" : "FAILED") << " - " << VERIFY_VECTORS << " vector(s), row " << result.row
+				  << ": residual " << result.residual << ", bound " << result.bound << ", time " << (t1 - t0).seconds() << "s\n";
+	}
+}
+
+/**
+*  @brief  Verteilte Multiplikation n x n (-n) mit dem verteilten Strassen
+*  (-D, siehe Distributed.h): Jeder Prozess erzeugt seine Streifen von A und
+*  B (dieselben Werte wie das Programm ohne MPI bei gleichem Startwert).
+*  Ausgaben nur auf Rang 0.
+*  @return 0 bei Erfolg.
+*/
+static int runDistributedStrassen() {
+	DistStrassenLayout layout;
+	std::string error;
+	const M_SIZE_TYPE n = M_SIZE;
+	if (!distStrassenLayout(layout, DIST_STRASSEN_LEVELS, n, error)) {
+		if (layout.rank == 0) {
+			std::cerr << error << "\n";
+		}
+		return 1;
+	}
+	const bool root = layout.rank == 0;
+	const M_SIZE_TYPE h = layout.h;
+	if (root) {
+		double multiplications = 1;
+		for (int l = 0; l < layout.levels; ++l) {
+			multiplications *= 7.0 / 8.0;
+		}
+		std::cout << "Processes:\t" << layout.size << " (one product each)\n";
+		std::cout << "Dimension:\t" << n << " x " << n << ", products " << h << " x " << h << "\n";
+		std::cout << "Algorithm:\tdistributed Strassen, " << layout.levels << " level(s), local gemm (tiled GEMM or Strassen, cut-off " << CUT_OFF << ")\n";
+		std::cout << "Products:\t" << layout.size << " x " << 2.0 * h * h * h * 1e-9 << " GFLOP (" << multiplications << " x the multiplications of SUMMA)\n";
+	}
+
+	const M_SIZE_TYPE rows = layout.blocks * layout.rows;
+	MatrixStorage a(rows * n), bb(rows * n), c(rows * n);
+	const MatrixView A(&a[0], n, 0);
+	const MatrixView B(&bb[0], n, 0);
+	const MatrixView C(&c[0], n, 0);
+	for (M_SIZE_TYPE R = 0; R < layout.blocks; ++R) {
+		initializeRandpriomBlock(A.block(R * layout.rows, 0), layout.rows, n, R * h + layout.first, 0, n, RANDOM_STREAM_A);
+		initializeRandpriomBlock(B.block(R * layout.rows, 0), layout.rows, n, R * h + layout.first, 0, n, RANDOM_STREAM_B);
+	}
+
+	DistStrassenTimes times;
+	MPI_Barrier(MPI_COMM_WORLD);
+	const tick_count t0 = tick_count::now();
+	distStrassenMultiply(layout, C, A, B, times);
+	MPI_Barrier(MPI_COMM_WORLD);
+	const tick_count t1 = tick_count::now();
+
+	// Langsamster Prozess je Phase
+	double local[4] = { times.form, times.exchange, times.multiply, times.combine }, slowest[4];
+	MPI_Reduce(local, slowest, 4, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+	if (root) {
+		std::cout << "Strassen:\tTime was " << (t1 - t0).seconds() << "s - " << 2.0 * n * n * n / (t1 - t0).seconds() * 1e-9 << " GFLOP/s\n";
+		std::cout << "Processes:\tform max " << slowest[0] << "s, exchange max " << slowest[1] << "s, multiply max " << slowest[2]
+				  << "s, combine max " << slowest[3] << "s\n";
+	}
+	if (VERIFY_VECTORS != 0) {
+		const tick_count v0 = tick_count::now();
+		const VerifyResult result = distStrassenVerify(layout, C, A, B, VERIFY_VECTORS);
+		const tick_count v1 = tick_count::now();
+		if (root) {
+			std::cout << "Freivalds:\t" << (result.ok ? "OK" : "FAILED") << " - " << VERIFY_VECTORS << " vector(s), row " << result.row
+					  << ": residual " << result.residual << ", bound " << result.bound << ", time " << (v1 - v0).seconds() << "s\n";
+		}
+	}
+
+	if (root) {
+		std::cout << "\n\nEND\n" ;
+	}
+	return 0;
+}
+
+/**
+*  @brief  Verteilte Multiplikation n x n (-n) mit 2.5D-SUMMA: Jeder Prozess
+*  der Ebene 0 erzeugt seine Bloecke von A und B (dieselben Werte wie das
+*  Programm ohne MPI bei gleichem Startwert), gemessen wird das Produkt inkl.
+*  Replikation und Reduktion. Ausgaben nur auf Rang 0.
+*  @return 0 bei Erfolg.
+*/
+int runDistributed() {
+	if (DIST_STRASSEN_LEVELS > 0) {
+		return runDistributedStrassen();
+	}
+	DistGrid grid;
+	std::string error;
+	if (!distGridCreate(grid, DIST_LAYERS, error)) {
+		int rank;
+		MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+		if (rank == 0) {
+			std::cerr << error << "\n";
+		}
+		return 1;
+	}
+	const bool root = grid.rank == 0;
+	const M_SIZE_TYPE n = M_SIZE;
+	const M_SIZE_TYPE b = n / grid.q;
+	if (n % grid.q != 0 || (double) b * b > INT_MAX) {
+		if (root) {
+			std::cerr << "Dimension " << n << " must be a multiple of " << grid.q << " with blocks of at most " << INT_MAX << " elements\n";
+		}
+		distGridFree(grid);
+		return 1;
+	}
+	if (root) {
+		std::cout << "Processes:\t" << grid.size << " (grid " << grid.q << " x " << grid.q << " x " << grid.layers << ")\n";
+		std::cout << "Dimension:\t" << n << " x " << n << ", blocks " << b << " x " << b << "\n";
+		std::cout << "Algorithm:\t" << (grid.layers > 1 ? "2.5D SUMMA" : "2D SUMMA") << ", local gemm (tiled GEMM or Strassen, cut-off " << CUT_OFF << ")\n";
+	}
+
+	MatrixStorage a(b * b), bb(b * b), c(b * b);
+	const MatrixView A(&a[0], b, 0);
+	const MatrixView B(&bb[0], b, 0);
+	const MatrixView C(&c[0], b, 0);
+	if (grid.layer == 0) {
+		initializeRandpriomBlock(A, b, b, grid.row * b, grid.col * b, n, RANDOM_STREAM_A);
+		initializeRandpriomBlock(B, b, b, grid.row * b, grid.col * b, n, RANDOM_STREAM_B);
+	}
+
+	DistTimes times;
+	MPI_Barrier(MPI_COMM_WORLD);
+	const tick_count t0 = tick_count::now();
+	summaMultiply(grid, C, A, B, b, times);
+	MPI_Barrier(MPI_COMM_WORLD);
+	const tick_count t1 = tick_count::now();
+
+	// Langsamster Prozess je Anteil
+	double local[2] = { times.compute, times.wait }, slowest[2];
+	MPI_Reduce(local, slowest, 2, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+	if (root) {
+		std::cout << "SUMMA:\t\tTime was " << (t1 - t0).seconds() << "s - " << 2.0 * n * n * n / (t1 - t0).seconds() * 1e-9 << " GFLOP/s\n";
+		std::cout << "Processes:\tcompute max " << slowest[0] << "s, waiting for communication max " << slowest[1] << "s\n";
+	}
+	reportDistVerification(grid, C, A, B, b);
+
+	distGridFree(grid);
+	if (root) {
+		std::cout << "\n\nEND\n" ;
+	}
+	return 0;
+}
+
+} // namespace M_VAL_NAMESPACE
@@ -0,0 +1,34 @@
+//============================================================================
+// Name        : RunMpi.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef RUNMPI_H_
+#define RUNMPI_H_
+
+/*
+ * Einstiegspunkte des MPI-Programms je Werttyp (RunMpi.cpp wird je
+ * Werttyp uebersetzt).
+ */
+namespace strassen_float {
+int runDistributed();
+}
+
+namespace strassen_double {
+int runDistributed();
+}
+
+namespace strassen_int32 {
+int runDistributed();
+}
+
+namespace strassen_int64 {
+int runDistributed();
+}
+
+#endif
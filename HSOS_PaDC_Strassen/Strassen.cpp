@@ -9,6 +9,224 @@
 //============================================================================
 
 #include "Strassen.h"
+#include "Caps.h"
+#include "FlowGraph.h"
+#include "Gemm.h"
+#include "StrassenRect.h"
+#include "Winograd.h"
+#include "Workspace.h"
+
+namespace M_VAL_NAMESPACE {
+
+/**
+*  @brief  Strassens Schema als Tabellen (fuer Varianten, die die Produkte
+*  einzeln bilden, z. B. FlowGraph, OutOfCore).
+*/
+const int STRASSEN_LEFT[STRASSEN_PRODUCTS][4] = {
+	{  1, 0, 0,  1 },					// M1 = (A11 + A22) * (B11 + B22)
+	{  0, 0, 1,  1 },					// M2 = (A21 + A22) * B11
+	{  1, 0, 0,  0 },					// M3 = A11 * (B12 - B22)
+	{  0, 0, 0,  1 },					// M4 = A22 * (B21 - B11)
+	{  1, 1, 0,  0 },					// M5 = (A11 + A12) * B22
+	{ -1, 0, 1,  0 },					// M6 = (A21 - A11) * (B11 + B12)
+	{  0, 1, 0, -1 }					// M7 = (A12 - A22) * (B21 + B22)
+};
+
+const int STRASSEN_RIGHT[STRASSEN_PRODUCTS][4] = {
+	{  1, 0, 0,  1 },
+	{  1, 0, 0,  0 },
+	{  0, 1, 0, -1 },
+	{ -1, 0, 1,  0 },
+	{  0, 0, 0,  1 },
+	{  1, 1, 0,  0 },
+	{  0, 0, 1,  1 }
+};
+
+const int STRASSEN_SIGNS[4][STRASSEN_PRODUCTS] = {
+	{ 1,  0, 0, 1, -1, 0, 1 },			// C11 = M1 + M4 - M5 + M7
+	{ 0,  0, 1, 0,  1, 0, 0 },			// C12 = M3 + M5
+	{ 0,  1, 0, 1,  0, 0, 0 },			// C21 = M2 + M4
+	{ 1, -1, 1, 0,  0, 1, 0 }			// C22 = M1 - M2 + M3 + M6
+};
+
+/**
+*  @brief  Berechnet die Groesse des Workspaces je Thread fuer eine Variante
+*  mit seqTemporaries bzw. taskTemporaries Zwischenmatrizen je Ebene, sodass
+*  weder die sequentielle noch die Task-Version waehrend der Multiplikation
+*  Workspace nachfordern muss. Die Zwischenmatrizen der obersten Ebenen
+*  (ueber WORKSPACE_HEAP_ELEMENTS) liegen auf dem Heap und zaehlen nicht,
+*  so bleibt die Reservierung je Thread unabhaengig von n beschraenkt.
+*  @param                n  Matrixdimension (NxN).
+*  @param   seqTemporaries  Zwischenmatrizen je Ebene (sequentiell).
+*  @param  taskTemporaries  Zwischenmatrizen je Ebene (Tasks).
+*  @return Benoetigte Elemente je Thread.
+*/
+M_SIZE_TYPE variantWorkspaceElements(const M_SIZE_TYPE& n, const M_SIZE_TYPE& seqTemporaries, const M_SIZE_TYPE& taskTemporaries) {
+	const M_SIZE_TYPE seq = workspaceSeriesElements(n, CUT_OFF, seqTemporaries);
+	const M_SIZE_TYPE task = TASK_WORKSPACE_SLACK * workspaceSeriesElements(n, CUT_OFF, taskTemporaries);
+	const M_SIZE_TYPE pack = TASK_WORKSPACE_SLACK * gemmPackElements(CUT_OFF, CUT_OFF, CUT_OFF);
+	return (seq > task ? seq : task) + pack;
+}
+
+/**
+*  @brief  Berechnet die Groesse des Workspaces je Thread fuer die mit
+*  STRASSEN_VARIANT ausgewaehlte Variante.
+*  @param  n  Matrixdimension (NxN).
+*  @return Benoetigte Elemente je Thread.
+*/
+M_SIZE_TYPE strassenWorkspaceElements(const M_SIZE_TYPE& n) {
+	if (!isStrassenDivisible(n)) {
+		return strassenRectWorkspaceElements(n, n, n);
+	}
+	switch (STRASSEN_VARIANT) {
+	case VARIANT_WINOGRAD:
+		return winogradWorkspaceElements(n);
+	case VARIANT_FLOW_GRAPH:
+		return flowGraphWorkspaceElements(n);
+	case VARIANT_CAPS:
+		return capsWorkspaceElements(n);
+	default:
+		return variantWorkspaceElements(n, SEQ_TEMPORARIES, TASK_TEMPORARIES);
+	}
+}
+
+/**
+*  @brief  Liefert den Namen einer Variante fuer Ausgaben.
+*/
+const char* strassenVariantName(const int variant) {
+	switch (variant) {
+	case VARIANT_WINOGRAD:
+		return "Strassen-Winograd";
+	case VARIANT_FLOW_GRAPH:
+		return "Strassen (flow graph)";
+	case VARIANT_CAPS:
+		return "Strassen (CAPS BFS/DFS)";
+	default:
+		return "Strassen";
+	}
+}
+
+/**
+*  @brief  Multipliziert zwei Matrizen sequentiell mit der ueber
+*  STRASSEN_VARIANT ausgewaehlten Variante. Laesst sich n nicht bis zum
+*  Cut-Off halbieren, wird die Variante mit Abschaelen verwendet.
+*  @param  C  Matrix C (Ergebnismatrix, wird ueberschrieben).
+*  @param  A  Matrix A.
+*  @param  B  Matrix B.
+*  @param  n  Matrixdimension (NxN).
+*/
+void strassenMultiplySeq(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
+	if (!isStrassenDivisible(n)) {
+		strassenRectRecursive(C, A, B, n, n, n);
+		return;
+	}
+	switch (STRASSEN_VARIANT) {
+	case VARIANT_WINOGRAD:
+		winogradRecursive(C, A, B, n);
+		break;
+	case VARIANT_CAPS:
+		strassenCapsSeq(C, A, B, n);
+		break;
+	default:
+		strassenRecursive(C, A, B, n);
+		break;
+	}
+}
+
+/**
+*  @brief  Multipliziert zwei Matrizen mit Tasks mit der ueber
+*  STRASSEN_VARIANT ausgewaehlten Variante. Laesst sich n nicht bis zum
+*  Cut-Off halbieren, wird die Variante mit Abschaelen verwendet.
+*  @param  C  Matrix C (Ergebnismatrix, wird ueberschrieben).
+*  @param  A  Matrix A.
+*  @param  B  Matrix B.
+*  @param  n  Matrixdimension (NxN).
+*/
+void strassenMultiplyPar(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
+	if (!isStrassenDivisible(n)) {
+		strassenRectPar(C, A, B, n, n, n);
+		return;
+	}
+	switch (STRASSEN_VARIANT) {
+	case VARIANT_WINOGRAD:
+		tbb::task::spawn_root_and_wait(*new (tbb::task::allocate_root()) StrassenWinograd(C, A, B, n));
+		break;
+	case VARIANT_FLOW_GRAPH:
+		strassenFlowGraph(C, A, B, n);
+		break;
+	case VARIANT_CAPS:
+		strassenCaps(C, A, B, n);
+		break;
+	default:
+		tbb::task::spawn_root_and_wait(*new (tbb::task::allocate_root()) Strassen(C, A, B, n));
+		break;
+	}
+}
+
+/**
+*  @brief  Blatt der Rekursion: C = A * B mit der gekachelten GEMM ueber den
+*  gepackten SIMD-Mikrokernel bzw. der ikj-Schleife (siehe USE_SIMD_KERNEL).
+*  @param  C  Matrix C (Ergebnismatrix, wird ueberschrieben).
+*  @param  A  Matrix A.
+*  @param  B  Matrix B.
+*  @param  n  Matrixdimension (NxN).
+*/
+void strassenLeaf(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
+	TRACE_SCOPE(TRACE_LEAF, n, 3.0 * n * n * sizeof(M_VAL_TYPE), 2.0 * n * n * n);
+#if USE_SIMD_KERNEL
+	gemmSeq(C, A, B, n, n, n);
+#else
+	matrixZeroSeq(C, n);
+	matrixMultSeq(C, A, B, n);
+#endif
+}
+
+/**
+*  @brief  Funktionsobjekt fuer den ersten Teil der Kombination (partitioniert):
+*  C11 = M4 - M5, C12 = M3 + M5, C21 = M2 + M4, C22 = M3 - M2.
+*/
+struct StrassenPartitionCombinePBody {
+	MatrixView C11, C12, C21, C22;
+	ConstMatrixView M2, M3, M4, M5;
+
+	StrassenPartitionCombinePBody(const MatrixView& __C11, const MatrixView& __C12, const MatrixView& __C21, const MatrixView& __C22,
+			const ConstMatrixView& __M2, const ConstMatrixView& __M3, const ConstMatrixView& __M4, const ConstMatrixView& __M5) :
+			C11(__C11), C12(__C12), C21(__C21), C22(__C22), M2(__M2), M3(__M3), M4(__M4), M5(__M5) {
+	}
+
+	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
+		for (M_SIZE_TYPE i = range.rows().begin(); i != range.rows().end(); ++i) {
+			for (M_SIZE_TYPE j = range.cols().begin(); j != range.cols().end(); ++j) {
+				C11[i][j] 	= M4[i][j] - M5[i][j];
+				C12[i][j] 	= M3[i][j] + M5[i][j];
+				C21[i][j] 	= M2[i][j] + M4[i][j];
+				C22[i][j] 	= M3[i][j] - M2[i][j];
+			}
+		}
+	}
+};
+
+/**
+*  @brief  Funktionsobjekt fuer den zweiten Teil der Kombination (partitioniert):
+*  C11 += M1 + M7, C22 += M1 + M6.
+*/
+struct StrassenPartitionAccumulatePBody {
+	MatrixView C11, C22;
+	ConstMatrixView M1, M6, M7;
+
+	StrassenPartitionAccumulatePBody(const MatrixView& __C11, const MatrixView& __C22, const ConstMatrixView& __M1, const ConstMatrixView& __M6, const ConstMatrixView& __M7) :
+			C11(__C11), C22(__C22), M1(__M1), M6(__M6), M7(__M7) {
+	}
+
+	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
+		for (M_SIZE_TYPE i = range.rows().begin(); i != range.rows().end(); ++i) {
+			for (M_SIZE_TYPE j = range.cols().begin(); j != range.cols().end(); ++j) {
+				C11[i][j] 	+= M1[i][j] + M7[i][j];
+				C22[i][j] 	+= M1[i][j] + M6[i][j];
+			}
+		}
+	}
+};
 
 /**
 *  @brief  Vererbte und ueberschriebene Methode der tbb::task-Klasse,
@@ -18,197 +236,166 @@
 */
 #ifdef USE_PARTITIONS
 tbb::task* Strassen::execute() {
+	TRACE_TASK_START(n, is_stolen_task());
+	TRACE_SCOPE(TRACE_TASK, n, 0, 0);
 	if (n <= CUT_OFF) {
-		matrixMultSeq(C, A, B, n);
+		strassenLeaf(C, A, B, n);
+	}
+	else if (n <= CUT_OFF_TASK) {
+		strassenRecursive(C, A, B, n);
 	}
 	else {
 		const M_SIZE_TYPE newN = n >> 1;
-		// Devide & Conquer
-		Matrix A11(newN, InnerArray(newN));
-		Matrix A12(newN, InnerArray(newN));
-		Matrix A21(newN, InnerArray(newN));
-		Matrix A22(newN, InnerArray(newN));
-
-		Matrix B11(newN, InnerArray(newN));
-		Matrix B12(newN, InnerArray(newN));
-		Matrix B21(newN, InnerArray(newN));
-		Matrix B22(newN, InnerArray(newN));
-
-		for (M_SIZE_TYPE i = 0; i < newN; ++i) {
-			M_SIZE_TYPE iPlusNewN = i + newN;
-			for (M_SIZE_TYPE j = 0; j < newN; ++j) {
-				A11[i][j] = A[i][j];
-				A12[i][j] = A[i][j + newN];
-				A21[i][j] = A[iPlusNewN][j];
-				A22[i][j] = A[iPlusNewN][j + newN];
-
-				B11[i][j] = B[i][j];
-				B12[i][j] = B[i][j + newN];
-				B21[i][j] = B[iPlusNewN][j];
-				B22[i][j] = B[iPlusNewN][j + newN];
-			}
-		}
+		WorkspaceFrame frame;
+		// Devide & Conquer (Quadranten als Sichten, ohne Kopie)
+		const ConstMatrixView A11 = A.quadrant(0, 0);
+		const ConstMatrixView A12 = A.quadrant(0, 1);
+		const ConstMatrixView A21 = A.quadrant(1, 0);
+		const ConstMatrixView A22 = A.quadrant(1, 1);
+
+		const ConstMatrixView B11 = B.quadrant(0, 0);
+		const ConstMatrixView B12 = B.quadrant(0, 1);
+		const ConstMatrixView B21 = B.quadrant(1, 0);
+		const ConstMatrixView B22 = B.quadrant(1, 1);
+
+		const MatrixView C11 = C.quadrant(0, 0);
+		const MatrixView C12 = C.quadrant(0, 1);
+		const MatrixView C21 = C.quadrant(1, 0);
+		const MatrixView C22 = C.quadrant(1, 1);
 
 
 		// M2 = (A21 + A22) * B11
-		Matrix M2(newN, InnerArray(newN));
-		Matrix tmp1M2(newN, InnerArray(newN));
-		matrixAddSeq(tmp1M2, A21, A22, newN);
+		const MatrixView M2 = frame.matrix(newN, C.tile);
+		const MatrixView tmp1M2 = frame.matrix(newN, C.tile);
+		matrixAddPar(tmp1M2, A21, A22, newN);
 		set_ref_count(5);
 		spawn(*new (allocate_child()) Strassen(M2, tmp1M2, B11, newN));
 
 		// M3 = A11 * (B12 - B22)
-		Matrix M3(newN, InnerArray(newN));
-		Matrix tmp1M3(newN, InnerArray(newN));
-		matrixSubSeq(tmp1M3, B12, B22, newN);
+		const MatrixView M3 = frame.matrix(newN, C.tile);
+		const MatrixView tmp1M3 = frame.matrix(newN, C.tile);
+		matrixSubPar(tmp1M3, B12, B22, newN);
 		spawn(*new (allocate_child()) Strassen(M3, A11, tmp1M3, newN));
 
 		// M4 = A22 * (B21 - B11)
-		Matrix M4(newN, InnerArray(newN));
-		Matrix tmp1M4(newN, InnerArray(newN));
-		matrixSubSeq(tmp1M4, B21, B11, newN);
+		const MatrixView M4 = frame.matrix(newN, C.tile);
+		const MatrixView tmp1M4 = frame.matrix(newN, C.tile);
+		matrixSubPar(tmp1M4, B21, B11, newN);
 		spawn(*new (allocate_child()) Strassen(M4, A22, tmp1M4, newN));
 
 		// M5 = (A11 + A12) * B22
-		Matrix M5(newN, InnerArray(newN));
-		Matrix tmp1M5(newN, InnerArray(newN));
-		matrixAddSeq(tmp1M5, A11, A12, newN);
+		const MatrixView M5 = frame.matrix(newN, C.tile);
+		const MatrixView tmp1M5 = frame.matrix(newN, C.tile);
+		matrixAddPar(tmp1M5, A11, A12, newN);
 		spawn_and_wait_for_all(*new (allocate_child()) Strassen(M5, tmp1M5, B22, newN));
 
-		for (M_SIZE_TYPE i = 0; i < newN; ++i) {
-			M_SIZE_TYPE iPlusNewN = i + newN;
-			for (M_SIZE_TYPE j = 0; j < newN; ++j) {
-				C[i][j] 				= M4[i][j] - M5[i][j];
-				C[i][j + newN] 			= M3[i][j] + M5[i][j];
-				C[iPlusNewN][j] 		= M2[i][j] + M4[i][j];
-				C[iPlusNewN][j + newN] 	= M3[i][j] - M2[i][j];
-
-				M2[i][j] = M3[i][j] = M4[i][j] = M5[i][j] = 0;
-			}
-		}
+		matrixCombinePar(StrassenPartitionCombinePBody(C11, C12, C21, C22, M2, M3, M4, M5), newN, newN, 8, 4);
 
 
 		// M1 = (A11 + A22) * (B11 + B22)
 		// Reuse: M1 = M2 | tmp1M1 = tmp1M2 | tmp2M1 = tmp1M5
-		matrixAddSeq(tmp1M2, A11, A22, newN);
-		matrixAddSeq(tmp1M5, B11, B22, newN);
+		matrixAddPar(tmp1M2, A11, A22, newN);
+		matrixAddPar(tmp1M5, B11, B22, newN);
 		set_ref_count(4);
 		spawn(*new (allocate_child()) Strassen(M2, tmp1M2, tmp1M5, newN));
 
 		// M6 = (A21 - A11) * (B11 + B12)
 		// Reuse: M6 = M3 | tmp1M6 = tmp1M3 | M5 = tmp2M3
-		matrixSubSeq(tmp1M3, A21, A11, newN);
-		matrixAddSeq(M5, B11, B12, newN);
+		matrixSubPar(tmp1M3, A21, A11, newN);
+		matrixAddPar(M5, B11, B12, newN);
 		spawn(*new (allocate_child()) Strassen(M3, tmp1M3, M5, newN));
 
 		// M7 = (A12 - A22) * (B21 + B22)
 		// Reuse: M7 = M4 | tmp1M7 = tmp1M5 | tmp2M7 = tmp2M4
-		Matrix tmp2M4(newN, InnerArray(newN));
-		matrixSubSeq(tmp1M4, A12, A22, newN);
-		matrixAddSeq(tmp2M4, B21, B22, newN);
+		const MatrixView tmp2M4 = frame.matrix(newN, C.tile);
+		matrixSubPar(tmp1M4, A12, A22, newN);
+		matrixAddPar(tmp2M4, B21, B22, newN);
 		spawn_and_wait_for_all(*new (allocate_child()) Strassen(M4, tmp1M4, tmp2M4, newN));
 
-		for (M_SIZE_TYPE i = 0; i < newN; ++i) {
-			M_SIZE_TYPE iPlusNewN = i + newN;
-			for (M_SIZE_TYPE j = 0; j < newN; ++j) {
-				C[i][j] 				+= M2[i][j] + M4[i][j];
-				C[iPlusNewN][j + newN] 	+= M2[i][j] + M3[i][j];
-			}
-		}
+		// M1 = M2, M6 = M3, M7 = M4 (siehe Reuse oben)
+		matrixCombinePar(StrassenPartitionAccumulatePBody(C11, C22, M2, M3, M4), newN, newN, 7, 4);
  	}
 	return NULL;
 }
 #else
 tbb::task* Strassen::execute() {
+	TRACE_TASK_START(n, is_stolen_task());
+	TRACE_SCOPE(TRACE_TASK, n, 0, 0);
 	if (n <= CUT_OFF) {
-		matrixMultSeq(C, A, B, n);
+		strassenLeaf(C, A, B, n);
+	}
+	else if (n <= CUT_OFF_TASK) {
+		strassenRecursive(C, A, B, n);
 	}
 	else {
 		const M_SIZE_TYPE newN = n >> 1;
-		// Devide & Conquer
-		Matrix A11(newN, InnerArray(newN));
-		Matrix A12(newN, InnerArray(newN));
-		Matrix A21(newN, InnerArray(newN));
-		Matrix A22(newN, InnerArray(newN));
-
-		Matrix B11(newN, InnerArray(newN));
-		Matrix B12(newN, InnerArray(newN));
-		Matrix B21(newN, InnerArray(newN));
-		Matrix B22(newN, InnerArray(newN));
-
-		for (M_SIZE_TYPE i = 0; i < newN; ++i) {
-			M_SIZE_TYPE iPlusNewN = i + newN;
-			for (M_SIZE_TYPE j = 0; j < newN; ++j) {
-				A11[i][j] = A[i][j];
-				A12[i][j] = A[i][j + newN];
-				A21[i][j] = A[iPlusNewN][j];
-				A22[i][j] = A[iPlusNewN][j + newN];
-
-				B11[i][j] = B[i][j];
-				B12[i][j] = B[i][j + newN];
-				B21[i][j] = B[iPlusNewN][j];
-				B22[i][j] = B[iPlusNewN][j + newN];
-			}
-		}
+		WorkspaceFrame frame;
+		// Devide & Conquer (Quadranten als Sichten, ohne Kopie)
+		const ConstMatrixView A11 = A.quadrant(0, 0);
+		const ConstMatrixView A12 = A.quadrant(0, 1);
+		const ConstMatrixView A21 = A.quadrant(1, 0);
+		const ConstMatrixView A22 = A.quadrant(1, 1);
+
+		const ConstMatrixView B11 = B.quadrant(0, 0);
+		const ConstMatrixView B12 = B.quadrant(0, 1);
+		const ConstMatrixView B21 = B.quadrant(1, 0);
+		const ConstMatrixView B22 = B.quadrant(1, 1);
+
+		const MatrixView C11 = C.quadrant(0, 0);
+		const MatrixView C12 = C.quadrant(0, 1);
+		const MatrixView C21 = C.quadrant(1, 0);
+		const MatrixView C22 = C.quadrant(1, 1);
 
 		// M1 = (A11 + A22) * (B11 + B22)
-		Matrix M1(newN, InnerArray(newN));
-		Matrix tmp1M1(newN, InnerArray(newN));
-		Matrix tmp2M1(newN, InnerArray(newN));
-		matrixAddSeq(tmp1M1, A11, A22, newN);
-		matrixAddSeq(tmp2M1, B11, B22, newN);
+		const MatrixView M1 = frame.matrix(newN, C.tile);
+		const MatrixView tmp1M1 = frame.matrix(newN, C.tile);
+		const MatrixView tmp2M1 = frame.matrix(newN, C.tile);
+		matrixAddPar(tmp1M1, A11, A22, newN);
+		matrixAddPar(tmp2M1, B11, B22, newN);
 		set_ref_count(8);
 		spawn(*new (allocate_child()) Strassen(M1, tmp1M1, tmp2M1, newN));
 
 		// M2 = (A21 + A22) * B11
-		Matrix M2(newN, InnerArray(newN));
-		Matrix tmp1M2(newN, InnerArray(newN));
-		matrixAddSeq(tmp1M2, A21, A22, newN);
+		const MatrixView M2 = frame.matrix(newN, C.tile);
+		const MatrixView tmp1M2 = frame.matrix(newN, C.tile);
+		matrixAddPar(tmp1M2, A21, A22, newN);
 		spawn(*new (allocate_child()) Strassen(M2, tmp1M2, B11, newN));
 
 		// M3 = A11 * (B12 - B22)
-		Matrix M3(newN, InnerArray(newN));
-		Matrix tmp1M3(newN, InnerArray(newN));
-		matrixSubSeq(tmp1M3, B12, B22, newN);
+		const MatrixView M3 = frame.matrix(newN, C.tile);
+		const MatrixView tmp1M3 = frame.matrix(newN, C.tile);
+		matrixSubPar(tmp1M3, B12, B22, newN);
 		spawn(*new (allocate_child()) Strassen(M3, A11, tmp1M3, newN));
 
 		// M4 = A22 * (B21 - B11)
-		Matrix M4(newN, InnerArray(newN));
-		Matrix tmp1M4(newN, InnerArray(newN));
-		matrixSubSeq(tmp1M4, B21, B11, newN);
+		const MatrixView M4 = frame.matrix(newN, C.tile);
+		const MatrixView tmp1M4 = frame.matrix(newN, C.tile);
+		matrixSubPar(tmp1M4, B21, B11, newN);
 		spawn(*new (allocate_child()) Strassen(M4, A22, tmp1M4, newN));
 
 		// M5 = (A11 + A12) * B22
-		Matrix M5(newN, InnerArray(newN));
-		Matrix tmp1M5(newN, InnerArray(newN));
-		matrixAddSeq(tmp1M5, A11, A12, newN);
+		const MatrixView M5 = frame.matrix(newN, C.tile);
+		const MatrixView tmp1M5 = frame.matrix(newN, C.tile);
+		matrixAddPar(tmp1M5, A11, A12, newN);
 		spawn(*new (allocate_child()) Strassen(M5, tmp1M5, B22, newN));
 
 		// M6 = (A21 - A11) * (B11 + B12)
-		Matrix M6(newN, InnerArray(newN));
-		Matrix tmp1M6(newN, InnerArray(newN));
-		Matrix tmp2M6(newN, InnerArray(newN));
-		matrixSubSeq(tmp1M6, A21, A11, newN);
-		matrixAddSeq(tmp2M6, B11, B12, newN);
+		const MatrixView M6 = frame.matrix(newN, C.tile);
+		const MatrixView tmp1M6 = frame.matrix(newN, C.tile);
+		const MatrixView tmp2M6 = frame.matrix(newN, C.tile);
+		matrixSubPar(tmp1M6, A21, A11, newN);
+		matrixAddPar(tmp2M6, B11, B12, newN);
 		spawn(*new (allocate_child()) Strassen(M6, tmp1M6, tmp2M6, newN));
 
 		// M7 = (A12 - A22) * (B21 + B22)
-		Matrix M7(newN, InnerArray(newN));
-		Matrix tmp1M7(newN, InnerArray(newN));
-		Matrix tmp2M7(newN, InnerArray(newN));
-		matrixSubSeq(tmp1M7, A12, A22, newN);
-		matrixAddSeq(tmp2M7, B21, B22, newN);
+		const MatrixView M7 = frame.matrix(newN, C.tile);
+		const MatrixView tmp1M7 = frame.matrix(newN, C.tile);
+		const MatrixView tmp2M7 = frame.matrix(newN, C.tile);
+		matrixSubPar(tmp1M7, A12, A22, newN);
+		matrixAddPar(tmp2M7, B21, B22, newN);
 		spawn_and_wait_for_all(*new (allocate_child()) Strassen(M7, tmp1M7, tmp2M7, newN));
 
-		for (M_SIZE_TYPE i = 0; i < newN; ++i) {
-			M_SIZE_TYPE iPlusNewN = i + newN;
-			for (M_SIZE_TYPE j = 0; j < newN; ++j) {
-				C[i][j] 				= M1[i][j] + M4[i][j] - M5[i][j] + M7[i][j];
-				C[i][j + newN]        	= M3[i][j] + M5[i][j];
-				C[iPlusNewN][j]       	= M2[i][j] + M4[i][j];
-				C[iPlusNewN][j + newN] 	= M1[i][j] - M2[i][j] + M3[i][j] + M6[i][j];
-			}
-		}
+		matrixCombinePar(StrassenCombinePBody(C11, C12, C21, C22, M1, M2, M3, M4, M5, M6, M7), newN, newN, 11, 8);
 	}
 	return NULL;
 }
@@ -223,75 +410,66 @@ tbb::task* Strassen::execute() {
 *  @param  n  Matrixdimension (NxN).
 */
 #if USE_PARTITIONS
-void strassenRecursive(Matrix& C, const Matrix& A, const Matrix& B, const M_SIZE_TYPE& n) {
+void strassenRecursive(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
 	if (n <= CUT_OFF) {
-		matrixMultSeq(C, A, B, n);
+		strassenLeaf(C, A, B, n);
 	}
 	else {
 		const M_SIZE_TYPE newN = n >> 1;
-		// Devide & Conquer
-		Matrix A11(newN, InnerArray(newN));
-		Matrix A12(newN, InnerArray(newN));
-		Matrix A21(newN, InnerArray(newN));
-		Matrix A22(newN, InnerArray(newN));
-
-		Matrix B11(newN, InnerArray(newN));
-		Matrix B12(newN, InnerArray(newN));
-		Matrix B21(newN, InnerArray(newN));
-		Matrix B22(newN, InnerArray(newN));
-
-		for (M_SIZE_TYPE i = 0; i < newN; ++i) {
-			M_SIZE_TYPE iPlusNewN = i + newN;
-			for (M_SIZE_TYPE j = 0; j < newN; ++j) {
-				A11[i][j] = A[i][j];
-				A12[i][j] = A[i][j + newN];
-				A21[i][j] = A[iPlusNewN][j];
-				A22[i][j] = A[iPlusNewN][j + newN];
-
-				B11[i][j] = B[i][j];
-				B12[i][j] = B[i][j + newN];
-				B21[i][j] = B[iPlusNewN][j];
-				B22[i][j] = B[iPlusNewN][j + newN];
-			}
-		}
+		WorkspaceFrame frame;
+		// Devide & Conquer (Quadranten als Sichten, ohne Kopie)
+		const ConstMatrixView A11 = A.quadrant(0, 0);
+		const ConstMatrixView A12 = A.quadrant(0, 1);
+		const ConstMatrixView A21 = A.quadrant(1, 0);
+		const ConstMatrixView A22 = A.quadrant(1, 1);
+
+		const ConstMatrixView B11 = B.quadrant(0, 0);
+		const ConstMatrixView B12 = B.quadrant(0, 1);
+		const ConstMatrixView B21 = B.quadrant(1, 0);
+		const ConstMatrixView B22 = B.quadrant(1, 1);
+
+		const MatrixView C11 = C.quadrant(0, 0);
+		const MatrixView C12 = C.quadrant(0, 1);
+		const MatrixView C21 = C.quadrant(1, 0);
+		const MatrixView C22 = C.quadrant(1, 1);
 
 
 		// M2 = (A21 + A22) * B11
-		Matrix tmp1(newN, InnerArray(newN));
-		Matrix M2(newN, InnerArray(newN));
+		const MatrixView tmp1 = frame.matrix(newN, C.tile);
+		const MatrixView M2 = frame.matrix(newN, C.tile);
 		matrixAddSeq(tmp1, A21, A22, newN);
 		strassenRecursive(M2, tmp1, B11, newN);
 
 		// M3 = A11 * (B12 - B22)
-		Matrix M3(newN, InnerArray(newN));
+		const MatrixView M3 = frame.matrix(newN, C.tile);
 		matrixSubSeq(tmp1, B12, B22, newN);
 		strassenRecursive(M3, A11, tmp1, newN);
 
 		// M4 = A22 * (B21 - B11)
-		Matrix M4(newN, InnerArray(newN));
+		const MatrixView M4 = frame.matrix(newN, C.tile);
 		matrixSubSeq(tmp1, B21, B11, newN);
 		strassenRecursive(M4, A22, tmp1, newN);
 
 		// M5 = (A11 + A12) * B22
-		Matrix M5(newN, InnerArray(newN));
+		const MatrixView M5 = frame.matrix(newN, C.tile);
 		matrixAddSeq(tmp1, A11, A12, newN);
 		strassenRecursive(M5, tmp1, B22, newN);
 
-		for (M_SIZE_TYPE i = 0; i < newN; ++i) {
-			M_SIZE_TYPE iPlusNewN = i + newN;
-			for (M_SIZE_TYPE j = 0; j < newN; ++j) {
-				C[i][j] 				= M4[i][j] - M5[i][j];
-				C[i][j + newN] 			= M3[i][j] + M5[i][j];
-				C[iPlusNewN][j] 		= M2[i][j] + M4[i][j];
-				C[iPlusNewN][j + newN] 	= M3[i][j] - M2[i][j];
-
-				M2[i][j] = M3[i][j] = M4[i][j] = M5[i][j] = 0;
+		{
+			TRACE_SCOPE(TRACE_COMBINE, newN, 8.0 * newN * newN * sizeof(M_VAL_TYPE), 4.0 * newN * newN);
+			for (M_SIZE_TYPE i = 0; i < newN; ++i) {
+				for (M_SIZE_TYPE j = 0; j < newN; ++j) {
+					C11[i][j] 	= M4[i][j] - M5[i][j];
+					C12[i][j] 	= M3[i][j] + M5[i][j];
+					C21[i][j] 	= M2[i][j] + M4[i][j];
+					C22[i][j] 	= M3[i][j] - M2[i][j];
+				}
 			}
 		}
 
 
 		// M1 = (A11 + A22) * (B11 + B22)
-		Matrix tmp2(newN, InnerArray(newN));
+		const MatrixView tmp2 = frame.matrix(newN, C.tile);
 		matrixAddSeq(tmp1, A11, A22, newN);
 		matrixAddSeq(tmp2, B11, B22, newN);
 		strassenRecursive(M2, tmp1, tmp2, newN);
@@ -306,98 +484,95 @@ void strassenRecursive(Matrix& C, const Matrix& A, const Matrix& B, const M_SIZE
 		matrixAddSeq(tmp2, B21, B22, newN);
 		strassenRecursive(M4, tmp1, tmp2, newN);
 
-		for (M_SIZE_TYPE i = 0; i < newN; ++i) {
-			M_SIZE_TYPE iPlusNewN = i + newN;
-			for (M_SIZE_TYPE j = 0; j < newN; ++j) {
-				C[i][j] 				+= M2[i][j] + M4[i][j];
-				C[iPlusNewN][j + newN] 	+= M2[i][j] + M3[i][j];
+		{
+			TRACE_SCOPE(TRACE_COMBINE, newN, 7.0 * newN * newN * sizeof(M_VAL_TYPE), 4.0 * newN * newN);
+			for (M_SIZE_TYPE i = 0; i < newN; ++i) {
+				for (M_SIZE_TYPE j = 0; j < newN; ++j) {
+					C11[i][j] 	+= M2[i][j] + M4[i][j];
+					C22[i][j] 	+= M2[i][j] + M3[i][j];
+				}
 			}
 		}
 	}
 }
 #else
-void strassenRecursive(Matrix& C, const Matrix& A, const Matrix& B, const M_SIZE_TYPE& n) {
+void strassenRecursive(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
 	if (n <= CUT_OFF) {
-		matrixMultSeq(C, A, B, n);
+		strassenLeaf(C, A, B, n);
 	}
 	else {
 		const M_SIZE_TYPE newN = n >> 1;
-		// Devide & Conquer
-		Matrix A11(newN, InnerArray(newN));
-		Matrix A12(newN, InnerArray(newN));
-		Matrix A21(newN, InnerArray(newN));
-		Matrix A22(newN, InnerArray(newN));
-
-		Matrix B11(newN, InnerArray(newN));
-		Matrix B12(newN, InnerArray(newN));
-		Matrix B21(newN, InnerArray(newN));
-		Matrix B22(newN, InnerArray(newN));
-
-		for (M_SIZE_TYPE i = 0; i < newN; ++i) {
-			M_SIZE_TYPE iPlusNewN = i + newN;
-			for (M_SIZE_TYPE j = 0; j < newN; ++j) {
-				A11[i][j] = A[i][j];
-				A12[i][j] = A[i][j + newN];
-				A21[i][j] = A[iPlusNewN][j];
-				A22[i][j] = A[iPlusNewN][j + newN];
-
-				B11[i][j] = B[i][j];
-				B12[i][j] = B[i][j + newN];
-				B21[i][j] = B[iPlusNewN][j];
-				B22[i][j] = B[iPlusNewN][j + newN];
-			}
-		}
+		WorkspaceFrame frame;
+		// Devide & Conquer (Quadranten als Sichten, ohne Kopie)
+		const ConstMatrixView A11 = A.quadrant(0, 0);
+		const ConstMatrixView A12 = A.quadrant(0, 1);
+		const ConstMatrixView A21 = A.quadrant(1, 0);
+		const ConstMatrixView A22 = A.quadrant(1, 1);
+
+		const ConstMatrixView B11 = B.quadrant(0, 0);
+		const ConstMatrixView B12 = B.quadrant(0, 1);
+		const ConstMatrixView B21 = B.quadrant(1, 0);
+		const ConstMatrixView B22 = B.quadrant(1, 1);
+
+		const MatrixView C11 = C.quadrant(0, 0);
+		const MatrixView C12 = C.quadrant(0, 1);
+		const MatrixView C21 = C.quadrant(1, 0);
+		const MatrixView C22 = C.quadrant(1, 1);
 
 
 		// M1 = (A11 + A22) * (B11 + B22)
-		Matrix M1(newN, InnerArray(newN));
-		Matrix tmp1(newN, InnerArray(newN));
-		Matrix tmp2(newN, InnerArray(newN));
+		const MatrixView M1 = frame.matrix(newN, C.tile);
+		const MatrixView tmp1 = frame.matrix(newN, C.tile);
+		const MatrixView tmp2 = frame.matrix(newN, C.tile);
 		matrixAddSeq(tmp1, A11, A22, newN);
 		matrixAddSeq(tmp2, B11, B22, newN);
-		strassenRecursive(M1, tmp2, tmp1, newN);
+		strassenRecursive(M1, tmp1, tmp2, newN);
 
 		// M2 = (A21 + A22) * B11
-		Matrix M2(newN, InnerArray(newN));
+		const MatrixView M2 = frame.matrix(newN, C.tile);
 		matrixAddSeq(tmp1, A21, A22, newN);
 		strassenRecursive(M2, tmp1, B11, newN);
 
 		// M3 = A11 * (B12 - B22)
-		Matrix M3(newN, InnerArray(newN));
+		const MatrixView M3 = frame.matrix(newN, C.tile);
 		matrixSubSeq(tmp1, B12, B22, newN);
 		strassenRecursive(M3, A11, tmp1, newN);
 
 		// M4 = A22 * (B21 - B11)
-		Matrix M4(newN, InnerArray(newN));
+		const MatrixView M4 = frame.matrix(newN, C.tile);
 		matrixSubSeq(tmp1, B21, B11, newN);
 		strassenRecursive(M4, A22, tmp1, newN);
 
 		// M5 = (A11 + A12) * B22
-		Matrix M5(newN, InnerArray(newN));
+		const MatrixView M5 = frame.matrix(newN, C.tile);
 		matrixAddSeq(tmp1, A11, A12, newN);
 		strassenRecursive(M5, tmp1, B22, newN);
 
 		// M6 = (A21 - A11) * (B11 + B12)
-		Matrix M6(newN, InnerArray(newN));
+		const MatrixView M6 = frame.matrix(newN, C.tile);
 		matrixSubSeq(tmp1, A21, A11, newN);
 		matrixAddSeq(tmp2, B11, B12, newN);
 		strassenRecursive(M6, tmp1, tmp2, newN);
 
 		// M7 = (A12 - A22) * (B21 + B22)
-		Matrix M7(newN, InnerArray(newN));
+		const MatrixView M7 = frame.matrix(newN, C.tile);
 		matrixSubSeq(tmp1, A12, A22, newN);
 		matrixAddSeq(tmp2, B21, B22, newN);
 		strassenRecursive(M7, tmp1, tmp2, newN);
 
-		for (M_SIZE_TYPE i = 0; i < newN; ++i) {
-			M_SIZE_TYPE iPlusNewN = i + newN;
-			for (M_SIZE_TYPE j = 0; j < newN; ++j) {
-				C[i][j] 				= M1[i][j] + M4[i][j] - M5[i][j] + M7[i][j];
-				C[i][j + newN]        	= M3[i][j] + M5[i][j];
-				C[iPlusNewN][j]       	= M2[i][j] + M4[i][j];
-				C[iPlusNewN][j + newN] 	= M1[i][j] - M2[i][j] + M3[i][j] + M6[i][j];
+		{
+			TRACE_SCOPE(TRACE_COMBINE, newN, 11.0 * newN * newN * sizeof(M_VAL_TYPE), 8.0 * newN * newN);
+			for (M_SIZE_TYPE i = 0; i < newN; ++i) {
+				for (M_SIZE_TYPE j = 0; j < newN; ++j) {
+					C11[i][j] 	= M1[i][j] + M4[i][j] - M5[i][j] + M7[i][j];
+					C12[i][j] 	= M3[i][j] + M5[i][j];
+					C21[i][j] 	= M2[i][j] + M4[i][j];
+					C22[i][j] 	= M1[i][j] - M2[i][j] + M3[i][j] + M6[i][j];
+				}
 			}
 		}
 	}
 }
 #endif
+
+} // namespace M_VAL_NAMESPACE
@@ -14,22 +14,82 @@
 #include "Definitions.h"
 #include "Matrix.h"
 
+namespace M_VAL_NAMESPACE {
+
+// Zwischenmatrizen (n/2 x n/2) je Rekursionsebene, siehe Implementierungen in Strassen.cpp
+#ifdef USE_PARTITIONS
+#define TASK_TEMPORARIES 9				// M2..M5, tmp1M2..tmp1M5, tmp2M4
+#else
+#define TASK_TEMPORARIES 17				// M1..M7 und zehn Operanden
+#endif
+#if USE_PARTITIONS
+#define SEQ_TEMPORARIES 6				// M2..M5, tmp1, tmp2
+#else
+#define SEQ_TEMPORARIES 9				// M1..M7, tmp1, tmp2
+#endif
+#define TASK_WORKSPACE_SLACK 2			// Reserve fuer verschachtelt gestohlene Tasks
+#define STRASSEN_PRODUCTS 7				// Produkte je Ebene (M1..M7)
+
+extern const int STRASSEN_LEFT[STRASSEN_PRODUCTS][4];	// Koeffizienten von A11, A12, A21, A22 je Produkt M1..M7
+extern const int STRASSEN_RIGHT[STRASSEN_PRODUCTS][4];	// Koeffizienten von B11, B12, B21, B22 je Produkt
+extern const int STRASSEN_SIGNS[4][STRASSEN_PRODUCTS];	// Vorzeichen der Produkte je Quadrant C11, C12, C21, C22
+
 /**
 *  @brief  Repraesentiert eine Klasse, welche Matrixmultiplikationen
 *  mihilfe des Strassen-Algorithmusses loest.
 */
 class Strassen : public tbb::task {
-	Matrix& C;
-	const Matrix& A;
-	const Matrix& B;
-	const M_SIZE_TYPE& n;
+	MatrixView C;
+	ConstMatrixView A;
+	ConstMatrixView B;
+	const M_SIZE_TYPE n;
 
 public:
-	Strassen(Matrix& __C, const Matrix& __A, const Matrix& __B, const M_SIZE_TYPE& __n) : C(__C), A(__A), B(__B), n(__n) { }
+	Strassen(const MatrixView& __C, const ConstMatrixView& __A, const ConstMatrixView& __B, const M_SIZE_TYPE& __n) : C(__C), A(__A), B(__B), n(__n) { }
 
 	tbb::task* execute();
 };
 
-void strassenRecursive(Matrix& C, const Matrix& A, const Matrix& B, const M_SIZE_TYPE& n);
+/**
+*  @brief  Funktionsobjekt zum (parallelisierten) Zusammensetzen von C aus
+*  den sieben Produkten M1..M7.
+*/
+struct StrassenCombinePBody {
+	MatrixView C11, C12, C21, C22;
+	ConstMatrixView M1, M2, M3, M4, M5, M6, M7;
+
+	StrassenCombinePBody(const MatrixView& __C11, const MatrixView& __C12, const MatrixView& __C21, const MatrixView& __C22,
+			const ConstMatrixView& __M1, const ConstMatrixView& __M2, const ConstMatrixView& __M3, const ConstMatrixView& __M4,
+			const ConstMatrixView& __M5, const ConstMatrixView& __M6, const ConstMatrixView& __M7) :
+			C11(__C11), C12(__C12), C21(__C21), C22(__C22), M1(__M1), M2(__M2), M3(__M3), M4(__M4), M5(__M5), M6(__M6), M7(__M7) {
+	}
+
+	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
+		for (M_SIZE_TYPE i = range.rows().begin(); i != range.rows().end(); ++i) {
+			for (M_SIZE_TYPE j = range.cols().begin(); j != range.cols().end(); ++j) {
+				C11[i][j] 	= M1[i][j] + M4[i][j] - M5[i][j] + M7[i][j];
+				C12[i][j] 	= M3[i][j] + M5[i][j];
+				C21[i][j] 	= M2[i][j] + M4[i][j];
+				C22[i][j] 	= M1[i][j] - M2[i][j] + M3[i][j] + M6[i][j];
+			}
+		}
+	}
+};
+
+M_SIZE_TYPE variantWorkspaceElements(const M_SIZE_TYPE& n, const M_SIZE_TYPE& seqTemporaries, const M_SIZE_TYPE& taskTemporaries);
+
+M_SIZE_TYPE strassenWorkspaceElements(const M_SIZE_TYPE& n);
+
+const char* strassenVariantName(const int variant);
+
+void strassenLeaf(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n);
+
+void strassenRecursive(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n);
+
+void strassenMultiplySeq(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n);
+
+void strassenMultiplyPar(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n);
+
+} // namespace M_VAL_NAMESPACE
 
 #endif
@@ -0,0 +1,324 @@
+//============================================================================
+// Name        : StrassenRect.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "StrassenRect.h"
+#include "Gemm.h"
+#include "Strassen.h"
+#include "Workspace.h"
+
+namespace M_VAL_NAMESPACE {
+
+#define RECT_TASK_PRODUCTS 7			// M1..M7
+#define RECT_TASK_OPERANDS 5			// je fuenf Operanden aus A bzw. B
+#define RECT_WORKSPACE_SLACK 2			// Reserve fuer verschachtelt gestohlene Tasks
+
+/**
+*  @brief  Prueft, ob sich n bis zum Cut-Off ohne Rest halbieren laesst, d. h.
+*  ob die quadratischen Varianten ohne Abschaelen auskommen.
+*  @param  n  Matrixdimension (NxN).
+*  @return true, falls jede Ebene oberhalb von CUT_OFF gerade ist.
+*/
+bool isStrassenDivisible(const M_SIZE_TYPE& n) {
+	for (M_SIZE_TYPE size = n; size > CUT_OFF; size >>= 1) {
+		if (size & 1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+*  @brief  Groesste Dimension eines Teilproblems (Rekursionstiefe der Messung).
+*/
+static inline M_SIZE_TYPE rectSize(const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	const M_SIZE_TYPE mn = m > n ? m : n;
+	return mn > k ? mn : k;
+}
+
+/**
+*  @brief  Blatt der rechteckigen Rekursion: C = A * B per gekachelter GEMM.
+*/
+static inline void strassenRectLeaf(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	TRACE_SCOPE(TRACE_LEAF, rectSize(m, n, k), ((double) m * k + (double) k * n + (double) m * n) * sizeof(M_VAL_TYPE), 2.0 * m * n * k);
+	gemmSeq(C, A, B, m, n, k);
+}
+
+/**
+*  @brief  Berechnet die Groesse des Workspaces je Thread fuer die
+*  rechteckige Variante (sequentiell bzw. mit Tasks; grosse Zwischenmatrizen
+*  liegen auf dem Heap, siehe workspaceShare).
+*  @param  m  Zeilen von A und C.
+*  @param  n  Spalten von B und C.
+*  @param  k  Spalten von A bzw. Zeilen von B.
+*  @return Benoetigte Elemente je Thread.
+*/
+M_SIZE_TYPE strassenRectWorkspaceElements(const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	M_SIZE_TYPE seq = 0;
+	M_SIZE_TYPE task = 0;
+	for (M_SIZE_TYPE mi = m, ni = n, ki = k; mi > CUT_OFF && ni > CUT_OFF && ki > CUT_OFF; mi >>= 1, ni >>= 1, ki >>= 1) {
+		const M_SIZE_TYPE mh = mi >> 1;
+		const M_SIZE_TYPE nh = ni >> 1;
+		const M_SIZE_TYPE kh = ki >> 1;
+		const M_SIZE_TYPE a = workspaceShare(mh * kh);
+		const M_SIZE_TYPE b = workspaceShare(kh * nh);
+		const M_SIZE_TYPE c = workspaceShare(mh * nh);
+		seq += a + b + c;	// Operand aus A, Operand aus B, Produkt
+		task += RECT_TASK_PRODUCTS * c + RECT_TASK_OPERANDS * (a + b);
+	}
+	task *= RECT_WORKSPACE_SLACK;
+	return (seq > task ? seq : task) + RECT_WORKSPACE_SLACK * gemmPackElements(m, n, k);
+}
+
+/**
+*  @brief  Schaelt die ungeraden Raender ab, nachdem der gerade Anteil
+*  C[0:m2][0:n2] = A[0:m2][0:k2] * B[0:k2][0:n2] berechnet wurde:
+*  letzte Spalte von A mal letzte Zeile von B (k ungerade), letzte Spalte
+*  von C (n ungerade) und letzte Zeile von C (m ungerade).
+*  @param  C  Matrix C (m x n).
+*  @param  A  Matrix A (m x k).
+*  @param  B  Matrix B (k x n).
+*  @param  m  Zeilen von A und C.
+*  @param  n  Spalten von B und C.
+*  @param  k  Spalten von A bzw. Zeilen von B.
+*/
+static void strassenRectPeel(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	const M_SIZE_TYPE m2 = m & ~(M_SIZE_TYPE) 1;
+	const M_SIZE_TYPE n2 = n & ~(M_SIZE_TYPE) 1;
+	const M_SIZE_TYPE k2 = k & ~(M_SIZE_TYPE) 1;
+	// Rang-1-Update: C[0:m2][0:n2] += A[0:m2][k2] * B[k2][0:n2]
+	if (k != k2) {
+		for (M_SIZE_TYPE i = 0; i < m2; ++i) {
+			const M_VAL_TYPE a = A[i][k2];
+			for (M_SIZE_TYPE j = 0; j < n2; ++j) {
+				C[i][j] += a * B[k2][j];
+			}
+		}
+	}
+	// Letzte Spalte: C[0:m][n2] = A * B[0:k][n2]
+	if (n != n2) {
+		for (M_SIZE_TYPE i = 0; i < m; ++i) {
+			M_VAL_TYPE sum = 0;
+			for (M_SIZE_TYPE p = 0; p < k; ++p) {
+				sum += A[i][p] * B[p][n2];
+			}
+			C[i][n2] = sum;
+		}
+	}
+	// Letzte Zeile: C[m2][0:n2] = A[m2][0:k] * B[0:k][0:n2]
+	if (m != m2) {
+		for (M_SIZE_TYPE j = 0; j < n2; ++j) {
+			C[m2][j] = 0;
+		}
+		for (M_SIZE_TYPE p = 0; p < k; ++p) {
+			const M_VAL_TYPE a = A[m2][p];
+			for (M_SIZE_TYPE j = 0; j < n2; ++j) {
+				C[m2][j] += a * B[p][j];
+			}
+		}
+	}
+}
+
+/**
+*  @brief  Vererbte und ueberschriebene Methode der tbb::task-Klasse. Die
+*  sieben Produkte des geraden Anteils werden als Tasks gestartet, die
+*  ungeraden Raender anschliessend abgeschaelt.
+*  @return tbb::task.
+*/
+tbb::task* StrassenRect::execute() {
+	TRACE_TASK_START(rectSize(m, n, k), is_stolen_task());
+	TRACE_SCOPE(TRACE_TASK, rectSize(m, n, k), 0, 0);
+	if (m <= CUT_OFF || n <= CUT_OFF || k <= CUT_OFF) {
+		strassenRectLeaf(C, A, B, m, n, k);
+		return NULL;
+	}
+	if (m <= CUT_OFF_TASK || n <= CUT_OFF_TASK || k <= CUT_OFF_TASK) {
+		strassenRectRecursive(C, A, B, m, n, k);
+		return NULL;
+	}
+	const M_SIZE_TYPE mh = m >> 1;
+	const M_SIZE_TYPE nh = n >> 1;
+	const M_SIZE_TYPE kh = k >> 1;
+	WorkspaceFrame frame;
+	// Devide & Conquer (Bloecke als Sichten, ohne Kopie)
+	const ConstMatrixView A11 = A.block(0, 0);
+	const ConstMatrixView A12 = A.block(0, kh);
+	const ConstMatrixView A21 = A.block(mh, 0);
+	const ConstMatrixView A22 = A.block(mh, kh);
+
+	const ConstMatrixView B11 = B.block(0, 0);
+	const ConstMatrixView B12 = B.block(0, nh);
+	const ConstMatrixView B21 = B.block(kh, 0);
+	const ConstMatrixView B22 = B.block(kh, nh);
+
+	const MatrixView C11 = C.block(0, 0);
+	const MatrixView C12 = C.block(0, nh);
+	const MatrixView C21 = C.block(mh, 0);
+	const MatrixView C22 = C.block(mh, nh);
+
+	// M1 = (A11 + A22) * (B11 + B22)
+	const MatrixView M1 = frame.rect(mh, nh);
+	const MatrixView tmp1M1 = frame.rect(mh, kh);
+	const MatrixView tmp2M1 = frame.rect(kh, nh);
+	matrixAddPar(tmp1M1, A11, A22, mh, kh);
+	matrixAddPar(tmp2M1, B11, B22, kh, nh);
+	set_ref_count(8);
+	spawn(*new (allocate_child()) StrassenRect(M1, tmp1M1, tmp2M1, mh, nh, kh));
+
+	// M2 = (A21 + A22) * B11
+	const MatrixView M2 = frame.rect(mh, nh);
+	const MatrixView tmp1M2 = frame.rect(mh, kh);
+	matrixAddPar(tmp1M2, A21, A22, mh, kh);
+	spawn(*new (allocate_child()) StrassenRect(M2, tmp1M2, B11, mh, nh, kh));
+
+	// M3 = A11 * (B12 - B22)
+	const MatrixView M3 = frame.rect(mh, nh);
+	const MatrixView tmp1M3 = frame.rect(kh, nh);
+	matrixSubPar(tmp1M3, B12, B22, kh, nh);
+	spawn(*new (allocate_child()) StrassenRect(M3, A11, tmp1M3, mh, nh, kh));
+
+	// M4 = A22 * (B21 - B11)
+	const MatrixView M4 = frame.rect(mh, nh);
+	const MatrixView tmp1M4 = frame.rect(kh, nh);
+	matrixSubPar(tmp1M4, B21, B11, kh, nh);
+	spawn(*new (allocate_child()) StrassenRect(M4, A22, tmp1M4, mh, nh, kh));
+
+	// M5 = (A11 + A12) * B22
+	const MatrixView M5 = frame.rect(mh, nh);
+	const MatrixView tmp1M5 = frame.rect(mh, kh);
+	matrixAddPar(tmp1M5, A11, A12, mh, kh);
+	spawn(*new (allocate_child()) StrassenRect(M5, tmp1M5, B22, mh, nh, kh));
+
+	// M6 = (A21 - A11) * (B11 + B12)
+	const MatrixView M6 = frame.rect(mh, nh);
+	const MatrixView tmp1M6 = frame.rect(mh, kh);
+	const MatrixView tmp2M6 = frame.rect(kh, nh);
+	matrixSubPar(tmp1M6, A21, A11, mh, kh);
+	matrixAddPar(tmp2M6, B11, B12, kh, nh);
+	spawn(*new (allocate_child()) StrassenRect(M6, tmp1M6, tmp2M6, mh, nh, kh));
+
+	// M7 = (A12 - A22) * (B21 + B22)
+	const MatrixView M7 = frame.rect(mh, nh);
+	const MatrixView tmp1M7 = frame.rect(mh, kh);
+	const MatrixView tmp2M7 = frame.rect(kh, nh);
+	matrixSubPar(tmp1M7, A12, A22, mh, kh);
+	matrixAddPar(tmp2M7, B21, B22, kh, nh);
+	spawn_and_wait_for_all(*new (allocate_child()) StrassenRect(M7, tmp1M7, tmp2M7, mh, nh, kh));
+
+	matrixCombinePar(StrassenCombinePBody(C11, C12, C21, C22, M1, M2, M3, M4, M5, M6, M7), mh, nh, 11, 8);
+
+	strassenRectPeel(C, A, B, m, n, k);
+	return NULL;
+}
+
+/**
+*  @brief  Rekursive Methode, welche zwei Matrizen beliebiger Groesse nach
+*  dem Strassen-Algorithmus errechnet. Die Produkte werden direkt in die
+*  Bloecke von C geschrieben, sodass je Ebene nur drei Zwischenmatrizen
+*  benoetigt werden.
+*  @param  C  Matrix C (Ergebnismatrix, m x n).
+*  @param  A  Matrix A (m x k).
+*  @param  B  Matrix B (k x n).
+*  @param  m  Zeilen von A und C.
+*  @param  n  Spalten von B und C.
+*  @param  k  Spalten von A bzw. Zeilen von B.
+*/
+void strassenRectRecursive(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	if (m <= CUT_OFF || n <= CUT_OFF || k <= CUT_OFF) {
+		strassenRectLeaf(C, A, B, m, n, k);
+		return;
+	}
+	const M_SIZE_TYPE mh = m >> 1;
+	const M_SIZE_TYPE nh = n >> 1;
+	const M_SIZE_TYPE kh = k >> 1;
+	WorkspaceFrame frame;
+	// Devide & Conquer (Bloecke als Sichten, ohne Kopie)
+	const ConstMatrixView A11 = A.block(0, 0);
+	const ConstMatrixView A12 = A.block(0, kh);
+	const ConstMatrixView A21 = A.block(mh, 0);
+	const ConstMatrixView A22 = A.block(mh, kh);
+
+	const ConstMatrixView B11 = B.block(0, 0);
+	const ConstMatrixView B12 = B.block(0, nh);
+	const ConstMatrixView B21 = B.block(kh, 0);
+	const ConstMatrixView B22 = B.block(kh, nh);
+
+	const MatrixView C11 = C.block(0, 0);
+	const MatrixView C12 = C.block(0, nh);
+	const MatrixView C21 = C.block(mh, 0);
+	const MatrixView C22 = C.block(mh, nh);
+
+	const MatrixView tmp1 = frame.rect(mh, kh);
+	const MatrixView tmp2 = frame.rect(kh, nh);
+	const MatrixView M = frame.rect(mh, nh);
+
+	// M1 = (A11 + A22) * (B11 + B22) -> C11, C22
+	matrixAddSeq(tmp1, A11, A22, mh, kh);
+	matrixAddSeq(tmp2, B11, B22, kh, nh);
+	strassenRectRecursive(C11, tmp1, tmp2, mh, nh, kh);
+	matrixCopySeq(C22, C11, mh, nh);
+
+	// M2 = (A21 + A22) * B11 -> C21, C22
+	matrixAddSeq(tmp1, A21, A22, mh, kh);
+	strassenRectRecursive(C21, tmp1, B11, mh, nh, kh);
+	matrixSubSeq(C22, C22, C21, mh, nh);
+
+	// M3 = A11 * (B12 - B22) -> C12, C22
+	matrixSubSeq(tmp2, B12, B22, kh, nh);
+	strassenRectRecursive(C12, A11, tmp2, mh, nh, kh);
+	matrixAddSeq(C22, C22, C12, mh, nh);
+
+	// M4 = A22 * (B21 - B11) -> C11, C21
+	matrixSubSeq(tmp2, B21, B11, kh, nh);
+	strassenRectRecursive(M, A22, tmp2, mh, nh, kh);
+	matrixAddSeq(C11, C11, M, mh, nh);
+	matrixAddSeq(C21, C21, M, mh, nh);
+
+	// M5 = (A11 + A12) * B22 -> C11, C12
+	matrixAddSeq(tmp1, A11, A12, mh, kh);
+	strassenRectRecursive(M, tmp1, B22, mh, nh, kh);
+	matrixSubSeq(C11, C11, M, mh, nh);
+	matrixAddSeq(C12, C12, M, mh, nh);
+
+	// M6 = (A21 - A11) * (B11 + B12) -> C22
+	matrixSubSeq(tmp1, A21, A11, mh, kh);
+	matrixAddSeq(tmp2, B11, B12, kh, nh);
+	strassenRectRecursive(M, tmp1, tmp2, mh, nh, kh);
+	matrixAddSeq(C22, C22, M, mh, nh);
+
+	// M7 = (A12 - A22) * (B21 + B22) -> C11
+	matrixSubSeq(tmp1, A12, A22, mh, kh);
+	matrixAddSeq(tmp2, B21, B22, kh, nh);
+	strassenRectRecursive(M, tmp1, tmp2, mh, nh, kh);
+	matrixAddSeq(C11, C11, M, mh, nh);
+
+	strassenRectPeel(C, A, B, m, n, k);
+}
+
+/**
+*  @brief  Multipliziert zwei Matrizen beliebiger Groesse mit Tasks. Flache
+*  Probleme (eine Dimension <= CUT_OFF, z. B. 10000 x 10000 x 32) haben keine
+*  Strassen-Ebene und waeren ein einziges sequentielles Blatt; sie rechnet
+*  direkt die parallele GEMM.
+*  @param  C  Matrix C (Ergebnismatrix, m x n).
+*  @param  A  Matrix A (m x k).
+*  @param  B  Matrix B (k x n).
+*  @param  m  Zeilen von A und C.
+*  @param  n  Spalten von B und C.
+*  @param  k  Spalten von A bzw. Zeilen von B.
+*/
+void strassenRectPar(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	if (m <= CUT_OFF || n <= CUT_OFF || k <= CUT_OFF) {
+		gemmPar(C, A, B, m, n, k);
+		return;
+	}
+	tbb::task::spawn_root_and_wait(*new (tbb::task::allocate_root()) StrassenRect(C, A, B, m, n, k));
+}
+
+} // namespace M_VAL_NAMESPACE
@@ -0,0 +1,51 @@
+//============================================================================
+// Name        : StrassenRect.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef STRASSENRECT_H_
+#define STRASSENRECT_H_
+
+#include "Definitions.h"
+#include "Matrix.h"
+
+namespace M_VAL_NAMESPACE {
+
+/**
+*  @brief  Repraesentiert eine Klasse, welche Matrixmultiplikationen
+*  beliebiger, auch rechteckiger Groesse (m x k mal k x n) mithilfe des
+*  Strassen-Algorithmusses in Tasks loest. Ungerade Dimensionen werden je
+*  Ebene abgeschaelt (Dynamic Peeling) statt aufgefuellt.
+*/
+class StrassenRect : public tbb::task {
+	MatrixView C;
+	ConstMatrixView A;
+	ConstMatrixView B;
+	const M_SIZE_TYPE m;
+	const M_SIZE_TYPE n;
+	const M_SIZE_TYPE k;
+
+public:
+	StrassenRect(const MatrixView& __C, const ConstMatrixView& __A, const ConstMatrixView& __B, const M_SIZE_TYPE& __m, const M_SIZE_TYPE& __n, const M_SIZE_TYPE& __k) :
+			C(__C), A(__A), B(__B), m(__m), n(__n), k(__k) {
+	}
+
+	tbb::task* execute();
+};
+
+bool isStrassenDivisible(const M_SIZE_TYPE& n);
+
+M_SIZE_TYPE strassenRectWorkspaceElements(const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k);
+
+void strassenRectRecursive(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k);
+
+void strassenRectPar(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k);
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
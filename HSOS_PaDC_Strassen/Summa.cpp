@@ -0,0 +1,108 @@
+//============================================================================
+// Name        : Summa.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Distributed.h"
+#include "Blas.h"
+#include <tbb/tick_count.h>
+
+namespace M_VAL_NAMESPACE {
+
+using tbb::tick_count;
+
+/**
+*  @brief  Broadcasts eines SUMMA-Schritts: A_is in Zeile i (Wurzel: Spalte
+*  s), B_sj in Spalte j (Wurzel: Zeile s). Die Wurzel sendet ihren eigenen
+*  Block ohne Kopie, alle anderen empfangen in die Puffer.
+*/
+struct SummaStep {
+	const M_VAL_TYPE* left;
+	const M_VAL_TYPE* right;
+	MPI_Request requests[2];
+
+	void post(const DistGrid& grid, const int s, const MatrixView& A, const MatrixView& B, M_VAL_TYPE* bufferA, M_VAL_TYPE* bufferB, const int count) {
+		M_VAL_TYPE* a = grid.col == s ? A.data : bufferA;
+		M_VAL_TYPE* b = grid.row == s ? B.data : bufferB;
+		MPI_Ibcast(a, count, M_VAL_MPI_TYPE, s, grid.rowComm, &requests[0]);
+		MPI_Ibcast(b, count, M_VAL_MPI_TYPE, s, grid.colComm, &requests[1]);
+		left = a;
+		right = b;
+	}
+};
+
+/**
+*  @brief  2.5D-SUMMA (siehe Distributed.h). Aufruf durch alle Prozesse.
+*  @param      C  Block C_ij (Ergebnis auf Ebene 0).
+*  @param      A  Block A_ij (Ebene 0: Eingabe, sonst Puffer der Replikation).
+*  @param      B  Block B_ij (wie A).
+*  @param      b  Dimension der Bloecke (n / q).
+*  @param  times  Ergebnis: Rechen- und Wartezeit dieses Prozesses.
+*/
+void summaMultiply(const DistGrid& grid, const MatrixView& C, const MatrixView& A, const MatrixView& B, const M_SIZE_TYPE& b, DistTimes& times) {
+	const int count = (int) (b * b);
+	tick_count t0 = tick_count::now(), t1;
+	times.compute = 0;
+	times.wait = 0;
+	if (grid.layers > 1) {
+		MPI_Bcast(A.data, count, M_VAL_MPI_TYPE, 0, grid.depthComm);
+		MPI_Bcast(B.data, count, M_VAL_MPI_TYPE, 0, grid.depthComm);
+	}
+
+	// Doppelte Puffer: Schritt t rechnet, Schritt t + 1 wird uebertragen
+	MatrixStorage left0(b * b), left1(b * b), right0(b * b), right1(b * b), product(b * b);
+	M_VAL_TYPE* bufferA[2] = { &left0[0], &left1[0] };
+	M_VAL_TYPE* bufferB[2] = { &right0[0], &right1[0] };
+	SummaStep steps[2];
+	const int stepsPerLayer = grid.q / grid.layers;
+	const int first = grid.layer * stepsPerLayer;
+	steps[0].post(grid, first, A, B, bufferA[0], bufferB[0], count);
+	t1 = tick_count::now();
+	times.wait += (t1 - t0).seconds();
+
+	for (int t = 0; t < stepsPerLayer; ++t) {
+		SummaStep& current = steps[t & 1];
+		SummaStep& next = steps[(t + 1) & 1];
+		t0 = tick_count::now();
+		MPI_Waitall(2, current.requests, MPI_STATUSES_IGNORE);
+		const bool more = t + 1 < stepsPerLayer;
+		if (more) {
+			next.post(grid, first + t + 1, A, B, bufferA[(t + 1) & 1], bufferB[(t + 1) & 1], count);
+		}
+		t1 = tick_count::now();
+		times.wait += (t1 - t0).seconds();
+
+		// C_ij += A_is * B_sj in Zeilenstreifen, dazwischen Fortschritt der Broadcasts
+		const M_SIZE_TYPE panels = more && b >= SUMMA_PANELS ? SUMMA_PANELS : 1;
+		for (M_SIZE_TYPE p = 0; p < panels; ++p) {
+			const M_SIZE_TYPE r0 = b * p / panels;
+			const M_SIZE_TYPE rows = b * (p + 1) / panels - r0;
+			M_VAL_TYPE* target = t == 0 ? C[r0] : &product[r0 * b];
+			gemm('N', 'N', rows, b, b, (M_VAL_TYPE) 1, current.left + r0 * b, b, current.right, b, (M_VAL_TYPE) 0, target, b);
+			if (t != 0) {
+				matrixAddPar(C.block(r0, 0), C.block(r0, 0), ConstMatrixView(target, b, 0), rows, b);
+			}
+			if (more) {
+				int done;
+				MPI_Testall(2, next.requests, &done, MPI_STATUSES_IGNORE);
+			}
+		}
+		t0 = tick_count::now();
+		times.compute += (t0 - t1).seconds();
+	}
+
+	// Teilsummen der Ebenen nach Ebene 0
+	if (grid.layers > 1) {
+		t0 = tick_count::now();
+		MPI_Reduce(grid.layer == 0 ? MPI_IN_PLACE : C.data, C.data, count, M_VAL_MPI_TYPE, MPI_SUM, 0, grid.depthComm);
+		t1 = tick_count::now();
+		times.wait += (t1 - t0).seconds();
+	}
+}
+
+} // namespace M_VAL_NAMESPACE
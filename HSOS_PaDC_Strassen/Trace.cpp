@@ -0,0 +1,174 @@
+//============================================================================
+// Name        : Trace.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Trace.h"
+#include <tbb/enumerable_thread_specific.h>
+#include <fstream>
+#include <sstream>
+#include <string.h>
+
+static const char* const TRACE_PHASE_NAMES[TRACE_PHASES] = { "add", "combine", "leaf", "task" };
+
+/**
+*  @brief  Zaehler einer Phase auf einer Ebene.
+*/
+struct TracePhase {
+	double calls;
+	double seconds;
+	double bytes;
+	double flops;
+};
+
+/**
+*  @brief  Zaehler eines Threads fuer alle Ebenen.
+*/
+struct TraceCounters {
+	TracePhase phase[TRACE_MAX_DEPTH][TRACE_PHASES];
+	double allocs[TRACE_MAX_DEPTH];
+	double allocBytes[TRACE_MAX_DEPTH];
+	double tasks[TRACE_MAX_DEPTH];
+	double steals[TRACE_MAX_DEPTH];
+
+	TraceCounters() {
+		memset(this, 0, sizeof(TraceCounters));
+	}
+};
+
+bool TRACE_ACTIVE = false;
+static M_SIZE_TYPE TRACE_ROOT = 0;		// Dimension der Wurzel (Tiefe 0)
+static std::ostringstream TRACE_RUNS;	// Bereits abgeschlossene Messungen (JSON-Objekte)
+static int TRACE_RUN_COUNT = 0;
+
+static tbb::enumerable_thread_specific<TraceCounters>& traceCounters() {
+	static tbb::enumerable_thread_specific<TraceCounters> ets;
+	return ets;
+}
+
+/**
+*  @brief  Rekursionstiefe einer Teilmatrix der Dimension n.
+*/
+static int traceDepth(const M_SIZE_TYPE& n) {
+	int depth = 0;
+	while (depth + 1 < TRACE_MAX_DEPTH && (TRACE_ROOT >> (depth + 1)) >= n) {
+		++depth;
+	}
+	return depth;
+}
+
+/**
+*  @brief  Startet eine Messung (nur mit -j): setzt alle Zaehler zurueck.
+*  @param  n  Dimension der Wurzel (bei Rechtecken die groesste).
+*/
+void traceBegin(const M_SIZE_TYPE& n) {
+	if (TRACE_PATH == NULL) {
+		return;
+	}
+	traceCounters().clear();
+	TRACE_ROOT = n;
+	TRACE_ACTIVE = true;
+}
+
+void traceRecord(const int phase, const M_SIZE_TYPE& n, const double seconds, const double bytes, const double flops) {
+	TracePhase& counter = traceCounters().local().phase[traceDepth(n)][phase];
+	counter.calls += 1;
+	counter.seconds += seconds;
+	counter.bytes += bytes;
+	counter.flops += flops;
+}
+
+/**
+*  @brief  Verbucht eine Zwischenmatrix der Dimension n (belegt von der Ebene
+*  darueber).
+*/
+void traceAlloc(const M_SIZE_TYPE& n, const double bytes) {
+	const int depth = traceDepth(n);
+	TraceCounters& counters = traceCounters().local();
+	counters.allocs[depth > 0 ? depth - 1 : 0] += 1;
+	counters.allocBytes[depth > 0 ? depth - 1 : 0] += bytes;
+}
+
+void traceTask(const M_SIZE_TYPE& n, const bool stolen) {
+	const int depth = traceDepth(n);
+	TraceCounters& counters = traceCounters().local();
+	counters.tasks[depth] += 1;
+	counters.steals[depth] += stolen ? 1 : 0;
+}
+
+/**
+*  @brief  Beendet eine Messung und legt sie als JSON-Objekt ab: je Ebene
+*  die Phasen (calls, seconds, bytes, flops, flopsPerByte) sowie allocs,
+*  allocBytes, tasks und steals.
+*  @param        run  Bezeichnung des Laufs, z. B. "Strassen Par".
+*  @param  algorithm  Name der Variante.
+*  @param    seconds  Gesamtzeit des Laufs.
+*/
+void traceEnd(const char* run, const char* algorithm, const double seconds) {
+	if (!TRACE_ACTIVE) {
+		return;
+	}
+	TRACE_ACTIVE = false;
+	TraceCounters total;
+	for (tbb::enumerable_thread_specific<TraceCounters>::const_iterator it = traceCounters().begin(); it != traceCounters().end(); ++it) {
+		for (int d = 0; d < TRACE_MAX_DEPTH; ++d) {
+			for (int p = 0; p < TRACE_PHASES; ++p) {
+				total.phase[d][p].calls += it->phase[d][p].calls;
+				total.phase[d][p].seconds += it->phase[d][p].seconds;
+				total.phase[d][p].bytes += it->phase[d][p].bytes;
+				total.phase[d][p].flops += it->phase[d][p].flops;
+			}
+			total.allocs[d] += it->allocs[d];
+			total.allocBytes[d] += it->allocBytes[d];
+			total.tasks[d] += it->tasks[d];
+			total.steals[d] += it->steals[d];
+		}
+	}
+
+	std::ostringstream& out = TRACE_RUNS;
+	out.precision(9);
+	out << (TRACE_RUN_COUNT++ > 0 ? ",\n" : "") << "  {\"run\": \"" << run << "\", \"algorithm\": \"" << algorithm
+		<< "\", \"n\": " << TRACE_ROOT << ", \"seconds\": " << seconds << ", \"levels\": [";
+	bool firstLevel = true;
+	for (int d = 0; d < TRACE_MAX_DEPTH; ++d) {
+		bool used = total.allocs[d] > 0 || total.tasks[d] > 0;
+		for (int p = 0; p < TRACE_PHASES; ++p) {
+			used = used || total.phase[d][p].calls > 0;
+		}
+		if (!used) {
+			continue;
+		}
+		out << (firstLevel ? "\n" : ",\n") << "    {\"depth\": " << d << ", \"size\": " << (TRACE_ROOT >> d);
+		for (int p = 0; p < TRACE_PHASES; ++p) {
+			const TracePhase& c = total.phase[d][p];
+			out << ", \"" << TRACE_PHASE_NAMES[p] << "\": {\"calls\": " << c.calls << ", \"seconds\": " << c.seconds
+				<< ", \"bytes\": " << c.bytes << ", \"flops\": " << c.flops
+				<< ", \"flopsPerByte\": " << (c.bytes > 0 ? c.flops / c.bytes : 0) << "}";
+		}
+		out << ", \"allocs\": " << total.allocs[d] << ", \"allocBytes\": " << total.allocBytes[d]
+			<< ", \"tasks\": " << total.tasks[d] << ", \"steals\": " << total.steals[d] << "}";
+		firstLevel = false;
+	}
+	out << "\n  ]}";
+}
+
+/**
+*  @brief  Schreibt alle abgeschlossenen Messungen als JSON-Datei.
+*  @param  path  Pfad der Datei.
+*  @return true bei Erfolg.
+*/
+bool traceWrite(const char* path) {
+	std::ofstream file(path);
+	if (!file) {
+		return false;
+	}
+	file << "{\"type\": \"" << M_VAL_TYPE_NAMES[M_VAL_TYPE_SELECT] << "\", \"threads\": " << NO_THREADS
+		 << ", \"cutOff\": " << CUT_OFF << ", \"cutOffTask\": " << CUT_OFF_TASK << ", \"seed\": " << RANDOM_SEED
+		 << ", \"runs\": [\n" << TRACE_RUNS.str() << "\n]}\n";
+	return (bool) file;
+}
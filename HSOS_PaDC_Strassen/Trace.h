@@ -0,0 +1,92 @@
+//============================================================================
+// Name        : Trace.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "Definitions.h"
+#include <tbb/tick_count.h>
+
+#define TRACE_ADD 0						// Operandensummen und Additionen (matrixAdd*/matrixSub*)
+#define TRACE_COMBINE 1					// Zusammensetzen der Quadranten (matrixCombinePar, Schleifen)
+#define TRACE_LEAF 2					// Blattmultiplikation (GEMM bzw. ikj)
+#define TRACE_TASK 3					// Ausfuehrung eines Tasks inkl. aller Kinder
+#define TRACE_PHASES 4
+#define TRACE_MAX_DEPTH 32				// Max. erfasste Rekursionstiefe
+
+/*
+ * Optionale Instrumentierung der Strassen-Varianten (-j <Datei>): Je
+ * Rekursionstiefe und Phase werden Aufrufe, Wandzeit, bewegte Bytes und
+ * Flops gezaehlt, dazu belegte Zwischenmatrizen, gestartete Tasks und
+ * gestohlene Tasks (nur Varianten mit tbb::task). Die Tiefe ergibt sich aus
+ * der Dimension relativ zur Wurzel (traceBegin), Zwischenmatrizen zaehlen
+ * zur Ebene, die sie belegt. Bytes sind das Mindestvolumen je Aufruf (jedes
+ * Element einmal gelesen bzw. geschrieben), Zeiten sind Wandzeiten des
+ * aufrufenden Threads (bei Par-Additionen inkl. mitbearbeiteter fremder
+ * Tasks). Die Zaehler liegen je Thread vor und werden erst bei traceEnd
+ * zusammengefasst. Typunabhaengig (nur einmal uebersetzt); USE_TRACE 0
+ * entfernt alle Messpunkte.
+ */
+
+extern bool TRACE_ACTIVE;				// Messung laeuft (zwischen traceBegin und traceEnd)
+
+void traceBegin(const M_SIZE_TYPE& n);
+
+void traceEnd(const char* run, const char* algorithm, const double seconds);
+
+bool traceWrite(const char* path);
+
+void traceRecord(const int phase, const M_SIZE_TYPE& n, const double seconds, const double bytes, const double flops);
+
+void traceAlloc(const M_SIZE_TYPE& n, const double bytes);
+
+void traceTask(const M_SIZE_TYPE& n, const bool stolen);
+
+/**
+*  @brief  Misst die Wandzeit eines Gueltigkeitsbereichs und verbucht sie
+*  mit Bytes und Flops bei Phase und Tiefe (nur bei laufender Messung).
+*/
+class TraceScope {
+	const int phase;
+	const M_SIZE_TYPE n;
+	const double bytes;
+	const double flops;
+	const bool active;
+	tbb::tick_count t0;
+
+	TraceScope(const TraceScope&);
+	TraceScope& operator=(const TraceScope&);
+
+public:
+	TraceScope(const int _phase, const M_SIZE_TYPE& _n, const double _bytes, const double _flops)
+		: phase(_phase), n(_n), bytes(_bytes), flops(_flops), active(TRACE_ACTIVE) {
+		if (active) {
+			t0 = tbb::tick_count::now();
+		}
+	}
+
+	~TraceScope() {
+		if (active) {
+			traceRecord(phase, n, (tbb::tick_count::now() - t0).seconds(), bytes, flops);
+		}
+	}
+};
+
+#if USE_TRACE
+#define TRACE_SCOPE(phase, n, bytes, flops) const TraceScope traceScope((phase), (n), (bytes), (flops))
+#define TRACE_ALLOC(n, bytes) do { if (TRACE_ACTIVE) traceAlloc((n), (bytes)); } while (0)
+#define TRACE_TASK_START(n, stolen) do { if (TRACE_ACTIVE) traceTask((n), (stolen)); } while (0)
+#else
+#define TRACE_SCOPE(phase, n, bytes, flops)
+#define TRACE_ALLOC(n, bytes)
+#define TRACE_TASK_START(n, stolen)
+#endif
+
+#endif
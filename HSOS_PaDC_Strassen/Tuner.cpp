@@ -0,0 +1,186 @@
+//============================================================================
+// Name        : Tuner.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Tuner.h"
+#include "Gemm.h"
+#include "Helper.h"
+#include "Kernel.h"
+#include "Strassen.h"
+#include "Workspace.h"
+#include <tbb/tick_count.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+#include <unistd.h>						// gethostname
+#include <vector>
+
+namespace M_VAL_NAMESPACE {
+
+#define PROFILE_FILE_NAME ".HSOS_PaDC_Strassen.profile"
+
+/**
+*  @brief  Liefert den Pfad des Tuning-Profils: -p, sonst $HOME bzw. das
+*  aktuelle Verzeichnis.
+*/
+std::string tuneProfilePath() {
+	if (PROFILE_PATH != NULL) {
+		return PROFILE_PATH;
+	}
+	const char* home = getenv("HOME");
+	if (home != NULL && home[0] != '\0') {
+		return std::string(home) + "/" + PROFILE_FILE_NAME;
+	}
+	return PROFILE_FILE_NAME;
+}
+
+/**
+*  @brief  Liefert den Schluessel einer Profilzeile: Rechnername, Threads,
+*  Werttyp, Mikrokernel und Variante. Eine Datei kann so die Profile aller
+*  Knoten eines (geteilten) Home-Verzeichnisses aufnehmen.
+*/
+std::string tuneProfileKey() {
+	char host[256] = "unknown";
+	gethostname(host, sizeof(host) - 1);
+	host[sizeof(host) - 1] = '\0';
+	std::ostringstream key;
+	key << host << " " << NO_THREADS << " " << M_VAL_TYPE_NAME << " " << activeKernel().name << " " << STRASSEN_VARIANT;
+	return key.str();
+}
+
+/**
+*  @brief  Liest die Profilzeile der aktuellen Maschine.
+*  @param     path  Pfad des Profils.
+*  @param  profile  Gelesene Cut-Offs.
+*  @return true, falls eine passende Zeile gefunden wurde.
+*/
+bool loadTuneProfile(const std::string& path, TuneProfile& profile) {
+	std::ifstream in(path.c_str());
+	const std::string key = tuneProfileKey();
+	std::string line;
+	while (std::getline(in, line)) {
+		if (line.empty() || line[0] == '#' || line.compare(0, key.size() + 1, key + " ") != 0) {
+			continue;
+		}
+		std::istringstream values(line.substr(key.size()));
+		TuneProfile p;
+		if (values >> p.cutOff >> p.cutOffTask && p.cutOff > 0) {
+			profile = p;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+*  @brief  Schreibt die Profilzeile der aktuellen Maschine. Eine vorhandene
+*  Zeile mit gleichem Schluessel wird ersetzt, andere Zeilen bleiben erhalten.
+*  @param     path  Pfad des Profils.
+*  @param  profile  Zu speichernde Cut-Offs.
+*  @return true bei Erfolg.
+*/
+bool saveTuneProfile(const std::string& path, const TuneProfile& profile) {
+	const std::string key = tuneProfileKey();
+	std::vector<std::string> lines;
+	{
+		std::ifstream in(path.c_str());
+		std::string line;
+		while (std::getline(in, line)) {
+			if (line.compare(0, key.size() + 1, key + " ") != 0) {
+				lines.push_back(line);
+			}
+		}
+	}
+	if (lines.empty()) {
+		lines.push_back("# host threads type kernel variant cut_off cut_off_task");
+	}
+	std::ostringstream entry;
+	entry << key << " " << profile.cutOff << " " << profile.cutOffTask;
+	lines.push_back(entry.str());
+
+	std::ofstream out(path.c_str(), std::ios::trunc);
+	for (std::vector<std::string>::const_iterator it = lines.begin(); it != lines.end(); ++it) {
+		out << *it << "\n";
+	}
+	return out.good();
+}
+
+/**
+*  @brief  Misst eine Multiplikation mit den aktuellen Cut-Offs (Minimum aus
+*  TUNE_REPEATS Laeufen nach einem Aufwaermlauf).
+*  @param  parallel  Task-Version statt sequentieller Version messen.
+*  @return Laufzeit in Sekunden.
+*/
+static double tuneMeasure(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n, const bool parallel) {
+	const M_SIZE_TYPE gemmElements = gemmPackElements(n, n, n);
+	const M_SIZE_TYPE strassenElements = strassenWorkspaceElements(n);
+	initWorkspaces(gemmElements > strassenElements ? gemmElements : strassenElements);
+	double best = 0;
+	for (int r = 0; r <= TUNE_REPEATS; ++r) {
+		const tbb::tick_count t0 = tbb::tick_count::now();
+		parallel ? strassenMultiplyPar(C, A, B, n) : strassenMultiplySeq(C, A, B, n);
+		const double t = (tbb::tick_count::now() - t0).seconds();
+		if (r == 1 || (r > 1 && t < best)) {
+			best = t;
+		}
+	}
+	return best;
+}
+
+/**
+*  @brief  Bestimmt die Cut-Offs der lokalen Maschine: Zuerst wird CUT_OFF
+*  (Zweierpotenzen ab TUNE_MIN_CUT_OFF bis n) mit der sequentiellen Version
+*  gemessen, bei mode == 2 anschliessend CUT_OFF_TASK (0 bzw. Vielfache des
+*  gefundenen CUT_OFF) mit der Task-Version.
+*  @param     n  Matrixdimension (NxN) der Messungen.
+*  @param  mode  1: nur CUT_OFF, 2: CUT_OFF und CUT_OFF_TASK.
+*  @return Gefundene Cut-Offs (auch in CUT_OFF bzw. CUT_OFF_TASK gesetzt).
+*/
+TuneProfile tuneCutOffs(const M_SIZE_TYPE& n, const int mode) {
+	InnerArray a(n * n), b(n * n), c(n * n);
+	const MatrixView A(&a[0], n, n);
+	const MatrixView B(&b[0], n, n);
+	const MatrixView C(&c[0], n, n);
+	initializeRandpriomMatrix(A, n, n, RANDOM_STREAM_A);
+	initializeRandpriomMatrix(B, n, n, RANDOM_STREAM_B);
+
+	TuneProfile profile;
+	double best = 0;
+	CUT_OFF_TASK = 0;
+	for (M_SIZE_TYPE cutOff = TUNE_MIN_CUT_OFF; cutOff <= n; cutOff <<= 1) {
+		CUT_OFF = cutOff;
+		const double t = tuneMeasure(C, A, B, n, false);
+		std::cout << "Tune Seq:\tc = " << cutOff << "\t" << t << "s\n";
+		if (cutOff == TUNE_MIN_CUT_OFF || t < best) {
+			best = t;
+			profile.cutOff = cutOff;
+		}
+	}
+	CUT_OFF = profile.cutOff;
+	profile.cutOffTask = 0;
+
+	if (mode == 2) {
+		best = tuneMeasure(C, A, B, n, true);
+		std::cout << "Tune Par:\tC = 0\t" << best << "s\n";
+		for (M_SIZE_TYPE cutOffTask = profile.cutOff << 1; cutOffTask < n; cutOffTask <<= 1) {
+			CUT_OFF_TASK = cutOffTask;
+			const double t = tuneMeasure(C, A, B, n, true);
+			std::cout << "Tune Par:\tC = " << cutOffTask << "\t" << t << "s\n";
+			if (t < best) {
+				best = t;
+				profile.cutOffTask = cutOffTask;
+			}
+		}
+	}
+	CUT_OFF_TASK = profile.cutOffTask;
+	return profile;
+}
+
+} // namespace M_VAL_NAMESPACE
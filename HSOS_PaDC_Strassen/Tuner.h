@@ -0,0 +1,44 @@
+//============================================================================
+// Name        : Tuner.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef TUNER_H_
+#define TUNER_H_
+
+#include "Definitions.h"
+#include <string>
+
+namespace M_VAL_NAMESPACE {
+
+#define TUNE_MIN_CUT_OFF 16				// Kleinster getesteter Cut-Off
+#define TUNE_MIN_SIZE 512				// Kleinste sinnvolle Matrixdimension fuer das Tuning
+#define TUNE_DEFAULT_SIZE 1024			// Matrixdimension, falls -n kleiner als TUNE_MIN_SIZE ist
+#define TUNE_REPEATS 3					// Messungen je Kandidat (Minimum zaehlt)
+
+/**
+*  @brief  Ergebnis des Tunings fuer eine Maschine.
+*/
+struct TuneProfile {
+	M_SIZE_TYPE cutOff;					// Cut-Off der Rekursion (Blatt-Kernel)
+	M_SIZE_TYPE cutOffTask;				// Cut-Off der Task-Rekursion (0: bis cutOff)
+};
+
+std::string tuneProfilePath();
+
+std::string tuneProfileKey();
+
+bool loadTuneProfile(const std::string& path, TuneProfile& profile);
+
+bool saveTuneProfile(const std::string& path, const TuneProfile& profile);
+
+TuneProfile tuneCutOffs(const M_SIZE_TYPE& n, const int mode);
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
@@ -0,0 +1,237 @@
+//============================================================================
+// Name        : Verify.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Verify.h"
+#include "Helper.h"
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <limits>
+#include <math.h>
+#include <vector>
+
+namespace M_VAL_NAMESPACE {
+
+/**
+*  @brief  Funktionsobjekt fuer randomFill: Eintraege +-1 der Zufallsvektoren.
+*/
+struct VerifySignGenerator {
+	VerifyValue* x;
+
+	VerifySignGenerator(VerifyValue* _x) : x(_x) { }
+
+	void operator()(const uint64_t index, const uint32_t bits) const {
+		x[index] = (bits >> 31) != 0 ? (VerifyValue) 1 : (VerifyValue) -1;
+	}
+};
+
+/**
+*  @brief  Funktionsobjekt fuer Y = M X (X, Y zeilenweise mit vectors
+*  Spalten, ein Vektor je Spalte). Ist absIn gesetzt, wird im selben
+*  Durchlauf zusaetzlich absOut = |M| absIn und (optional) der groesste
+*  Betrag maxOut je Zeile berechnet.
+*/
+struct VerifyMatVecPBody {
+	ConstMatrixView M;
+	const M_SIZE_TYPE cols;
+	const int vectors;
+	const VerifyValue* x;
+	VerifyValue* y;
+	const double* absIn;
+	double* absOut;
+	double* maxOut;
+
+	VerifyMatVecPBody(const ConstMatrixView& _M, const M_SIZE_TYPE& _cols, const int _vectors, const VerifyValue* _x, VerifyValue* _y,
+			const double* _absIn = NULL, double* _absOut = NULL, double* _maxOut = NULL)
+		: M(_M), cols(_cols), vectors(_vectors), x(_x), y(_y), absIn(_absIn), absOut(_absOut), maxOut(_maxOut) { }
+
+	void operator()(const tbb::blocked_range<M_SIZE_TYPE>& range) const {
+		VerifyValue acc[VERIFY_MAX_VECTORS];
+		for (M_SIZE_TYPE i = range.begin(); i != range.end(); ++i) {
+			const M_VAL_TYPE* row = M[i];
+			for (int t = 0; t < vectors; ++t) {
+				acc[t] = 0;
+			}
+			for (M_SIZE_TYPE j = 0; j < cols; ++j) {
+				const VerifyValue value = row[j];
+				const VerifyValue* xj = x + j * vectors;
+				for (int t = 0; t < vectors; ++t) {
+					acc[t] += value * xj[t];
+				}
+			}
+			for (int t = 0; t < vectors; ++t) {
+				y[i * vectors + t] = acc[t];
+			}
+			if (absIn != NULL) {
+				double sum = 0, most = 0;
+				for (M_SIZE_TYPE j = 0; j < cols; ++j) {
+					const double value = fabs((double) row[j]);
+					sum += value * absIn[j];
+					most = value > most ? value : most;
+				}
+				absOut[i] = sum;
+				if (maxOut != NULL) {
+					maxOut[i] = most;
+				}
+			}
+		}
+	}
+};
+
+/**
+*  @brief  Erzeugt die Zufallsvektoren (Eintraege +-1, zeilenweise mit
+*  vectors Spalten) aus RANDOM_STREAM_VERIFY.
+*  @param        x  Ergebnis (n * vectors Werte).
+*  @param        n  Laenge der Vektoren.
+*  @param  vectors  Anzahl der Vektoren.
+*/
+void verifySigns(VerifyValue* x, const M_SIZE_TYPE& n, const int vectors) {
+	randomFill((uint64_t) n * vectors, RANDOM_SEED, RANDOM_STREAM_VERIFY, VerifySignGenerator(x));
+}
+
+/**
+*  @brief  Berechnet parallel Y = M X und optional absOut = |M| absIn sowie
+*  maxOut = max_j |M_ij| (nur zusammen mit absIn).
+*  @param     M  Matrix (rows x cols).
+*  @param     x  Vektoren (cols * vectors, zeilenweise).
+*  @param     y  Ergebnis (rows * vectors).
+*/
+void verifyMatVec(const ConstMatrixView& M, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols, const int vectors,
+		const VerifyValue* x, VerifyValue* y, const double* absIn, double* absOut, double* maxOut) {
+	tbb::parallel_for(tbb::blocked_range<M_SIZE_TYPE>(0, rows, VERIFY_GRAIN), VerifyMatVecPBody(M, cols, vectors, x, y, absIn, absOut, maxOut));
+}
+
+/**
+*  @brief  Rekursionstiefe der schnellen Varianten fuer C (m x n) = A (m x k)
+*  * B (k x n): Halbierungen, bis eine Dimension CUT_OFF erreicht.
+*/
+int verifyLevels(const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k) {
+	M_SIZE_TYPE size = m < n ? (m < k ? m : k) : (n < k ? n : k);
+	int levels = 0;
+	for (; size > CUT_OFF && size > 1; size >>= 1) {
+		++levels;
+	}
+	return levels;
+}
+
+/**
+*  @brief  Normweiser Anteil der Schranke fuer Strassen bzw. Winograd (siehe
+*  Verify.h), fuer alle Zeilen gleich.
+*  @param    normA  Groesster Betrag eines Eintrags von A.
+*  @param    normB  Groesster Betrag eines Eintrags von B.
+*  @param        n  Laenge der Zufallsvektoren (Spalten von C).
+*  @param        k  Laenge der Skalarprodukte (Spalten von A).
+*  @param  variant  Variante (VARIANT_*; FlowGraph und CAPS rechnen wie Strassen).
+*  @param   levels  Rekursionstiefe d (0: klassisch, Term entfaellt).
+*  @return Absoluter Anteil der Schranke (ganzzahlig: 0).
+*/
+double verifyNormwise(const double normA, const double normB, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const int variant, const int levels) {
+#if M_VAL_IS_INTEGER
+	(void) normA;
+	(void) normB;
+	(void) n;
+	(void) k;
+	(void) variant;
+	(void) levels;
+	return 0;
+#else
+	if (levels <= 0) {
+		return 0;
+	}
+	const double factor = variant == VARIANT_WINOGRAD ? 18 : 12;
+	const double additions = variant == VARIANT_WINOGRAD ? 6 : 5;
+	const double leaf = ldexp((double) k, -levels);
+	const double growth = pow(factor, levels) * (leaf * leaf + additions * leaf) - additions * k;
+	return VERIFY_TOLERANCE * sqrt((double) n * growth) * 0.5 * std::numeric_limits<M_VAL_TYPE>::epsilon() * normA * normB;
+#endif
+}
+
+/**
+*  @brief  Vergleicht w = C x mit z = A (B x) zeilenweise gegen die Schranke.
+*  @param     w  C x (m * vectors).
+*  @param     z  A (B x) (m * vectors).
+*  @param      absZ  |A| (|B| 1) (m Werte, ganzzahlig: ungenutzt).
+*  @param  normwise  Normweiser Anteil der Schranke (verifyNormwise, ganzzahlig: ungenutzt).
+*  @param         m  Anzahl der Zeilen.
+*  @param         k  Laenge der Skalarprodukte (Spalten von A).
+*  @return Ergebnis mit der ungenauesten Zeile (0 .. m-1).
+*/
+VerifyResult verifyResiduals(const VerifyValue* w, const VerifyValue* z, const double* absZ, const double normwise,
+		const M_SIZE_TYPE& m, const M_SIZE_TYPE& k, const int vectors) {
+#if M_VAL_IS_INTEGER
+	(void) absZ;
+	(void) normwise;
+	(void) k;
+#else
+	const double scale = VERIFY_TOLERANCE * sqrt((double) k) * 0.5 * std::numeric_limits<M_VAL_TYPE>::epsilon();
+#endif
+	VerifyResult result = { true, 0, 0, 0 };
+	double worst = -1;
+	for (M_SIZE_TYPE i = 0; i < m; ++i) {
+		double residual = 0;
+		for (int t = 0; t < vectors; ++t) {
+			const double r = fabs((double) (w[i * vectors + t] - z[i * vectors + t]));
+			residual = r > residual || r != r ? r : residual;
+		}
+#if M_VAL_IS_INTEGER
+		const double bound = 0;
+		const double ratio = residual;
+#else
+		const double bound = scale * absZ[i] + normwise;
+		const double ratio = bound > 0 ? residual / bound : residual > 0 ? std::numeric_limits<double>::infinity() : 0;
+#endif
+		const bool rowOk = residual <= bound;
+		if ((!rowOk && result.ok) || (rowOk == result.ok && ratio > worst) || ratio != ratio) {
+			worst = ratio;
+			result.ok = rowOk;
+			result.row = i;
+			result.residual = residual;
+			result.bound = bound;
+		}
+	}
+	return result;
+}
+
+/**
+*  @brief  Prueft C = A * B (C m x n, A m x k, B k x n) nach Freivalds.
+*  @param        C  Zu pruefendes Ergebnis.
+*  @param        A  Matrix A.
+*  @param        B  Matrix B.
+*  @param        m  Zeilen von A und C.
+*  @param        n  Spalten von B und C.
+*  @param        k  Spalten von A bzw. Zeilen von B.
+*  @param  vectors  Anzahl der Zufallsvektoren (1 bis VERIFY_MAX_VECTORS).
+*  @return Ergebnis mit der ungenauesten Zeile.
+*/
+VerifyResult verifyProduct(const ConstMatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B,
+		const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const int vectors) {
+	const int v = vectors < 1 ? 1 : vectors > VERIFY_MAX_VECTORS ? VERIFY_MAX_VECTORS : vectors;
+	std::vector<VerifyValue> x(n * v), y(k * v), z(m * v), w(m * v);
+	verifySigns(&x[0], n, v);
+
+#if M_VAL_IS_INTEGER
+	verifyMatVec(B, k, n, v, &x[0], &y[0]);
+	verifyMatVec(A, m, k, v, &y[0], &z[0]);
+	const double* absZ = NULL;
+	const double normwise = 0;
+#else
+	// |x| = 1: Die Schranke benoetigt |A| (|B| 1) und die groessten Betraege, berechnet in denselben Durchlaeufen
+	std::vector<double> ones(n, 1.0), absY(k), absZValues(m), maxB(k), maxA(m);
+	verifyMatVec(B, k, n, v, &x[0], &y[0], &ones[0], &absY[0], &maxB[0]);
+	verifyMatVec(A, m, k, v, &y[0], &z[0], &absY[0], &absZValues[0], &maxA[0]);
+	const double* absZ = &absZValues[0];
+	const double normwise = verifyNormwise(*std::max_element(maxA.begin(), maxA.end()), *std::max_element(maxB.begin(), maxB.end()),
+			n, k, STRASSEN_VARIANT, verifyLevels(m, n, k));
+#endif
+	verifyMatVec(C, m, n, v, &x[0], &w[0]);
+	return verifyResiduals(&w[0], &z[0], absZ, normwise, m, k, v);
+}
+
+} // namespace M_VAL_NAMESPACE
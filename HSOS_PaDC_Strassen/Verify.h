@@ -0,0 +1,91 @@
+//============================================================================
+// Name        : Verify.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef VERIFY_H_
+#define VERIFY_H_
+
+#include "Definitions.h"
+#include <stddef.h>
+
+namespace M_VAL_NAMESPACE {
+
+#define VERIFY_TOLERANCE 16				// Sicherheitsfaktor der Fehlerschranke (Fehlerwachstum bei Strassen)
+#define VERIFY_GRAIN 16					// Zeilen je Teilbereich der parallelen Matrix-Vektor-Produkte
+
+/*
+ * Probabilistische Pruefung von C = A * B nach Freivalds in O(n^2): Fuer
+ * Zufallsvektoren x mit Eintraegen +-1 wird r = C x - A (B x) berechnet
+ * (je ein paralleler Durchlauf ueber B, A und C fuer alle Vektoren zugleich).
+ * Ganzzahlige Werttypen muessen exakt uebereinstimmen, ein falsches C bleibt
+ * je Vektor mit Wahrscheinlichkeit <= 1/2 unentdeckt. Gleitkommatypen werden
+ * zeilenweise gegen die Schranke
+ *
+ *     |r_i| <= VERIFY_TOLERANCE * sqrt(k) * u * (|A| |B| |x|)_i
+ *
+ * geprueft (u: Rundungseinheit des Werttyps), die mit den Betraegen der
+ * Eingaben skaliert. sqrt(k) statt k folgt der probabilistischen
+ * Rundungsfehleranalyse (Higham, Mary 2019), die Schranke bleibt so eng
+ * genug, um einzelne verfaelschte Eintraege zu erkennen. Die Produkte selbst
+ * werden in double akkumuliert.
+ *
+ * Diese komponentenweise Schranke gilt nur fuer die klassische GEMM. Strassen
+ * und Winograd mischen Zeilen und Spalten, ihr Fehler ist nur normweise
+ * beschraenkt und waechst mit der Rekursionstiefe d (Higham 2002, Satz 23.2
+ * und 23.3; n0 = k / 2^d, ||.||: groesster Betrag eines Eintrags):
+ *
+ *     ||dC|| <= f(k, d) u ||A|| ||B||,  f = 12^d (n0^2 + 5 n0) - 5 k  (Strassen)
+ *                                       f = 18^d (n0^2 + 6 n0) - 6 k  (Winograd)
+ *
+ * Fuer d > 0 kommt deshalb der Term
+ *
+ *     VERIFY_TOLERANCE * sqrt(n * f(k, d)) * u * ||A|| ||B||
+ *
+ * hinzu (verifyNormwise; sqrt wie oben probabilistisch, n: Laenge von x).
+ * Er deckt die mit CUT_OFF und STRASSEN_VARIANT konfigurierte Rekursion ab,
+ * fuer flachere Rekursionen und die klassische GEMM ist die Summe beider
+ * Terme eine (lockerere) obere Schranke. Garantiert ist damit: Ein Fehler
+ * wird gemeldet, wenn ein Residuum die Summe beider Terme uebersteigt;
+ * verfaelschte Eintraege unterhalb dieser Summe bleiben unentdeckt.
+ */
+
+/**
+*  @brief  Ergebnis einer Pruefung.
+*/
+struct VerifyResult {
+	bool ok;							// Alle Zeilen innerhalb der Schranke
+	M_SIZE_TYPE row;					// Zeile mit dem groessten Verhaeltnis Residuum / Schranke
+	double residual;					// |r_i| dieser Zeile
+	double bound;						// Schranke dieser Zeile (ganzzahlig: 0)
+};
+
+#if M_VAL_IS_INTEGER
+typedef M_VAL_TYPE VerifyValue;			// Ganzzahlig: exakt im Werttyp
+#else
+typedef double VerifyValue;				// Gleitkomma: Akkumulation in double
+#endif
+
+void verifySigns(VerifyValue* x, const M_SIZE_TYPE& n, const int vectors);
+
+void verifyMatVec(const ConstMatrixView& M, const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols, const int vectors,
+		const VerifyValue* x, VerifyValue* y, const double* absIn = NULL, double* absOut = NULL, double* maxOut = NULL);
+
+int verifyLevels(const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k);
+
+double verifyNormwise(const double normA, const double normB, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const int variant, const int levels);
+
+VerifyResult verifyResiduals(const VerifyValue* w, const VerifyValue* z, const double* absZ, const double normwise,
+		const M_SIZE_TYPE& m, const M_SIZE_TYPE& k, const int vectors);
+
+VerifyResult verifyProduct(const ConstMatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B,
+		const M_SIZE_TYPE& m, const M_SIZE_TYPE& n, const M_SIZE_TYPE& k, const int vectors);
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
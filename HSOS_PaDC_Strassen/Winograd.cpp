@@ -0,0 +1,192 @@
+//============================================================================
+// Name        : Winograd.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Winograd.h"
+#include "Strassen.h"
+#include "Workspace.h"
+
+namespace M_VAL_NAMESPACE {
+
+// Zwischenmatrizen (n/2 x n/2) je Rekursionsebene, siehe Implementierungen unten
+#define WINOGRAD_SEQ_TEMPORARIES 2		// X (Operanden A), Y (Operanden B)
+#define WINOGRAD_TASK_TEMPORARIES 11	// S1..S4, T1..T4, P1, P2, P4
+
+/**
+*  @brief  Berechnet die Groesse des Workspaces je Thread fuer die
+*  Strassen-Winograd-Variante.
+*  @param  n  Matrixdimension (NxN).
+*  @return Benoetigte Elemente je Thread.
+*/
+M_SIZE_TYPE winogradWorkspaceElements(const M_SIZE_TYPE& n) {
+	return variantWorkspaceElements(n, WINOGRAD_SEQ_TEMPORARIES, WINOGRAD_TASK_TEMPORARIES);
+}
+
+/**
+*  @brief  Funktionsobjekt fuer die sieben Additionen U1..U7. P3, P5, P6 und
+*  P7 liegen bereits in C11, C22, C12 bzw. C21.
+*/
+struct WinogradCombinePBody {
+	MatrixView C11, C12, C21, C22;
+	ConstMatrixView P1, P2, P4;
+
+	WinogradCombinePBody(const MatrixView& __C11, const MatrixView& __C12, const MatrixView& __C21, const MatrixView& __C22,
+			const ConstMatrixView& __P1, const ConstMatrixView& __P2, const ConstMatrixView& __P4) :
+			C11(__C11), C12(__C12), C21(__C21), C22(__C22), P1(__P1), P2(__P2), P4(__P4) {
+	}
+
+	void operator()(const tbb::blocked_range2d<M_SIZE_TYPE>& range) const {
+		for (M_SIZE_TYPE i = range.rows().begin(); i != range.rows().end(); ++i) {
+			for (M_SIZE_TYPE j = range.cols().begin(); j != range.cols().end(); ++j) {
+				const M_VAL_TYPE u2 = P1[i][j] + C12[i][j];		// U2 = P1 + P6
+				const M_VAL_TYPE u3 = u2 + C21[i][j];			// U3 = U2 + P7
+				const M_VAL_TYPE u4 = u2 + C22[i][j];			// U4 = U2 + P5
+				C22[i][j] = u3 + C22[i][j];						// U7 = U3 + P5
+				C12[i][j] = u4 + C11[i][j];						// U5 = U4 + P3
+				C21[i][j] = u3 - P4[i][j];						// U6 = U3 - P4
+				C11[i][j] = P1[i][j] + P2[i][j];				// U1 = P1 + P2
+			}
+		}
+	}
+};
+
+/**
+*  @brief  Vererbte und ueberschriebene Methode der tbb::task-Klasse.
+*  Bildet die acht Operanden S1..S4, T1..T4 und berechnet die sieben
+*  Produkte parallel. P3, P5, P6 und P7 werden direkt in die Quadranten von
+*  C geschrieben; die sieben Additionen U1..U7 erfolgen in einem Durchlauf.
+*  @return tbb::task.
+*/
+tbb::task* StrassenWinograd::execute() {
+	TRACE_TASK_START(n, is_stolen_task());
+	TRACE_SCOPE(TRACE_TASK, n, 0, 0);
+	if (n <= CUT_OFF) {
+		strassenLeaf(C, A, B, n);
+	}
+	else if (n <= CUT_OFF_TASK) {
+		winogradRecursive(C, A, B, n);
+	}
+	else {
+		const M_SIZE_TYPE newN = n >> 1;
+		WorkspaceFrame frame;
+		// Devide & Conquer (Quadranten als Sichten, ohne Kopie)
+		const ConstMatrixView A11 = A.quadrant(0, 0);
+		const ConstMatrixView A12 = A.quadrant(0, 1);
+		const ConstMatrixView A21 = A.quadrant(1, 0);
+		const ConstMatrixView A22 = A.quadrant(1, 1);
+
+		const ConstMatrixView B11 = B.quadrant(0, 0);
+		const ConstMatrixView B12 = B.quadrant(0, 1);
+		const ConstMatrixView B21 = B.quadrant(1, 0);
+		const ConstMatrixView B22 = B.quadrant(1, 1);
+
+		const MatrixView C11 = C.quadrant(0, 0);
+		const MatrixView C12 = C.quadrant(0, 1);
+		const MatrixView C21 = C.quadrant(1, 0);
+		const MatrixView C22 = C.quadrant(1, 1);
+
+		// 8 Additionen: S1..S4, T1..T4
+		const MatrixView S1 = frame.matrix(newN, C.tile);
+		const MatrixView S2 = frame.matrix(newN, C.tile);
+		const MatrixView S3 = frame.matrix(newN, C.tile);
+		const MatrixView S4 = frame.matrix(newN, C.tile);
+		const MatrixView T1 = frame.matrix(newN, C.tile);
+		const MatrixView T2 = frame.matrix(newN, C.tile);
+		const MatrixView T3 = frame.matrix(newN, C.tile);
+		const MatrixView T4 = frame.matrix(newN, C.tile);
+		matrixAddPar(S1, A21, A22, newN);
+		matrixSubPar(S2, S1, A11, newN);
+		matrixSubPar(S3, A11, A21, newN);
+		matrixSubPar(S4, A12, S2, newN);
+		matrixSubPar(T1, B12, B11, newN);
+		matrixSubPar(T2, B22, T1, newN);
+		matrixSubPar(T3, B22, B12, newN);
+		matrixSubPar(T4, T2, B21, newN);
+
+		// 7 Multiplikationen
+		const MatrixView P1 = frame.matrix(newN, C.tile);
+		const MatrixView P2 = frame.matrix(newN, C.tile);
+		const MatrixView P4 = frame.matrix(newN, C.tile);
+		set_ref_count(8);
+		spawn(*new (allocate_child()) StrassenWinograd(P1, A11, B11, newN));
+		spawn(*new (allocate_child()) StrassenWinograd(P2, A12, B21, newN));
+		spawn(*new (allocate_child()) StrassenWinograd(C11, S4, B22, newN));	// P3
+		spawn(*new (allocate_child()) StrassenWinograd(P4, A22, T4, newN));
+		spawn(*new (allocate_child()) StrassenWinograd(C22, S1, T1, newN));		// P5
+		spawn(*new (allocate_child()) StrassenWinograd(C12, S2, T2, newN));		// P6
+		spawn_and_wait_for_all(*new (allocate_child()) StrassenWinograd(C21, S3, T3, newN));	// P7
+
+		// 7 Additionen: U1..U7
+		matrixCombinePar(WinogradCombinePBody(C11, C12, C21, C22, P1, P2, P4), newN, newN, 11, 7);
+	}
+	return NULL;
+}
+
+/**
+*  @brief  Rekursive Methode, welche zwei Matrizen nach der Strassen-
+*  Winograd-Variante errechnet. Die Reihenfolge der Operationen benoetigt
+*  je Ebene nur zwei Zwischenmatrizen (X, Y); die Produkte werden in den
+*  noch freien Quadranten von C abgelegt.
+*  @param  C  Matrix C (Ergebnismatrix, wird ueberschrieben).
+*  @param  A  Matrix A.
+*  @param  B  Matrix B.
+*  @param  n  Matrixdimension (NxN).
+*/
+void winogradRecursive(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n) {
+	if (n <= CUT_OFF) {
+		strassenLeaf(C, A, B, n);
+	}
+	else {
+		const M_SIZE_TYPE newN = n >> 1;
+		WorkspaceFrame frame;
+		// Devide & Conquer (Quadranten als Sichten, ohne Kopie)
+		const ConstMatrixView A11 = A.quadrant(0, 0);
+		const ConstMatrixView A12 = A.quadrant(0, 1);
+		const ConstMatrixView A21 = A.quadrant(1, 0);
+		const ConstMatrixView A22 = A.quadrant(1, 1);
+
+		const ConstMatrixView B11 = B.quadrant(0, 0);
+		const ConstMatrixView B12 = B.quadrant(0, 1);
+		const ConstMatrixView B21 = B.quadrant(1, 0);
+		const ConstMatrixView B22 = B.quadrant(1, 1);
+
+		const MatrixView C11 = C.quadrant(0, 0);
+		const MatrixView C12 = C.quadrant(0, 1);
+		const MatrixView C21 = C.quadrant(1, 0);
+		const MatrixView C22 = C.quadrant(1, 1);
+
+		const MatrixView X = frame.matrix(newN, C.tile);
+		const MatrixView Y = frame.matrix(newN, C.tile);
+
+		matrixSubSeq(X, A11, A21, newN);		// S3 = A11 - A21
+		matrixSubSeq(Y, B22, B12, newN);		// T3 = B22 - B12
+		winogradRecursive(C21, X, Y, newN);		// P7 = S3 * T3
+		matrixAddSeq(X, A21, A22, newN);		// S1 = A21 + A22
+		matrixSubSeq(Y, B12, B11, newN);		// T1 = B12 - B11
+		winogradRecursive(C22, X, Y, newN);		// P5 = S1 * T1
+		matrixSubSeq(X, X, A11, newN);			// S2 = S1 - A11
+		matrixSubSeq(Y, B22, Y, newN);			// T2 = B22 - T1
+		winogradRecursive(C12, X, Y, newN);		// P6 = S2 * T2
+		matrixSubSeq(X, A12, X, newN);			// S4 = A12 - S2
+		winogradRecursive(C11, X, B22, newN);	// P3 = S4 * B22
+		winogradRecursive(X, A11, B11, newN);	// P1 = A11 * B11
+		matrixAddSeq(C12, X, C12, newN);		// U2 = P1 + P6
+		matrixAddSeq(C21, C12, C21, newN);		// U3 = U2 + P7
+		matrixAddSeq(C12, C12, C22, newN);		// U4 = U2 + P5
+		matrixAddSeq(C22, C21, C22, newN);		// U7 = U3 + P5
+		matrixAddSeq(C12, C12, C11, newN);		// U5 = U4 + P3
+		matrixSubSeq(Y, Y, B21, newN);			// T4 = T2 - B21
+		winogradRecursive(C11, A22, Y, newN);	// P4 = A22 * T4
+		matrixSubSeq(C21, C21, C11, newN);		// U6 = U3 - P4
+		winogradRecursive(C11, A12, B21, newN);	// P2 = A12 * B21
+		matrixAddSeq(C11, X, C11, newN);		// U1 = P1 + P2
+	}
+}
+
+} // namespace M_VAL_NAMESPACE
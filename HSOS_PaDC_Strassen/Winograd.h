@@ -0,0 +1,42 @@
+//============================================================================
+// Name        : Winograd.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef WINOGRAD_H_
+#define WINOGRAD_H_
+
+#include "Definitions.h"
+#include "Matrix.h"
+
+namespace M_VAL_NAMESPACE {
+
+/**
+*  @brief  Repraesentiert eine Klasse, welche Matrixmultiplikationen
+*  mithilfe der Strassen-Winograd-Variante (7 Multiplikationen,
+*  15 Additionen je Ebene) in Tasks loest.
+*/
+class StrassenWinograd : public tbb::task {
+	MatrixView C;
+	ConstMatrixView A;
+	ConstMatrixView B;
+	const M_SIZE_TYPE n;
+
+public:
+	StrassenWinograd(const MatrixView& __C, const ConstMatrixView& __A, const ConstMatrixView& __B, const M_SIZE_TYPE& __n) : C(__C), A(__A), B(__B), n(__n) { }
+
+	tbb::task* execute();
+};
+
+M_SIZE_TYPE winogradWorkspaceElements(const M_SIZE_TYPE& n);
+
+void winogradRecursive(const MatrixView& C, const ConstMatrixView& A, const ConstMatrixView& B, const M_SIZE_TYPE& n);
+
+} // namespace M_VAL_NAMESPACE
+
+#endif
@@ -0,0 +1,281 @@
+//============================================================================
+// Name        : Workspace.cpp
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#include "Workspace.h"
+#include <tbb/atomic.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/scalable_allocator.h>
+#include <tbb/spin_mutex.h>
+#include <tbb/task_scheduler_observer.h>
+#include <new>
+
+namespace M_VAL_NAMESPACE {
+
+#define WORKSPACE_ALIGNMENT 64			// Ausrichtung der Reservierung (Cache-Line)
+#define WORKSPACE_OVERFLOW_SLOTS 64		// Vorab reservierte Eintraege der Ueberlaufliste
+
+static M_SIZE_TYPE WORKSPACE_ELEMENTS = 0;	// Groesse einer neuen Thread-Reservierung
+static tbb::spin_mutex RESERVE_MUTEX;			// Reservierung durch initWorkspaces und Observer (verschiedene Threads)
+static tbb::atomic<size_t> HEAP_ELEMENTS;		// Aktuell auf dem Heap belegte Zwischenmatrizen (Elemente)
+static tbb::atomic<size_t> HEAP_PEAK;			// Maximal auf dem Heap belegte Zwischenmatrizen (Elemente)
+
+static tbb::enumerable_thread_specific<Workspace>& workspaces() {
+	static tbb::enumerable_thread_specific<Workspace> ets;
+	return ets;
+}
+
+/**
+*  @brief  Allokiert einen ausgerichteten Speicherblock.
+*  @param  elements  Anzahl der Elemente.
+*  @return Zeiger auf den Speicherblock.
+*/
+static M_VAL_TYPE* allocateElements(const M_SIZE_TYPE& elements) {
+	void* p = scalable_aligned_malloc(elements * sizeof(M_VAL_TYPE), WORKSPACE_ALIGNMENT);
+	if (p == NULL) {
+		throw std::bad_alloc();
+	}
+	return static_cast<M_VAL_TYPE*>(p);
+}
+
+Workspace::Workspace() : buffer(NULL), capacity(0), top(0), peak(0), overflowCount(0) {
+	overflow.reserve(WORKSPACE_OVERFLOW_SLOTS);
+	reserve(WORKSPACE_ELEMENTS);
+}
+
+Workspace::Workspace(const M_SIZE_TYPE& elements) : buffer(NULL), capacity(0), top(0), peak(0), overflowCount(0) {
+	overflow.reserve(WORKSPACE_OVERFLOW_SLOTS);
+	reserve(elements);
+}
+
+Workspace::~Workspace() {
+	release(0);
+	scalable_aligned_free(buffer);
+}
+
+/**
+*  @brief  Reserviert (mindestens) die uebergebene Anzahl an Elementen. Darf
+*  nur aufgerufen werden, solange keine Matrizen belegt sind.
+*  @param  elements  Anzahl der Elemente.
+*/
+void Workspace::reserve(const M_SIZE_TYPE& elements) {
+	tbb::spin_mutex::scoped_lock lock(RESERVE_MUTEX);
+	if (elements <= capacity || top != 0) {
+		return;
+	}
+	scalable_aligned_free(buffer);
+	buffer = NULL;
+	capacity = 0;
+	buffer = allocateElements(elements);
+	capacity = elements;
+}
+
+/**
+*  @brief  Belegt einen Block oberhalb des Stapelzeigers.
+*  @param  elements  Anzahl der Elemente.
+*  @return Zeiger auf den (nicht initialisierten) Block.
+*/
+M_VAL_TYPE* Workspace::acquire(const M_SIZE_TYPE& elements) {
+	M_VAL_TYPE* p;
+	if (top + elements <= capacity) {
+		p = buffer + top;
+	}
+	else {
+		p = allocateElements(elements);
+		overflow.push_back(std::make_pair(top, p));
+		++overflowCount;
+	}
+	top += elements;
+	if (top > peak) {
+		peak = top;
+	}
+	return p;
+}
+
+/**
+*  @brief  Gibt alle oberhalb der Marke belegten Bloecke frei.
+*  @param  mark  Stapelmarke (siehe mark()).
+*/
+void Workspace::release(const M_SIZE_TYPE& mark) {
+	while (!overflow.empty() && overflow.back().first >= mark) {
+		scalable_aligned_free(overflow.back().second);
+		overflow.pop_back();
+	}
+	top = mark;
+}
+
+/**
+*  @brief  Allokiert eine Zwischenmatrix auf dem Heap und zaehlt die Belegung.
+*/
+static M_VAL_TYPE* heapAcquire(const M_SIZE_TYPE& elements) {
+	M_VAL_TYPE* p = allocateElements(elements);
+	const size_t current = HEAP_ELEMENTS.fetch_and_add(elements) + elements;
+	for (size_t peak = HEAP_PEAK; current > peak; peak = HEAP_PEAK) {
+		if (HEAP_PEAK.compare_and_swap(current, peak) == peak) {
+			break;
+		}
+	}
+	return p;
+}
+
+/**
+*  @brief  Gibt eine per heapAcquire allokierte Zwischenmatrix frei.
+*/
+static void heapRelease(M_VAL_TYPE* p, const M_SIZE_TYPE& elements) {
+	scalable_aligned_free(p);
+	HEAP_ELEMENTS.fetch_and_add(-elements);
+}
+
+WorkspaceFrame::WorkspaceFrame() : ws(localWorkspace()), start(ws.mark()), heapCount(0) { }
+
+WorkspaceFrame::~WorkspaceFrame() {
+	while (heapCount > 0) {
+		--heapCount;
+		heapRelease(heapBlocks[heapCount], heapElements[heapCount]);
+	}
+	ws.release(start);
+}
+
+/**
+*  @brief  Belegt eine Zwischenmatrix: bis WORKSPACE_HEAP_ELEMENTS im
+*  Workspace, darueber (obere Ebenen) auf dem Heap.
+*  @param  elements  Anzahl der Elemente.
+*  @return Zeiger auf den (nicht initialisierten) Block.
+*/
+M_VAL_TYPE* WorkspaceFrame::acquireMatrix(const M_SIZE_TYPE& elements) {
+	if (elements <= WORKSPACE_HEAP_ELEMENTS || heapCount == WORKSPACE_FRAME_BLOCKS) {
+		return ws.acquire(elements);
+	}
+	heapBlocks[heapCount] = heapAcquire(elements);
+	heapElements[heapCount] = elements;
+	return heapBlocks[heapCount++];
+}
+
+HeapFrame::~HeapFrame() {
+	for (size_t i = 0; i < blocks.size(); ++i) {
+		heapRelease(blocks[i].first, blocks[i].second);
+	}
+}
+
+/**
+*  @brief  Belegt eine (nicht initialisierte) Matrix der Dimension n auf dem Heap.
+*  @param     n  Matrixdimension (NxN).
+*  @param  tile  Kachelgroesse im Morton-Layout (optional, 0: zeilenweise).
+*  @return Sicht auf die belegte Matrix.
+*/
+MatrixView HeapFrame::matrix(const M_SIZE_TYPE& n, const M_SIZE_TYPE& tile) {
+	const M_SIZE_TYPE elements = n * n;
+	TRACE_ALLOC(n, (double) elements * sizeof(M_VAL_TYPE));
+	M_VAL_TYPE* p = heapAcquire(elements);
+	blocks.push_back(std::make_pair(p, elements));
+	return MatrixView(p, n, n, tile);
+}
+
+/**
+*  @brief  Berechnet den Workspace-Bedarf eines Rekursionspfads: Jede Ebene
+*  oberhalb des Cut-Offs belegt perLevel Matrizen der halben Dimension, die
+*  Summe bildet eine geometrische Reihe (< perLevel * n^2 / 3). Ebenen mit
+*  Matrizen ueber WORKSPACE_HEAP_ELEMENTS belegen den Heap und zaehlen nicht,
+*  der Bedarf ist damit unabhaengig von n beschraenkt.
+*  @param         n  Matrixdimension (NxN).
+*  @param    cutOff  Cut-Off der Rekursion.
+*  @param  perLevel  Zwischenmatrizen je Rekursionsebene.
+*  @return Benoetigte Elemente.
+*/
+M_SIZE_TYPE workspaceSeriesElements(const M_SIZE_TYPE& n, const M_SIZE_TYPE& cutOff, const M_SIZE_TYPE& perLevel) {
+	M_SIZE_TYPE elements = 0;
+	for (M_SIZE_TYPE size = n; size > cutOff; size >>= 1) {
+		const M_SIZE_TYPE half = size >> 1;
+		elements += perLevel * workspaceShare(half * half);
+	}
+	return elements;
+}
+
+/**
+*  @brief  Reserviert den Workspace jedes Threads beim Eintritt in den
+*  Scheduler, also vor seinem ersten Task (auch bei Threads, die schon vor
+*  dem Einschalten beteiligt waren: vor ihrem naechsten Task).
+*/
+class WorkspaceObserver: public tbb::task_scheduler_observer {
+public:
+	WorkspaceObserver() {
+		observe(true);
+	}
+
+	void on_scheduler_entry(bool) {
+		localWorkspace().reserve(WORKSPACE_ELEMENTS);
+	}
+};
+
+/**
+*  @brief  Legt die Groesse der Thread-Reservierungen fest und reserviert die
+*  Workspaces aller Threads, die bereits einen haben, sowie den des
+*  aufrufenden Threads. Alle uebrigen Threads reserviert ein Observer beim
+*  Eintritt in den Scheduler, bevor sie einen Task ausfuehren; Multiplikationen
+*  fordern damit keinen Workspace mehr an.
+*  @param  elements  Anzahl der Elemente je Thread.
+*/
+void initWorkspaces(const M_SIZE_TYPE& elements) {
+	WORKSPACE_ELEMENTS = elements;
+	static WorkspaceObserver observer;
+	for (tbb::enumerable_thread_specific<Workspace>::iterator it = workspaces().begin(); it != workspaces().end(); ++it) {
+		it->reserve(elements);
+	}
+	localWorkspace().reserve(elements);
+}
+
+/**
+*  @brief  Liefert den Workspace des aufrufenden Threads.
+*/
+Workspace& localWorkspace() {
+	return workspaces().local();
+}
+
+/**
+*  @brief  Summe der reservierten Bytes ueber alle Threads.
+*/
+size_t workspaceReservedBytes() {
+	size_t elements = 0;
+	for (tbb::enumerable_thread_specific<Workspace>::const_iterator it = workspaces().begin(); it != workspaces().end(); ++it) {
+		elements += it->reservedElements();
+	}
+	return elements * sizeof(M_VAL_TYPE);
+}
+
+/**
+*  @brief  Summe der maximal belegten Bytes ueber alle Threads (inkl. Ueberlauf).
+*/
+size_t workspacePeakBytes() {
+	size_t elements = 0;
+	for (tbb::enumerable_thread_specific<Workspace>::const_iterator it = workspaces().begin(); it != workspaces().end(); ++it) {
+		elements += it->peakElements();
+	}
+	return elements * sizeof(M_VAL_TYPE);
+}
+
+/**
+*  @brief  Anzahl der Heap-Allokationen aufgrund zu kleiner Reservierungen.
+*/
+M_SIZE_TYPE workspaceOverflows() {
+	M_SIZE_TYPE count = 0;
+	for (tbb::enumerable_thread_specific<Workspace>::const_iterator it = workspaces().begin(); it != workspaces().end(); ++it) {
+		count += it->overflows();
+	}
+	return count;
+}
+
+/**
+*  @brief  Maximal auf dem Heap belegte Bytes (HeapFrame und grosse
+*  Zwischenmatrizen der WorkspaceFrames).
+*/
+size_t heapPeakBytes() {
+	return HEAP_PEAK * sizeof(M_VAL_TYPE);
+}
+
+} // namespace M_VAL_NAMESPACE
@@ -0,0 +1,165 @@
+//============================================================================
+// Name        : Workspace.h
+// Author      : Tobias Sibera <Tobias.Sibera@HS-Osnabrueck.de>
+//				 Jens Overmoeller <Jens.Overmoeller@HS-Osnabrueck.de>
+// Version     : 1.00
+// Copyright   : GPLv3
+// Created on  : 15.11.2014
+// Description : Algorithmus: Strassen. Parallelisierung mit tbb.
+//============================================================================
+
+#ifndef WORKSPACE_H_
+#define WORKSPACE_H_
+
+#include "Definitions.h"
+#include "Trace.h"
+#include <vector>
+
+namespace M_VAL_NAMESPACE {
+
+#define WORKSPACE_HEAP_ELEMENTS (512 * 512)	// Groessere Zwischenmatrizen (obere Ebenen) belegt WorkspaceFrame auf dem Heap
+#define WORKSPACE_FRAME_BLOCKS 24			// Heap-Bloecke je WorkspaceFrame (>= Zwischenmatrizen einer Ebene)
+
+/**
+*  @brief  Vorab reservierter Arbeitsspeicher eines Threads fuer die
+*  Zwischenmatrizen des Strassen-Algorithmusses. Der Speicher wird als Stapel
+*  vergeben: Jede Rekursionsebene belegt ihre Matrizen oberhalb der Ebene
+*  darueber und gibt sie beim Verlassen wieder frei. Reicht die Reservierung
+*  nicht aus (z. B. bei verschachtelt gestohlenen Tasks), wird auf den Heap
+*  ausgewichen und der Ueberlauf gezaehlt.
+*/
+class Workspace {
+	M_VAL_TYPE* buffer;					// Reservierter Speicher
+	M_SIZE_TYPE capacity;				// Groesse der Reservierung in Elementen
+	M_SIZE_TYPE top;					// Aktuell belegte Elemente (Stapelzeiger)
+	M_SIZE_TYPE peak;					// Maximal belegte Elemente (inkl. Ueberlauf)
+	M_SIZE_TYPE overflowCount;			// Anzahl der Heap-Allokationen
+	std::vector<std::pair<M_SIZE_TYPE, M_VAL_TYPE*> > overflow;	// Heap-Bloecke mit Stapelmarke
+
+	Workspace(const Workspace&);
+	Workspace& operator=(const Workspace&);
+
+public:
+	Workspace();
+	explicit Workspace(const M_SIZE_TYPE& elements);
+	~Workspace();
+
+	void reserve(const M_SIZE_TYPE& elements);
+	M_VAL_TYPE* acquire(const M_SIZE_TYPE& elements);
+	void release(const M_SIZE_TYPE& mark);
+
+	M_SIZE_TYPE mark() const {
+		return top;
+	}
+
+	M_SIZE_TYPE reservedElements() const {
+		return capacity;
+	}
+
+	M_SIZE_TYPE peakElements() const {
+		return peak;
+	}
+
+	M_SIZE_TYPE overflows() const {
+		return overflowCount;
+	}
+};
+
+/**
+*  @brief  Belegt Zwischenmatrizen im Workspace des ausfuehrenden Threads und
+*  gibt sie beim Verlassen des Gueltigkeitsbereichs wieder frei. Matrizen
+*  ueber WORKSPACE_HEAP_ELEMENTS (die wenigen obersten Ebenen) kommen vom
+*  Heap, damit nicht jeder Thread die vollstaendige Reihe reservieren muss.
+*/
+class WorkspaceFrame {
+	Workspace& ws;
+	const M_SIZE_TYPE start;
+	M_VAL_TYPE* heapBlocks[WORKSPACE_FRAME_BLOCKS];		// Grosse Zwischenmatrizen auf dem Heap
+	M_SIZE_TYPE heapElements[WORKSPACE_FRAME_BLOCKS];
+	int heapCount;
+
+	WorkspaceFrame(const WorkspaceFrame&);
+	WorkspaceFrame& operator=(const WorkspaceFrame&);
+
+	M_VAL_TYPE* acquireMatrix(const M_SIZE_TYPE& elements);
+
+public:
+	WorkspaceFrame();
+	~WorkspaceFrame();
+
+	/**
+	*  @brief  Belegt eine (nicht initialisierte) Matrix der Dimension n.
+	*  @param     n  Matrixdimension (NxN).
+	*  @param  tile  Kachelgroesse im Morton-Layout (optional, 0: zeilenweise).
+	*  @return Sicht auf die belegte Matrix.
+	*/
+	MatrixView matrix(const M_SIZE_TYPE& n, const M_SIZE_TYPE& tile = 0) {
+		TRACE_ALLOC(n, (double) n * n * sizeof(M_VAL_TYPE));
+		return MatrixView(acquireMatrix(n * n), n, n, tile);
+	}
+
+	/**
+	*  @brief  Belegt eine (nicht initialisierte) rechteckige Matrix.
+	*  @param  rows  Anzahl der Zeilen.
+	*  @param  cols  Anzahl der Spalten (= Zeilenabstand).
+	*  @return Sicht auf die belegte Matrix (n = 0).
+	*/
+	MatrixView rect(const M_SIZE_TYPE& rows, const M_SIZE_TYPE& cols) {
+		TRACE_ALLOC(rows > cols ? rows : cols, (double) rows * cols * sizeof(M_VAL_TYPE));
+		return MatrixView(acquireMatrix(rows * cols), cols, 0);
+	}
+
+	/**
+	*  @brief  Belegt einen (nicht initialisierten) Puffer, z. B. fuer gepackte Operanden.
+	*  @param  elements  Anzahl der Elemente.
+	*  @return Zeiger auf den Puffer.
+	*/
+	M_VAL_TYPE* buffer(const M_SIZE_TYPE& elements) {
+		return ws.acquire(elements);
+	}
+};
+
+/**
+*  @brief  Belegt Zwischenmatrizen auf dem Heap statt im Workspace eines
+*  Threads, z. B. grosse Matrizen der oberen Ebenen, die nicht jeder Thread
+*  reservieren soll. Freigabe beim Verlassen des Gueltigkeitsbereichs;
+*  aktuelle Belegung und Spitze werden threaduebergreifend gezaehlt.
+*/
+class HeapFrame {
+	std::vector<std::pair<M_VAL_TYPE*, M_SIZE_TYPE> > blocks;
+
+	HeapFrame(const HeapFrame&);
+	HeapFrame& operator=(const HeapFrame&);
+
+public:
+	HeapFrame() { }
+	~HeapFrame();
+
+	MatrixView matrix(const M_SIZE_TYPE& n, const M_SIZE_TYPE& tile = 0);
+};
+
+/**
+*  @brief  Anteil einer Zwischenmatrix am Workspace eines Threads (Matrizen
+*  ueber WORKSPACE_HEAP_ELEMENTS belegt WorkspaceFrame auf dem Heap).
+*/
+inline M_SIZE_TYPE workspaceShare(const M_SIZE_TYPE& elements) {
+	return elements > WORKSPACE_HEAP_ELEMENTS ? 0 : elements;
+}
+
+M_SIZE_TYPE workspaceSeriesElements(const M_SIZE_TYPE& n, const M_SIZE_TYPE& cutOff, const M_SIZE_TYPE& perLevel);
+
+void initWorkspaces(const M_SIZE_TYPE& elements);
+
+Workspace& localWorkspace();
+
+size_t workspaceReservedBytes();
+
+size_t workspacePeakBytes();
+
+M_SIZE_TYPE workspaceOverflows();
+
+size_t heapPeakBytes();
+
+} // namespace M_VAL_NAMESPACE
+
+#endif